@@ -1,13 +1,22 @@
 #include "cli/cli_parser.h"
+#include "metrics/metrics_routes.h"
+#include "tracing/tracer.h"
+#include "tracing/tracing_routes.h"
 #include "telemetry/api/routes.h"
 #include "service/http_server/http_server.h"
 #include "telemetry/core/telemetry_storage.h"
+#include "telemetry/core/mean_length_cache.h"
+#include "telemetry/core/ingest_pipeline.h"
 #include "network/http/router/router_builder.h"
+#include "utils/concurrency/compute_pool.h"
 
 #include "logger.h"
 
 #include <asio.hpp>
 
+#include <algorithm>
+#include <thread>
+
 int main(int argc, char** argv)
 {
     using namespace ctask::cli_parser;
@@ -19,6 +28,7 @@ int main(int argc, char** argv)
     namespace TelemetryCore = ctask::telemetry::core;
 
     namespace Types = ctask::utils::types;
+    namespace Concurrency = ctask::utils::concurrency;
 
     auto log{Logger::instance().getLogger()};
     try
@@ -31,14 +41,52 @@ int main(int argc, char** argv)
             // 1 - is current, and 1 is logger
             threadCount -= 2;
             args.serverArgs.threads = threadCount;
-            log->set_level(spdlog::level::from_str(args.loggerArgs.level));
+            Logger::instance().configure(args.loggerArgs);
+            ctask::tracing::Tracer::instance().configure(args.tracingArgs.sampleEvery, args.tracingArgs.capacity);
         }
 
+        asio::io_service ctx;
+
+        std::shared_ptr<TelemetryCore::MeanLengthCache> meanLengthCache{};
+        if (args.cacheArgs.meanLengthCapacity > 0)
+        {
+            meanLengthCache = std::make_shared<TelemetryCore::MeanLengthCache>(args.cacheArgs.meanLengthCapacity);
+        }
+
+        // queries run here, io threads only parse, route and write
+        const auto computeThreads{
+            args.computeArgs.threads != 0 ? args.computeArgs.threads : std::max(std::thread::hardware_concurrency(), 1u)
+        };
+        auto computePool{std::make_shared<Concurrency::ComputePool>(computeThreads)};
+
         Router::RouterBuilder routBuilder;
-        TelemetryApi::TelemetryRoutes::registerRoutes(routBuilder,
-                                                      std::make_shared<TelemetryCore::TelemetryStorage>());
 
-        asio::io_service ctx;
+        // the service runs a single family, storage and pipeline are owned by the routes
+        TelemetryCore::withInteractionTimesFamily(args.telemetryArgs.interactionTimesLen, [&](auto family)
+        {
+            constexpr auto len{decltype(family)::value};
+            auto storage{std::make_shared<TelemetryCore::BasicTelemetryStorage<len>>()};
+
+            // storage writes leave the io threads for the writer threads
+            std::shared_ptr<TelemetryCore::BasicIngestPipeline<len>> ingestPipeline{};
+            if (args.ingestArgs.pipeline)
+            {
+                ingestPipeline = std::make_shared<TelemetryCore::BasicIngestPipeline<len>>(
+                    storage,
+                    TelemetryCore::ingestAckFromString(args.ingestArgs.ack),
+                    args.ingestArgs.writers,
+                    args.ingestArgs.queueCapacity);
+            }
+
+            TelemetryApi::TelemetryRoutes::registerRoutes<len>(routBuilder,
+                                                               std::move(storage),
+                                                               computePool,
+                                                               std::move(meanLengthCache),
+                                                               std::move(ingestPipeline));
+        });
+        ctask::metrics::MetricsRoutes::registerRoutes(routBuilder);
+        ctask::tracing::TracingRoutes::registerRoutes(routBuilder);
+
         auto server{
             Service::HttpServer::сreateService(ctx,
                                                std::move(args.serverArgs),
@@ -48,16 +96,39 @@ int main(int argc, char** argv)
         asio::signal_set signals(ctx, SIGINT);
         signals.async_wait([&](const asio::error_code& ec, int signal)
         {
-            log->info(std::format("Shutdown server, signal : {}", signal));
+            CTASK_LOG_INFO(log, "Shutdown server, signal : {}", signal);
             server->stop();
         });
 
+        // kill -USR1 <pid> dumps collected request traces, handler re-arms itself
+        asio::signal_set traceSignals(ctx, SIGUSR1);
+        std::function<void(const asio::error_code&, int)> dumpTrace;
+        dumpTrace = [&](const asio::error_code& ec, int)
+        {
+            if (ec)
+            {
+                return;
+            }
+
+            try
+            {
+                ctask::tracing::Tracer::instance().dumpChromeTrace(args.tracingArgs.dumpPath);
+                CTASK_LOG_INFO(log, "Trace dumped : {}", args.tracingArgs.dumpPath);
+            }
+            catch (const std::exception& e)
+            {
+                CTASK_LOG_ERROR(log, "Trace dump error : {}", e.what());
+            }
+            traceSignals.async_wait(dumpTrace);
+        };
+        traceSignals.async_wait(dumpTrace);
+
         server->start();
-        log->info("See Ya 👋");
+        CTASK_LOG_INFO(log, "See Ya 👋");
     }
     catch (const std::exception& e)
     {
-        log->error("Exception occured: {}", e.what());
+        CTASK_LOG_ERROR(log, "Exception occured: {}", e.what());
         return EXIT_FAILURE;
     }
     return EXIT_SUCCESS;
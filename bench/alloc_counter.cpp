@@ -0,0 +1,67 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench
+{
+    static std::atomic<uint64_t> allocations{0};
+    static std::atomic<uint64_t> bytes{0};
+
+    uint64_t allocationCount() noexcept
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    uint64_t allocatedBytes() noexcept
+    {
+        return bytes.load(std::memory_order_relaxed);
+    }
+}
+
+// array and nothrow forms are implemented by the standard library on top of these
+void* operator new(std::size_t size)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    bench::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto* memory{std::malloc(size == 0 ? 1 : size)})
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    bench::bytes.fetch_add(size, std::memory_order_relaxed);
+    const auto align{static_cast<std::size_t>(alignment)};
+    // aligned_alloc wants the size to be a multiple of the alignment
+    const auto rounded{(size + align - 1) / align * align};
+    if (auto* memory{std::aligned_alloc(align, rounded == 0 ? align : rounded)})
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
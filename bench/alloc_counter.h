@@ -0,0 +1,25 @@
+#ifndef BENCH_ALLOC_COUNTER_H
+#define BENCH_ALLOC_COUNTER_H
+
+#include <cstdint>
+
+namespace bench
+{
+    /**
+     * @brief Amount of global operator new calls since the start of the process.
+     *
+     * The bench executable replaces global operator new, so every heap allocation
+     * (containers, strings, std::function, coroutine frames) passes through the counter.
+     * Counts allocations of all threads together.
+     */
+    uint64_t allocationCount() noexcept;
+
+    /**
+     * @brief Total amount of bytes requested from global operator new since the start of the process.
+     *
+     * Requested, not used: malloc's own per-block overhead is not included.
+     */
+    uint64_t allocatedBytes() noexcept;
+}
+
+#endif //BENCH_ALLOC_COUNTER_H
@@ -0,0 +1,48 @@
+#ifndef BENCH_HELPER_H
+#define BENCH_HELPER_H
+
+#include "telemetry/core/models.h"
+
+#include <format>
+#include <string>
+
+namespace bench
+{
+    /**
+     * @brief Builds raw HTTP request, the same way clients send it.
+     *
+     * @param connection Value of the Connection header, empty one leaves the header out
+     * the way most HTTP/1.1 clients do.
+     */
+    inline std::string makeRawRequest(std::string_view method, std::string_view path, std::string_view body,
+                                      std::string_view connection = "Keep-Alive")
+    {
+        return std::format(
+            "{} {} HTTP/1.1\r\n"
+            "Host: localhost:8080\r\n"
+            "Content-Type: application/json\r\n"
+            "{}{}{}"
+            "Content-Length: {}\r\n"
+            "\r\n"
+            "{}",
+            method, path,
+            connection.empty() ? "" : "Connection: ", connection, connection.empty() ? "" : "\r\n",
+            body.size(), body
+        );
+    }
+
+    /**
+     * @brief Builds event with interaction times derived from the date, so every event is a bit different.
+     */
+    inline ctask::telemetry::core::InteractionTimesEventModel makeEvent(ctask::telemetry::core::EventDateType date)
+    {
+        ctask::telemetry::core::InteractionTimesEventModel event{date};
+        for (size_t i{0}; i < event.values.size(); ++i)
+        {
+            event.values[i] = static_cast<ctask::telemetry::core::InteractionTimeType>((date + i) % 100);
+        }
+        return event;
+    }
+}
+
+#endif //BENCH_HELPER_H
@@ -0,0 +1,88 @@
+#include "bench_helper.h"
+#include "round_trip_server.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+using namespace asio;
+using namespace asio::ip;
+
+// the way most HTTP/1.1 clients send it : no Connection header, persistence is expected by default
+static const std::string& standardRequest()
+{
+    static const std::string request{
+        bench::makeRawRequest("GET", "/paths/signup/meanLength",
+                              R"({"resultUnit":"seconds","startTimestamp":1711000000,"endTimestamp":1712000000})", "")
+    };
+    return request;
+}
+
+// reads a single response, a content length response fits the buffer in full
+static bool readResponse(tcp::socket& socket, std::array<char, 1024>& response)
+{
+    error_code ec;
+    socket.read_some(buffer(response), ec);
+    return !ec;
+}
+
+// before : the connection was closed after every request without "Connection: Keep-Alive",
+// so a standard client paid a TCP handshake and teardown per request
+static void BM_StandardClient_ConnectionPerRequest(benchmark::State& state)
+{
+    bench::RoundTripServer::instance();
+    const auto& raw{standardRequest()};
+
+    io_context clientCtx{};
+    std::array<char, 1024> response{};
+    for (auto _ : state)
+    {
+        tcp::socket socket{clientCtx};
+        if (!bench::connectRoundTrip(socket))
+        {
+            state.SkipWithError("Can't connect to the server");
+            return;
+        }
+
+        // what the server did to such requests before : answer and close
+        write(socket, buffer(raw));
+        if (!readResponse(socket, response))
+        {
+            state.SkipWithError("Can't read the response");
+            return;
+        }
+        socket.shutdown(tcp::socket::shutdown_both);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_StandardClient_ConnectionPerRequest)->UseRealTime();
+
+// after : the same request keeps the connection open, HTTP/1.1 default
+static void BM_StandardClient_PersistentConnection(benchmark::State& state)
+{
+    bench::RoundTripServer::instance();
+    const auto& raw{standardRequest()};
+
+    io_context clientCtx{};
+    tcp::socket socket{clientCtx};
+    if (!bench::connectRoundTrip(socket))
+    {
+        state.SkipWithError("Can't connect to the server");
+        return;
+    }
+
+    std::array<char, 1024> response{};
+    for (auto _ : state)
+    {
+        write(socket, buffer(raw));
+        if (!readResponse(socket, response))
+        {
+            state.SkipWithError("Connection is closed by the server");
+            return;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_StandardClient_PersistentConnection)->UseRealTime();
@@ -0,0 +1,57 @@
+#include "network/http/parser/json/http_parser.h"
+#include "bench_helper.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace ctask::network::http::parser;
+
+static void BM_ParseRequest_Get(benchmark::State& state)
+{
+    const auto raw{
+        bench::makeRawRequest("GET", "/paths/signup/meanLength",
+                              R"({"resultUnit":"seconds","startTimestamp":1711000000,"endTimestamp":1712000000})")
+    };
+
+    JsonHttpParser parser;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser.parseRequest(raw));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * raw.size()));
+}
+
+BENCHMARK(BM_ParseRequest_Get);
+
+static void BM_ParseRequest_Post(benchmark::State& state)
+{
+    const auto raw{
+        bench::makeRawRequest("POST", "/paths/signup",
+                              R"({"values":[12,8,15,10,9,14,7,11,13,10],"date":1711040000})")
+    };
+
+    JsonHttpParser parser;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser.parseRequest(raw));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * raw.size()));
+}
+
+BENCHMARK(BM_ParseRequest_Post);
+
+// a parser per request, like the server session does
+static void BM_ParseRequest_NewParserEachTime(benchmark::State& state)
+{
+    const auto raw{
+        bench::makeRawRequest("POST", "/paths/signup",
+                              R"({"values":[12,8,15,10,9,14,7,11,13,10],"date":1711040000})")
+    };
+
+    for (auto _ : state)
+    {
+        JsonHttpParser parser;
+        benchmark::DoNotOptimize(parser.parseRequest(raw));
+    }
+}
+
+BENCHMARK(BM_ParseRequest_NewParserEachTime);
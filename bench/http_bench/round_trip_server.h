@@ -0,0 +1,78 @@
+#ifndef ROUND_TRIP_SERVER_H
+#define ROUND_TRIP_SERVER_H
+
+#include "network/http/router/custom/router.h"
+#include "service/http_server/http_server.h"
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace bench
+{
+    // nobody is expected to listen there while benchmarks run
+    constexpr uint16_t ROUND_TRIP_PORT{18089};
+
+    /**
+     * @brief Router with a couple of cheap handlers, so benchmarks measure the server and not the storage.
+     */
+    inline std::unique_ptr<ctask::network::http::router::HttpRouter> makeRoundTripRouter()
+    {
+        using namespace ctask::utils::types;
+
+        auto router{std::make_unique<ctask::network::http::router::HttpRouter>()};
+        auto handler = [](const HttpRequest&) { return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, R"({"mean":42})"}; };
+        router->addGet("/paths/{event}/meanLength", handler);
+        router->addPost("/paths/{event}", handler);
+        return router;
+    }
+
+    /**
+     * @struct RoundTripServer
+     * @brief Real server on the loopback, started once, the one-instance policy allows nothing else.
+     */
+    struct RoundTripServer
+    {
+        asio::io_context ctx{};
+        std::shared_ptr<ctask::service::HttpServer> server{
+            ctask::service::HttpServer::сreateService(ctx, {"127.0.0.1", ROUND_TRIP_PORT, 1, 60},
+                                                      makeRoundTripRouter())
+        };
+        std::jthread runner{[this]() { server->start(); }};
+
+        ~RoundTripServer()
+        {
+            server->stop();
+        }
+
+        static RoundTripServer& instance()
+        {
+            static RoundTripServer roundTripServer{};
+            return roundTripServer;
+        }
+    };
+
+    /**
+     * @brief Connects to the round trip server, the first attempts might come before it listens.
+     */
+    inline bool connectRoundTrip(asio::ip::tcp::socket& socket)
+    {
+        asio::error_code ec;
+        for (int attempt{0}; attempt < 100; ++attempt)
+        {
+            socket.connect({asio::ip::make_address("127.0.0.1"), ROUND_TRIP_PORT}, ec);
+            if (!ec)
+            {
+                socket.set_option(asio::ip::tcp::no_delay{true});
+                return true;
+            }
+            socket.close();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+}
+
+#endif //ROUND_TRIP_SERVER_H
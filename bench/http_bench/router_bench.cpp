@@ -0,0 +1,41 @@
+#include "network/http/router/custom/router.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+using namespace ctask::network::http::router;
+using namespace ctask::utils::types;
+
+// route table shaped like the real one
+static std::unique_ptr<HttpRouter> makeRouter()
+{
+    auto router{std::make_unique<HttpRouter>()};
+    auto handler = [](const HttpRequest&) { return HttpResponse{HttpStatusCode::HTTP_STATUS_OK}; };
+
+    router->addGet("/metrics", handler);
+    router->addGet("/debug/trace", handler);
+    router->addGet("/paths/meanLength/batch", handler);
+    router->addGet("/paths/{event}/meanLength", handler);
+    router->addGet("/paths/{event}/percentiles", handler);
+    router->addGet("/paths/{event}/series", handler);
+    router->addGet("/paths/{event}/export", handler);
+    router->addPost("/paths/{event}", handler);
+    return router;
+}
+
+static void BM_Route(benchmark::State& state, HttpMethod method, const char* path)
+{
+    auto router{makeRouter()};
+    HttpRequest request{method, path};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(router->route(request));
+    }
+}
+
+BENCHMARK_CAPTURE(BM_Route, Exact, HttpMethod::GET_METHOD, "/metrics");
+BENCHMARK_CAPTURE(BM_Route, ParameterizedFirst, HttpMethod::GET_METHOD, "/paths/signup/meanLength");
+BENCHMARK_CAPTURE(BM_Route, ParameterizedLast, HttpMethod::GET_METHOD, "/paths/signup/export");
+BENCHMARK_CAPTURE(BM_Route, ParameterizedPost, HttpMethod::POST_METHOD, "/paths/signup");
+BENCHMARK_CAPTURE(BM_Route, NotFound, HttpMethod::GET_METHOD, "/paths/signup/unknown");
@@ -0,0 +1,37 @@
+#include "network/http/response_serializer/json/response_serializer.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace ctask::network::http::response_serializer;
+using namespace ctask::utils::types;
+
+static void BM_Serialize(benchmark::State& state)
+{
+    // body of the given size, from a tiny {"mean":..} up to a big batch response
+    HttpResponseMeta meta{
+        {HttpStatusCode::HTTP_STATUS_OK, std::string(static_cast<size_t>(state.range(0)), 'x')},
+        "1.1"
+    };
+
+    JsonHttpResponseSerializer serializer;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(serializer.serialize(meta));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+
+BENCHMARK(BM_Serialize)->RangeMultiplier(16)->Range(16, 64 << 10);
+
+static void BM_SerializeChunk(benchmark::State& state)
+{
+    const std::string chunk(static_cast<size_t>(state.range(0)), 'x');
+    JsonHttpResponseSerializer serializer;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(serializer.serializeChunk(chunk));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+
+BENCHMARK(BM_SerializeChunk)->Range(1 << 10, 1 << 20);
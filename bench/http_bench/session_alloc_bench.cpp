@@ -0,0 +1,119 @@
+#include "network/http/parser/json/http_parser.h"
+#include "network/http/response_serializer/json/response_serializer.h"
+#include "network/http/router/custom/router.h"
+#include "utils/memory/connection_arena.h"
+#include "alloc_counter.h"
+#include "bench_helper.h"
+#include "round_trip_server.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+
+using namespace asio;
+using namespace asio::ip;
+using namespace ctask::network::http::parser;
+using namespace ctask::network::http::response_serializer;
+using namespace ctask::network::http::router;
+using namespace ctask::utils::memory;
+using namespace ctask::utils::types;
+
+// the same as the server uses
+constexpr size_t ARENA_LEN{8 * 1024};
+
+static const std::string& rawRequest(bool post)
+{
+    static const std::string get{
+        bench::makeRawRequest("GET", "/paths/signup/meanLength",
+                              R"({"resultUnit":"seconds","startTimestamp":1711000000,"endTimestamp":1712000000})")
+    };
+    static const std::string postRequest{
+        bench::makeRawRequest("POST", "/paths/signup", R"({"values":[12,8,15,10,9,14,7,11,13,10],"date":1711040000})")
+    };
+    return post ? postRequest : get;
+}
+
+static void reportAllocations(benchmark::State& state, uint64_t before)
+{
+    state.counters["mallocs_per_request"] = benchmark::Counter(
+        static_cast<double>(bench::allocationCount() - before), benchmark::Counter::kAvgIterations);
+}
+
+// how a session iteration used to look like : fresh parser and serializer, response in a std::string
+static void BM_RequestCycle_FreshObjects(benchmark::State& state, bool post)
+{
+    const auto& raw{rawRequest(post)};
+    auto router{bench::makeRoundTripRouter()};
+
+    const auto before{bench::allocationCount()};
+    for (auto _ : state)
+    {
+        JsonHttpParser parser;
+        JsonHttpResponseSerializer serializer;
+        auto request{parser.parseRequest(raw)};
+        HttpResponseMeta meta{router->route(request), std::string{request.version}};
+        benchmark::DoNotOptimize(serializer.serialize(meta));
+    }
+    reportAllocations(state, before);
+}
+
+BENCHMARK_CAPTURE(BM_RequestCycle_FreshObjects, Get, false);
+BENCHMARK_CAPTURE(BM_RequestCycle_FreshObjects, Post, true);
+
+// how it looks now : parser and serializer per connection, request and response in the connection arena
+static void BM_RequestCycle_SessionArena(benchmark::State& state, bool post)
+{
+    const auto& raw{rawRequest(post)};
+    auto router{bench::makeRoundTripRouter()};
+    JsonHttpParser parser;
+    JsonHttpResponseSerializer serializer;
+    ConnectionArena<ARENA_LEN> arena{};
+
+    const auto before{bench::allocationCount()};
+    for (auto _ : state)
+    {
+        arena.reset();
+        auto request{parser.parseRequest(raw, arena.resource())};
+        HttpResponseMeta meta{router->route(request), std::string{request.version}};
+        std::pmr::string serialized{arena.resource()};
+        serializer.serialize(meta, serialized);
+        benchmark::DoNotOptimize(serialized.data());
+    }
+    reportAllocations(state, before);
+}
+
+BENCHMARK_CAPTURE(BM_RequestCycle_SessionArena, Get, false);
+BENCHMARK_CAPTURE(BM_RequestCycle_SessionArena, Post, true);
+
+// whole keep-alive request cycle through the server : socket read, parse, route, serialize, write;
+// the client side reuses its buffers, so every counted allocation belongs to the server
+static void BM_ServerRoundTrip(benchmark::State& state, bool post)
+{
+    bench::RoundTripServer::instance();
+    const auto& raw{rawRequest(post)};
+
+    io_context clientCtx{};
+    tcp::socket socket{clientCtx};
+    if (!bench::connectRoundTrip(socket))
+    {
+        state.SkipWithError("Can't connect to the server");
+        return;
+    }
+
+    // the response is always the same, the first one tells its size
+    std::array<char, 1024> response{};
+    write(socket, buffer(raw));
+    const auto responseSize{socket.read_some(buffer(response))};
+
+    const auto before{bench::allocationCount()};
+    for (auto _ : state)
+    {
+        write(socket, buffer(raw));
+        read(socket, buffer(response.data(), responseSize));
+    }
+    reportAllocations(state, before);
+}
+
+BENCHMARK_CAPTURE(BM_ServerRoundTrip, Get, false)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerRoundTrip, Post, true)->UseRealTime();
@@ -0,0 +1,109 @@
+#include "logger.h"
+
+#include <benchmark/benchmark.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <chrono>
+#include <format>
+#include <string>
+#include <thread>
+
+// what a route handler logs on every request : the path and the whole body
+static const std::string& requestPath()
+{
+    static const std::string path{"/paths/signup/meanLength"};
+    return path;
+}
+
+static const std::string& requestBody()
+{
+    static const std::string body{
+        R"({"resultUnit":"seconds","startTimestamp":1711000000,"endTimestamp":1712000000,"padding":")" +
+        std::string(512, 'x') + R"("})"
+    };
+    return body;
+}
+
+// synchronous logger writing nowhere, so only the cost of the call itself is measured;
+// range(0) is the runtime level, info disables debug calls, debug enables them
+static std::shared_ptr<spdlog::logger> makeNullLogger(benchmark::State& state)
+{
+    auto logger{std::make_shared<spdlog::logger>("bench_logger", std::make_shared<spdlog::sinks::null_sink_st>())};
+    logger->set_level(static_cast<spdlog::level::level_enum>(state.range(0)));
+    return logger;
+}
+
+// how routes used to log : the message is formatted before the level is even checked
+static void BM_DebugLog_EagerFormat(benchmark::State& state)
+{
+    auto log{makeNullLogger(state)};
+    for (auto _ : state)
+    {
+        log->debug(std::format("Handle path : {}, body : {}", requestPath(), requestBody()));
+    }
+}
+
+BENCHMARK(BM_DebugLog_EagerFormat)->Arg(SPDLOG_LEVEL_INFO)->Arg(SPDLOG_LEVEL_DEBUG);
+
+static void BM_DebugLog_Macro(benchmark::State& state)
+{
+    auto log{makeNullLogger(state)};
+    for (auto _ : state)
+    {
+        CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", requestPath(), requestBody());
+    }
+}
+
+BENCHMARK(BM_DebugLog_Macro)->Arg(SPDLOG_LEVEL_INFO)->Arg(SPDLOG_LEVEL_DEBUG);
+
+// console which can't keep up : every line takes 20us to write
+class SlowSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+{
+protected:
+    void sink_it_(const spdlog::details::log_msg&) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+
+    void flush_() override
+    {
+    }
+};
+
+constexpr size_t SLOW_SINK_QUEUE{1024};
+
+// before : spdlog async logger with the blocking policy, a full queue makes the caller wait for the console
+static void BM_InfoLog_SlowSink_AsyncBlock(benchmark::State& state)
+{
+    auto pool{std::make_shared<spdlog::details::thread_pool>(SLOW_SINK_QUEUE, 1)};
+    auto log{
+        std::make_shared<spdlog::async_logger>("bench_async", std::make_shared<SlowSink>(), pool,
+                                               spdlog::async_overflow_policy::block)
+    };
+    for (auto _ : state)
+    {
+        CTASK_LOG_INFO(log, "Handle path : {}", requestPath());
+    }
+}
+
+BENCHMARK(BM_InfoLog_SlowSink_AsyncBlock);
+
+// after : per-thread ring overrunning the oldest records, the caller never waits
+static void BM_InfoLog_SlowSink_RingOverrun(benchmark::State& state)
+{
+    auto ringSink{
+        std::make_shared<ctask::logging::RingBufferSink>(SLOW_SINK_QUEUE,
+                                                         ctask::logging::LogOverflowPolicy::OVERRUN_OLDEST)
+    };
+    ringSink->addSink(std::make_shared<SlowSink>());
+    auto log{std::make_shared<spdlog::logger>("bench_ring", ringSink)};
+    for (auto _ : state)
+    {
+        CTASK_LOG_INFO(log, "Handle path : {}", requestPath());
+    }
+    state.counters["overrun"] = static_cast<double>(ringSink->stats().overrun);
+}
+
+BENCHMARK(BM_InfoLog_SlowSink_RingOverrun);
@@ -0,0 +1,92 @@
+#include "utils/concurrency/compute_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace ctask::utils::concurrency;
+
+// stands for a large range scan, 2ms of pure CPU
+static double heavyQuery()
+{
+    double acc{0};
+    const auto until{std::chrono::steady_clock::now() + std::chrono::milliseconds(2)};
+    while (std::chrono::steady_clock::now() < until)
+    {
+        for (int i{0}; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(acc += i * 0.5);
+        }
+    }
+    return acc;
+}
+
+// a heavy query and a cheap request land on the same io thread,
+// the time until the cheap request runs is measured, p99 and max are reported next to the mean
+template <typename PostQuery>
+static void cheapRequestLatency(benchmark::State& state, PostQuery postQuery)
+{
+    ComputePool pool{1};
+    asio::io_context ctx{};
+    auto guard{asio::make_work_guard(ctx)};
+    std::jthread ioThread{[&ctx]() { ctx.run(); }};
+
+    std::vector<double> latencies{};
+    for (auto _ : state)
+    {
+        std::promise<void> answered{};
+        postQuery(ctx, pool, answered);
+
+        std::promise<void> served{};
+        const auto start{std::chrono::steady_clock::now()};
+        asio::post(ctx, [&served]() { served.set_value(); });
+        served.get_future().wait();
+        const auto latency{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        state.SetIterationTime(latency);
+        latencies.push_back(latency);
+
+        // queries don't pile up on the pool, the next round starts from scratch
+        answered.get_future().wait();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p99_us"] = latencies[latencies.size() * 99 / 100] * 1e6;
+    state.counters["max_us"] = latencies.back() * 1e6;
+
+    guard.reset();
+    ctx.stop();
+}
+
+// before : the handler computes on the io thread
+static void BM_CheapRequest_BehindInlineQuery(benchmark::State& state)
+{
+    cheapRequestLatency(state, [](asio::io_context& ctx, ComputePool&, std::promise<void>& answered)
+    {
+        asio::post(ctx, [&answered]()
+        {
+            benchmark::DoNotOptimize(heavyQuery());
+            answered.set_value();
+        });
+    });
+}
+
+BENCHMARK(BM_CheapRequest_BehindInlineQuery)->UseManualTime();
+
+// after : the handler awaits the compute pool, the io thread goes on
+static void BM_CheapRequest_BehindOffloadedQuery(benchmark::State& state)
+{
+    cheapRequestLatency(state, [](asio::io_context& ctx, ComputePool& pool, std::promise<void>& answered)
+    {
+        asio::co_spawn(ctx, [&pool, &answered]() -> asio::awaitable<void>
+        {
+            benchmark::DoNotOptimize(co_await pool.run(heavyQuery));
+            answered.set_value();
+        }, asio::detached);
+    });
+}
+
+BENCHMARK(BM_CheapRequest_BehindOffloadedQuery)->UseManualTime();
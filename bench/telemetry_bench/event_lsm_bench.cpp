@@ -0,0 +1,202 @@
+#include "telemetry/core/event_lsm_tree.h"
+#include "telemetry/core/misc.h"
+#include "bench_helper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ctask::telemetry::core;
+
+// range(0) events, every date within range(1) positions of its place, the way clients with skewed clocks
+// and retries deliver them
+static std::vector<InteractionTimesEventModel> makeOutOfOrderEvents(size_t events, size_t skew)
+{
+    std::vector<EventDateType> dates(events);
+    std::iota(dates.begin(), dates.end(), EventDateType{0});
+    std::mt19937_64 random{42};
+    for (size_t window{0}; window < events; window += std::max<size_t>(skew, 1))
+    {
+        auto end{dates.begin() + static_cast<ptrdiff_t>(std::min(window + skew, events))};
+        std::shuffle(dates.begin() + static_cast<ptrdiff_t>(window), end, random);
+    }
+
+    std::vector<InteractionTimesEventModel> result{};
+    result.reserve(events);
+    for (const auto date : dates)
+    {
+        result.push_back(bench::makeEvent(date));
+    }
+    return result;
+}
+
+// the map storage kept events in before
+static void BM_OutOfOrderInsert_PoolMap(benchmark::State& state)
+{
+    const auto events{makeOutOfOrderEvents(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)))};
+    for (auto _ : state)
+    {
+        std::pmr::unsynchronized_pool_resource pool{};
+        std::pmr::map<EventDateType, InteractionTimesCollection> data{&pool};
+        for (const auto& event : events)
+        {
+            data.emplace(event.date, event.values);
+        }
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+BENCHMARK(BM_OutOfOrderInsert_PoolMap)->ArgsProduct({{1 << 16, 1 << 20}, {1, 64, 4096}});
+
+// merges included, the way the background merger does them
+static void BM_OutOfOrderInsert_LsmTree(benchmark::State& state)
+{
+    const auto events{makeOutOfOrderEvents(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)))};
+    for (auto _ : state)
+    {
+        EventLsmTree data{};
+        for (const auto& event : events)
+        {
+            data.insert(event);
+        }
+        data.sealBuffer();
+        while (auto compaction{data.planCompaction()})
+        {
+            data.installCompaction(*compaction, EventLsmTree::merge(compaction->inputs));
+        }
+        benchmark::DoNotOptimize(data.runs());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+BENCHMARK(BM_OutOfOrderInsert_LsmTree)->ArgsProduct({{1 << 16, 1 << 20}, {1, 64, 4096}});
+
+// ordered walk over 1M events, node chasing vs contiguous runs
+static void BM_OrderedScan_PoolMap(benchmark::State& state)
+{
+    const auto events{makeOutOfOrderEvents(1 << 20, 64)};
+    std::pmr::unsynchronized_pool_resource pool{};
+    std::pmr::map<EventDateType, InteractionTimesCollection> data{&pool};
+    for (const auto& event : events)
+    {
+        data.emplace(event.date, event.values);
+    }
+
+    for (auto _ : state)
+    {
+        int64_t total{0};
+        for (const auto& [date, values] : data)
+        {
+            total += calculatePathLength(values);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+BENCHMARK(BM_OrderedScan_PoolMap);
+
+static void BM_OrderedScan_LsmTree(benchmark::State& state)
+{
+    const auto events{makeOutOfOrderEvents(1 << 20, 64)};
+    EventLsmTree data{};
+    for (const auto& event : events)
+    {
+        data.insert(event);
+    }
+    if (state.range(0) != 0)
+    {
+        // what the background merger leaves behind
+        data.sealBuffer();
+        while (auto compaction{data.planCompaction()})
+        {
+            data.installCompaction(*compaction, EventLsmTree::merge(compaction->inputs));
+        }
+    }
+
+    for (auto _ : state)
+    {
+        int64_t total{0};
+        data.forEachOrdered(0, events.size(), [&total](const InteractionTimesEventModel& event)
+        {
+            total += calculatePathLength(event.values);
+            return true;
+        });
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+// /0 right after the inserts: a run per sealed buffer, /1 merged
+BENCHMARK(BM_OrderedScan_LsmTree)->Arg(0)->Arg(1);
+
+// 1M events, range(0) of them share every second, stored and then walked in order once,
+// a std::multimap is what keeping all of them took without the LSM tree
+static std::vector<InteractionTimesEventModel> makeSharedTimestampEvents(size_t perSecond)
+{
+    auto events{makeOutOfOrderEvents(1 << 20, 64)};
+    for (auto& event : events)
+    {
+        event.date /= perSecond;
+    }
+    return events;
+}
+
+static void BM_SharedTimestamps_PoolMultimap(benchmark::State& state)
+{
+    const auto events{makeSharedTimestampEvents(static_cast<size_t>(state.range(0)))};
+    for (auto _ : state)
+    {
+        std::pmr::unsynchronized_pool_resource pool{};
+        std::pmr::multimap<EventDateType, InteractionTimesCollection> data{&pool};
+        for (const auto& event : events)
+        {
+            data.emplace(event.date, event.values);
+        }
+
+        int64_t total{0};
+        for (const auto& [date, values] : data)
+        {
+            total += calculatePathLength(values);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+BENCHMARK(BM_SharedTimestamps_PoolMultimap)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_SharedTimestamps_LsmTree(benchmark::State& state)
+{
+    const auto events{makeSharedTimestampEvents(static_cast<size_t>(state.range(0)))};
+    for (auto _ : state)
+    {
+        EventLsmTree data{};
+        for (const auto& event : events)
+        {
+            data.insert(event);
+        }
+        data.sealBuffer();
+        while (auto compaction{data.planCompaction()})
+        {
+            data.installCompaction(*compaction, EventLsmTree::merge(compaction->inputs));
+        }
+
+        int64_t total{0};
+        data.forEachOrdered(0, events.size(), [&total](const InteractionTimesEventModel& event)
+        {
+            total += calculatePathLength(event.values);
+            return true;
+        });
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+
+BENCHMARK(BM_SharedTimestamps_LsmTree)->Arg(1)->Arg(16)->Arg(256);
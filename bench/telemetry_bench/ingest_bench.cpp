@@ -0,0 +1,75 @@
+#include "telemetry/core/ingest_pipeline.h"
+#include "telemetry/core/telemetry_storage.h"
+#include "bench_helper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+using namespace ctask::telemetry::core;
+
+// storage and pipeline shared by all threads of a single benchmark run
+static std::shared_ptr<TelemetryStorage> ingestStorage;
+static std::unique_ptr<IngestPipeline> ingestPipeline;
+
+static void createIngestStorage(const benchmark::State&)
+{
+    ingestStorage = std::make_shared<TelemetryStorage>();
+}
+
+static void createIngestPipeline(const benchmark::State&)
+{
+    ingestStorage = std::make_shared<TelemetryStorage>();
+    ingestPipeline = std::make_unique<IngestPipeline>(ingestStorage);
+}
+
+static void destroyIngest(const benchmark::State&)
+{
+    ingestPipeline.reset();
+    ingestStorage.reset();
+}
+
+// before : every POST takes the entry lock on its io thread, time per iteration is the handler's share
+static void BM_Ingest_StoreInPlace(benchmark::State& state)
+{
+    const auto threads{static_cast<EventDateType>(state.threads())};
+    EventDateType date{static_cast<EventDateType>(state.thread_index())};
+    for (auto _ : state)
+    {
+        ingestStorage->storeEvent("signup", bench::makeEvent(date));
+        date += threads;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Ingest_StoreInPlace)
+    ->Setup(createIngestStorage)->Teardown(destroyIngest)
+    ->ThreadRange(1, 8)->UseRealTime();
+
+// after : POST queues the event and acks (ack "enqueued"), a full ring stores in place the way the handler does;
+// applied_per_second counts the events until the writer has stored them all
+static void BM_Ingest_Pipeline(benchmark::State& state)
+{
+    const auto threads{static_cast<EventDateType>(state.threads())};
+    EventDateType date{static_cast<EventDateType>(state.thread_index())};
+    const auto start{std::chrono::steady_clock::now()};
+    for (auto _ : state)
+    {
+        const auto event{bench::makeEvent(date)};
+        if (!ingestPipeline->tryEnqueue("signup", event))
+        {
+            ingestStorage->storeEvent("signup", event);
+        }
+        date += threads;
+    }
+    ingestPipeline->flush();
+    const auto elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["applied_per_second"] = static_cast<double>(state.iterations()) / elapsed;
+}
+
+BENCHMARK(BM_Ingest_Pipeline)
+    ->Setup(createIngestPipeline)->Teardown(destroyIngest)
+    ->ThreadRange(1, 8)->UseRealTime();
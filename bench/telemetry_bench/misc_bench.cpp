@@ -0,0 +1,63 @@
+#include "telemetry/core/misc.h"
+#include "bench_helper.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace ctask::telemetry::core;
+
+static void BM_CalculateMeanPathLength(benchmark::State& state)
+{
+    std::vector<InteractionTimesCollection> interactions;
+    interactions.reserve(static_cast<size_t>(state.range(0)));
+    for (int64_t i{0}; i < state.range(0); ++i)
+    {
+        interactions.emplace_back(bench::makeEvent(static_cast<EventDateType>(i)).values);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(calculateMeanPathLength(interactions, TimeUnit::Milliseconds));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_CalculateMeanPathLength)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+template <size_t N, bool Unrolled>
+static void BM_PathLength(benchmark::State& state)
+{
+    std::vector<InteractionTimes<N>> interactions(static_cast<size_t>(state.range(0)));
+    for (size_t i{0}; i < interactions.size(); ++i)
+    {
+        for (size_t step{0}; step < N; ++step)
+        {
+            interactions[i][step] = static_cast<InteractionTimeType>((i + step) % 1000);
+        }
+    }
+
+    for (auto _ : state)
+    {
+        int64_t total{0};
+        for (const auto& interaction : interactions)
+        {
+            if constexpr (Unrolled)
+            {
+                total += calculatePathLength(interaction);
+            }
+            else
+            {
+                total += calculatePathLength(std::span<const InteractionTimeType>{interaction});
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// the kernel of a family against the loop over a span of any length, per family length
+BENCHMARK(BM_PathLength<5, true>)->Arg(1 << 16);
+BENCHMARK(BM_PathLength<5, false>)->Arg(1 << 16);
+BENCHMARK(BM_PathLength<10, true>)->Arg(1 << 16);
+BENCHMARK(BM_PathLength<10, false>)->Arg(1 << 16);
+BENCHMARK(BM_PathLength<32, true>)->Arg(1 << 16);
+BENCHMARK(BM_PathLength<32, false>)->Arg(1 << 16);
@@ -0,0 +1,166 @@
+#include "telemetry/core/telemetry_storage.h"
+#include "utils/concurrency/compute_pool.h"
+#include "bench_helper.h"
+
+#include <benchmark/benchmark.h>
+
+#include <format>
+#include <limits>
+#include <memory>
+
+using namespace ctask::telemetry::core;
+
+// storage shared by all threads of a single benchmark run
+static std::unique_ptr<TelemetryStorage> sharedStorage;
+
+// events pre-populated for read benchmarks
+constexpr EventDateType POPULATED_EVENTS{1'000'000};
+
+static void createStorage(const benchmark::State&)
+{
+    sharedStorage = std::make_unique<TelemetryStorage>();
+}
+
+static void createPopulatedStorage(const benchmark::State&)
+{
+    sharedStorage = std::make_unique<TelemetryStorage>();
+    for (EventDateType date{0}; date < POPULATED_EVENTS; ++date)
+    {
+        sharedStorage->storeEvent("signup", bench::makeEvent(date));
+    }
+}
+
+static void destroyStorage(const benchmark::State&)
+{
+    sharedStorage.reset();
+}
+
+// every thread writes its own timestamps of the same event, the worst case for the entry lock
+static void BM_StoreEvent_SameEvent(benchmark::State& state)
+{
+    const auto threads{static_cast<EventDateType>(state.threads())};
+    EventDateType date{static_cast<EventDateType>(state.thread_index())};
+    for (auto _ : state)
+    {
+        sharedStorage->storeEvent("signup", bench::makeEvent(date));
+        date += threads;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StoreEvent_SameEvent)
+    ->Setup(createStorage)->Teardown(destroyStorage)
+    ->ThreadRange(1, 8)->UseRealTime();
+
+// every thread writes its own event, only the events map lock is shared
+static void BM_StoreEvent_DistinctEvents(benchmark::State& state)
+{
+    const auto eventName{std::format("event_{}", state.thread_index())};
+    EventDateType date{0};
+    for (auto _ : state)
+    {
+        sharedStorage->storeEvent(eventName, bench::makeEvent(date++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StoreEvent_DistinctEvents)
+    ->Setup(createStorage)->Teardown(destroyStorage)
+    ->ThreadRange(1, 8)->UseRealTime();
+
+// range of range(0) events out of the populated ones, different for every iteration
+static void BM_GetEventInteractions(benchmark::State& state)
+{
+    const auto rangeLen{static_cast<EventDateType>(state.range(0))};
+    EventDateType from{static_cast<EventDateType>(state.thread_index()) * 7919 % POPULATED_EVENTS};
+    for (auto _ : state)
+    {
+        from = (from + 104729) % (POPULATED_EVENTS - rangeLen);
+        benchmark::DoNotOptimize(sharedStorage->getEventInteractions("signup", from, from + rangeLen - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_GetEventInteractions)
+    ->Setup(createPopulatedStorage)->Teardown(destroyStorage)
+    ->RangeMultiplier(32)->Range(32, 32 << 10)
+    ->ThreadRange(1, 8)->UseRealTime();
+
+// readers and a writer at the same time, thread 0 writes fresh events, the rest read
+static void BM_GetEventInteractions_WithWriter(benchmark::State& state)
+{
+    constexpr EventDateType rangeLen{1024};
+    EventDateType fresh{POPULATED_EVENTS};
+    EventDateType from{0};
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            sharedStorage->storeEvent("signup", bench::makeEvent(fresh++));
+            continue;
+        }
+        from = (from + 104729) % (POPULATED_EVENTS - rangeLen);
+        benchmark::DoNotOptimize(sharedStorage->getEventInteractions("signup", from, from + rangeLen - 1));
+    }
+}
+
+BENCHMARK(BM_GetEventInteractions_WithWriter)
+    ->Setup(createPopulatedStorage)->Teardown(destroyStorage)
+    ->ThreadRange(2, 8)->UseRealTime();
+
+// mean over the whole populated event, how it used to be : copy the range out and average it
+static void BM_MeanLength_HugeEvent_CopyAndAverage(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto interactions{sharedStorage->getEventInteractions("signup", 0, POPULATED_EVENTS)};
+        benchmark::DoNotOptimize(calculateMeanPathLength(interactions));
+    }
+    state.SetItemsProcessed(state.iterations() * POPULATED_EVENTS);
+}
+
+BENCHMARK(BM_MeanLength_HugeEvent_CopyAndAverage)
+    ->Setup(createPopulatedStorage)->Teardown(destroyStorage)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// the same mean summed in place on a pool of range(0) threads, 0 walks serially,
+// latency against core count, flattens out once threads exceed the cores of the machine
+static void BM_MeanLength_HugeEvent_ParallelScan(benchmark::State& state)
+{
+    const auto threads{static_cast<size_t>(state.range(0))};
+    auto pool{threads != 0 ? std::make_unique<ctask::utils::concurrency::ComputePool>(threads) : nullptr};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sharedStorage->getEventPathLengthTotal("signup", 0, POPULATED_EVENTS, pool.get()).mean());
+    }
+    state.SetItemsProcessed(state.iterations() * POPULATED_EVENTS);
+}
+
+BENCHMARK(BM_MeanLength_HugeEvent_ParallelScan)
+    ->Setup(createPopulatedStorage)->Teardown(destroyStorage)
+    ->Arg(0)->Arg(2)->Arg(4)->Arg(8)->Arg(16)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// serial against parallel walk of a range of range(0) events, on a pool of range(1) threads;
+// the smallest range where /parallel beats /serial on the target host is the cutoff for PARALLEL_SCAN_MIN_EVENTS
+static void BM_MeanLength_ParallelCutoff(benchmark::State& state)
+{
+    const auto rangeLen{static_cast<EventDateType>(state.range(0))};
+    const auto parallel{state.range(2) != 0};
+    ctask::utils::concurrency::ComputePool pool{static_cast<size_t>(state.range(1))};
+    EventDateType from{0};
+    for (auto _ : state)
+    {
+        from = (from + 104729) % (POPULATED_EVENTS - rangeLen);
+        benchmark::DoNotOptimize(
+            sharedStorage->getEventPathLengthTotal("signup", from, from + rangeLen - 1, &pool,
+                                                   parallel ? 0 : std::numeric_limits<size_t>::max()).mean());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(parallel ? "parallel" : "serial");
+}
+
+BENCHMARK(BM_MeanLength_ParallelCutoff)
+    ->Setup(createPopulatedStorage)->Teardown(destroyStorage)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 19, 2), {2, 4, 8}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
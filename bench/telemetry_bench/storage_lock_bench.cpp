@@ -0,0 +1,85 @@
+#include "utils/concurrency/async_shared_mutex.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace ctask::utils::concurrency;
+
+// long writes somewhere else : the entry lock is held for 1ms out of every 1.25ms
+struct LongWriter
+{
+    AsyncSharedMutex mutex{};
+    std::jthread writer{[this](std::stop_token stopToken)
+    {
+        while (!stopToken.stop_requested())
+        {
+            {
+                std::unique_lock lock{mutex};
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+        }
+    }};
+};
+
+// a reader of the contended entry and a cheap request land on the same io thread,
+// the time until the cheap request runs is measured, the mean hides the rare stalls, so p99 and max are reported
+template <typename PostReader>
+static void cheapRequestLatency(benchmark::State& state, PostReader postReader)
+{
+    LongWriter longWriter{};
+    asio::io_context ctx{};
+    auto guard{asio::make_work_guard(ctx)};
+    std::jthread ioThread{[&ctx]() { ctx.run(); }};
+
+    std::vector<double> latencies{};
+    for (auto _ : state)
+    {
+        postReader(ctx, longWriter.mutex);
+
+        std::promise<void> served{};
+        const auto start{std::chrono::steady_clock::now()};
+        asio::post(ctx, [&served]() { served.set_value(); });
+        served.get_future().wait();
+        const auto latency{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        state.SetIterationTime(latency);
+        latencies.push_back(latency);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p99_us"] = latencies[latencies.size() * 99 / 100] * 1e6;
+    state.counters["max_us"] = latencies.back() * 1e6;
+
+    guard.reset();
+    ctx.stop();
+}
+
+// before : the reader blocks the io thread on the lock
+static void BM_CheapRequest_BehindBlockingReader(benchmark::State& state)
+{
+    cheapRequestLatency(state, [](asio::io_context& ctx, AsyncSharedMutex& mutex)
+    {
+        asio::post(ctx, [&mutex]() { std::shared_lock lock{mutex}; });
+    });
+}
+
+BENCHMARK(BM_CheapRequest_BehindBlockingReader)->UseManualTime();
+
+// after : the reader suspends, the io thread goes on
+static void BM_CheapRequest_BehindSuspendedReader(benchmark::State& state)
+{
+    cheapRequestLatency(state, [](asio::io_context& ctx, AsyncSharedMutex& mutex)
+    {
+        asio::co_spawn(ctx, [&mutex]() -> asio::awaitable<void>
+        {
+            auto lock{co_await mutex.asyncLockShared()};
+        }, asio::detached);
+    });
+}
+
+BENCHMARK(BM_CheapRequest_BehindSuspendedReader)->UseManualTime();
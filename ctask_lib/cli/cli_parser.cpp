@@ -1,4 +1,6 @@
 #include "cli_parser.h"
+#include "telemetry/core/ingest_pipeline.h"
+#include "telemetry/core/misc.h"
 
 #include <cxxopts.hpp>
 #include <fstream>
@@ -8,6 +10,38 @@ namespace ctask::cli_parser
 {
     using namespace ctask::utils::types;
 
+    // cache section is optional, the cache is on by default
+    constexpr size_t DEFAULT_MEAN_LENGTH_CACHE_CAPACITY{10000};
+
+    // tracing section is optional too, a single request out of a hundred is traced by default
+    constexpr uint32_t DEFAULT_TRACE_SAMPLE_EVERY{100};
+    constexpr size_t DEFAULT_TRACE_CAPACITY{65536};
+    constexpr const char* DEFAULT_TRACE_DUMP_PATH{"ctask_trace.json"};
+
+    // persistent connections serve any amount of requests unless the server section says otherwise
+    constexpr size_t DEFAULT_KEEP_ALIVE_MAX_REQUESTS{0};
+
+    // logger keys besides the level are optional, nothing is lost and nothing is written to files by default
+    constexpr const char* DEFAULT_LOG_OVERFLOW_POLICY{"block"};
+    constexpr size_t DEFAULT_LOG_RING_CAPACITY{4096};
+    constexpr size_t DEFAULT_LOG_FILE_MAX_SIZE{64 * 1024 * 1024};
+    constexpr size_t DEFAULT_LOG_FILE_MAX_FILES{3};
+
+    // compute section is optional, a worker per core by default
+    constexpr size_t DEFAULT_COMPUTE_THREADS{0};
+
+    // ingest section is optional, handlers store events themselves by default
+    constexpr bool DEFAULT_INGEST_PIPELINE{false};
+    constexpr const char* DEFAULT_INGEST_ACK{"enqueued"};
+    using telemetry::core::DEFAULT_INGEST_WRITERS;
+    using telemetry::core::DEFAULT_INGEST_QUEUE_CAPACITY;
+
+    // telemetry section is optional, events carry as many interaction times as the storage does by default
+    constexpr size_t DEFAULT_INTERACTION_TIMES_LEN{telemetry::core::INTERACTION_TIMES_LEN};
+
+    // admission section is optional as well, no limits by default
+    constexpr size_t DEFAULT_ADMISSION_LIMIT{0};
+
     CliParser::CliParser(std::string appName, std::string appDescription) :
         appName_(std::move(appName)), appDescription_(std::move(appDescription))
     {
@@ -35,15 +69,52 @@ namespace ctask::cli_parser
         configFile.close();
 
         auto config = nlohmann::json::parse(ss.str());
+        auto cacheConfig = config.value("cache", nlohmann::json::object());
+        auto tracingConfig = config.value("tracing", nlohmann::json::object());
+        auto admissionConfig = config.value("admission", nlohmann::json::object());
+        auto computeConfig = config.value("compute", nlohmann::json::object());
+        auto ingestConfig = config.value("ingest", nlohmann::json::object());
+        auto telemetryConfig = config.value("telemetry", nlohmann::json::object());
         return {
             {
                 config["server"]["address"].get<std::string>(),
                 config["server"]["port"].get<std::uint16_t>(),
                 0,
                 config["server"]["keepAliveSec"].get<std::uint16_t>(),
+                config["server"].value("keepAliveMaxRequests", DEFAULT_KEEP_ALIVE_MAX_REQUESTS),
+                {
+                    admissionConfig.value("maxConnections", DEFAULT_ADMISSION_LIMIT),
+                    admissionConfig.value("maxInFlightRequests", DEFAULT_ADMISSION_LIMIT),
+                    admissionConfig.value("maxQueueDepth", DEFAULT_ADMISSION_LIMIT),
+                },
             },
             {
                 config["logger"]["level"].get<std::string>(),
+                config["logger"].value("overflowPolicy", std::string{DEFAULT_LOG_OVERFLOW_POLICY}),
+                config["logger"].value("ringCapacity", DEFAULT_LOG_RING_CAPACITY),
+                config["logger"].value("filePath", std::string{}),
+                config["logger"].value("fileMaxSize", DEFAULT_LOG_FILE_MAX_SIZE),
+                config["logger"].value("fileMaxFiles", DEFAULT_LOG_FILE_MAX_FILES),
+            },
+            {
+                cacheConfig.value("meanLengthCapacity", DEFAULT_MEAN_LENGTH_CACHE_CAPACITY),
+            },
+            {
+                tracingConfig.value("sampleEvery", DEFAULT_TRACE_SAMPLE_EVERY),
+                tracingConfig.value("capacity", DEFAULT_TRACE_CAPACITY),
+                tracingConfig.value("dumpPath", std::string{DEFAULT_TRACE_DUMP_PATH}),
+            },
+            {
+                computeConfig.value("threads", DEFAULT_COMPUTE_THREADS),
+            },
+            {
+                ingestConfig.value("pipeline", DEFAULT_INGEST_PIPELINE),
+                ingestConfig.value("ack", std::string{DEFAULT_INGEST_ACK}),
+                ingestConfig.value("writers", DEFAULT_INGEST_WRITERS),
+                ingestConfig.value("queueCapacity", DEFAULT_INGEST_QUEUE_CAPACITY),
+            },
+            {
+                telemetryConfig.value("interactionTimesLen", DEFAULT_INTERACTION_TIMES_LEN),
             }
         };
     }
@@ -1,15 +1,20 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include "logging/ring_buffer_sink.h"
+#include "utils/types/types.h"
+
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
-#include <spdlog/async.h>
 
 /**
  * @class Logger
  * @brief Global logger entity
  *
  * This class provides a logging utility.
+ * Messages go to per-thread lock-free rings and are written by a single drain thread,
+ * so a slow console or disk never stalls the threads which log.
  */
 class Logger
 {
@@ -27,15 +32,33 @@ public:
 
     std::shared_ptr<spdlog::logger> getLogger() { return logger_; }
 
+    std::shared_ptr<ctask::logging::RingBufferSink> getRingSink() { return ringSink_; }
+
+    /**
+     * @brief Applies the logger config section, to be called before other threads start logging.
+     *
+     * @throws std::invalid_argument If the overflow policy is unknown or ring capacity is zero.
+     */
+    void configure(const ctask::utils::types::LoggerArgs& args)
+    {
+        ringSink_->setOverflowPolicy(ctask::logging::logOverflowPolicyFromString(args.overflowPolicy));
+        ringSink_->setRingCapacity(args.ringCapacity);
+        if (!args.filePath.empty())
+        {
+            // written by the drain thread only and flushed once per batch
+            ringSink_->addSink(std::make_shared<spdlog::sinks::rotating_file_sink_st>(
+                args.filePath, args.fileMaxSize, args.fileMaxFiles));
+        }
+        logger_->set_level(spdlog::level::from_str(args.level));
+    }
+
 private:
     Logger()
     {
-        spdlog::init_thread_pool(8192, 1);
-        auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        ringSink_ = std::make_shared<ctask::logging::RingBufferSink>();
+        ringSink_->addSink(std::make_shared<spdlog::sinks::stdout_color_sink_st>());
 
-        logger_ = std::make_shared<spdlog::async_logger>(
-            "global_logger", consoleSink, spdlog::thread_pool(),
-            spdlog::async_overflow_policy::block);
+        logger_ = std::make_shared<spdlog::logger>("global_logger", ringSink_);
 
         // Format: [2025-03-20 12:34:56] [info] [Thread ID: 1234] Message
         logger_->set_pattern("[%Y-%m-%d %H:%M:%S] [%^%l%$] [Thread ID: %t] %v");
@@ -45,6 +68,48 @@ private:
         spdlog::set_level(spdlog::level::debug);
     }
 
+    std::shared_ptr<ctask::logging::RingBufferSink> ringSink_;
     std::shared_ptr<spdlog::logger> logger_;
 };
+
+/**
+ * @brief Log calls below this level are compiled out, spdlog numbering: 0 - trace ... 6 - off.
+ *
+ * Set by CTASK_LOG_LEVEL cmake option, everything is compiled in by default.
+ */
+#ifndef CTASK_LOG_ACTIVE_LEVEL
+#define CTASK_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/**
+ * @brief Logs only if the level is compiled in and enabled at runtime.
+ *
+ * Arguments are evaluated and the message is formatted after the runtime check,
+ * so a disabled call costs a single branch. Compiled out calls cost nothing,
+ * yet their arguments are still type-checked.
+ *
+ * @param loggerPtr Pointer (or shared pointer) to spdlog::logger.
+ * @param levelNum spdlog level number, see SPDLOG_LEVEL_*.
+ * @param ... Format string and its arguments, the same as spdlog::logger::log accepts.
+ */
+#define CTASK_LOG(loggerPtr, levelNum, ...)                                                        \
+    do                                                                                             \
+    {                                                                                              \
+        if constexpr ((levelNum) >= CTASK_LOG_ACTIVE_LEVEL)                                        \
+        {                                                                                          \
+            constexpr auto ctaskLogLevel_{static_cast<spdlog::level::level_enum>(levelNum)};       \
+            if ((loggerPtr)->should_log(ctaskLogLevel_))                                           \
+            {                                                                                      \
+                (loggerPtr)->log(ctaskLogLevel_, __VA_ARGS__);                                     \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+    while (false)
+
+#define CTASK_LOG_TRACE(logger, ...) CTASK_LOG(logger, SPDLOG_LEVEL_TRACE, __VA_ARGS__)
+#define CTASK_LOG_DEBUG(logger, ...) CTASK_LOG(logger, SPDLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define CTASK_LOG_INFO(logger, ...) CTASK_LOG(logger, SPDLOG_LEVEL_INFO, __VA_ARGS__)
+#define CTASK_LOG_WARN(logger, ...) CTASK_LOG(logger, SPDLOG_LEVEL_WARN, __VA_ARGS__)
+#define CTASK_LOG_ERROR(logger, ...) CTASK_LOG(logger, SPDLOG_LEVEL_ERROR, __VA_ARGS__)
+
 #endif //LOGGER_H
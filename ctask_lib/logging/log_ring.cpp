@@ -0,0 +1,126 @@
+#include "log_ring.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace ctask::logging
+{
+    bool LogRecord::assign(const spdlog::details::log_msg& msg) noexcept
+    {
+        time = msg.time;
+        threadId = msg.thread_id;
+        level = msg.level;
+
+        nameLen = static_cast<uint8_t>(std::min(msg.logger_name.size(), name.size()));
+        std::memcpy(name.data(), msg.logger_name.data(), nameLen);
+
+        payloadLen = static_cast<uint16_t>(std::min(msg.payload.size(), payload.size()));
+        std::memcpy(payload.data(), msg.payload.data(), payloadLen);
+        return payloadLen < msg.payload.size();
+    }
+
+    spdlog::details::log_msg LogRecord::message() const
+    {
+        spdlog::details::log_msg msg{
+            time, spdlog::source_loc{}, spdlog::string_view_t{name.data(), nameLen}, level,
+            spdlog::string_view_t{payload.data(), payloadLen}
+        };
+        msg.thread_id = threadId;
+        return msg;
+    }
+
+    LogRing::LogRing(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Log ring capacity must be greater than zero");
+        }
+
+        capacity = std::bit_ceil(capacity);
+        slots_ = std::make_unique<Slot[]>(capacity);
+        mask_ = capacity - 1;
+        for (size_t i{0}; i < capacity; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool LogRing::tryPush(const spdlog::details::log_msg& msg, bool& truncated) noexcept
+    {
+        auto pos{enqueuePos_.load(std::memory_order_relaxed)};
+        for (;;)
+        {
+            auto& slot{slots_[pos & mask_]};
+            const auto sequence{slot.sequence.load(std::memory_order_acquire)};
+            const auto diff{static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos)};
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    truncated = slot.record.assign(msg);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the slot still keeps a record of the previous round
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename Consume>
+    bool LogRing::pop_(Consume consume) noexcept
+    {
+        auto pos{dequeuePos_.load(std::memory_order_relaxed)};
+        for (;;)
+        {
+            auto& slot{slots_[pos & mask_]};
+            const auto sequence{slot.sequence.load(std::memory_order_acquire)};
+            const auto diff{static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1)};
+            if (diff == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    consume(slot.record);
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool LogRing::tryPop(LogRecord& record) noexcept
+    {
+        return pop_([&record](const LogRecord& slotRecord)
+        {
+            record.time = slotRecord.time;
+            record.threadId = slotRecord.threadId;
+            record.level = slotRecord.level;
+            record.nameLen = slotRecord.nameLen;
+            record.payloadLen = slotRecord.payloadLen;
+            std::memcpy(record.name.data(), slotRecord.name.data(), slotRecord.nameLen);
+            std::memcpy(record.payload.data(), slotRecord.payload.data(), slotRecord.payloadLen);
+        });
+    }
+
+    bool LogRing::dropOldest() noexcept
+    {
+        return pop_([](const LogRecord&) {});
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <spdlog/details/log_msg.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ctask::logging
+{
+    // longer messages are cut, 512 bytes fit any of our log lines except request bodies
+    constexpr size_t LOG_RECORD_PAYLOAD_LEN{512};
+    constexpr size_t LOG_RECORD_NAME_LEN{32};
+
+    /**
+     * @struct LogRecord
+     * @brief Copy of spdlog::details::log_msg which owns its payload, so it can wait in a ring.
+     */
+    struct LogRecord
+    {
+        spdlog::log_clock::time_point time{};
+        size_t threadId{0};
+        spdlog::level::level_enum level{spdlog::level::off};
+        uint8_t nameLen{0};
+        uint16_t payloadLen{0};
+        std::array<char, LOG_RECORD_NAME_LEN> name{};
+        std::array<char, LOG_RECORD_PAYLOAD_LEN> payload{};
+
+        /**
+         * @brief Copies the message, cutting what doesn't fit.
+         *
+         * @return true if the payload was cut.
+         */
+        bool assign(const spdlog::details::log_msg& msg) noexcept;
+
+        /**
+         * @brief Builds the message for sinks, it points into the record.
+         */
+        spdlog::details::log_msg message() const;
+    };
+
+    /**
+     * @class LogRing
+     * @brief Bounded lock-free queue of log records, one per producing thread.
+     *
+     * Vyukov's bounded queue: every slot carries a sequence number telling whether it's free or filled,
+     * positions are claimed with a CAS, so nobody ever waits on a lock. A slot is claimed before
+     * its record is touched, which lets the producer itself throw the oldest record away
+     * when the ring is full, concurrently with the drain.
+     */
+    class LogRing
+    {
+    public:
+        /**
+         * @param capacity Amount of records, rounded up to a power of two.
+         *
+         * @throws std::invalid_argument If capacity is zero.
+         */
+        explicit LogRing(size_t capacity);
+        ~LogRing() = default;
+        LogRing(const LogRing&) = delete;
+        LogRing& operator=(const LogRing&) = delete;
+        LogRing(LogRing&&) = delete;
+        LogRing& operator=(LogRing&&) = delete;
+
+        /**
+         * @brief Puts the message into the ring.
+         *
+         * @param truncated Set to true if the payload was cut.
+         * @return false if the ring is full.
+         */
+        bool tryPush(const spdlog::details::log_msg& msg, bool& truncated) noexcept;
+
+        /**
+         * @brief Takes the oldest record out.
+         *
+         * @return false if the ring is empty.
+         */
+        bool tryPop(LogRecord& record) noexcept;
+
+        /**
+         * @brief Throws the oldest record away.
+         *
+         * @return false if the ring is empty.
+         */
+        bool dropOldest() noexcept;
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+        // producer side accounting, read by whoever reports it
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> overrun{0};
+        std::atomic<uint64_t> truncated{0};
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence{0};
+            LogRecord record{};
+        };
+
+        template <typename Consume>
+        bool pop_(Consume consume) noexcept;
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> enqueuePos_{0};
+        alignas(64) std::atomic<size_t> dequeuePos_{0};
+    };
+}
+
+#endif //LOG_RING_H
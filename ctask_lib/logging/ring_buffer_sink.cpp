@@ -0,0 +1,276 @@
+#include "ring_buffer_sink.h"
+
+#include "metrics/metrics_registry.h"
+
+#include <spdlog/pattern_formatter.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace ctask::logging
+{
+    namespace
+    {
+        // sink ids are never reused, so a stale thread-local entry of a destroyed sink is never matched
+        std::atomic<uint64_t> nextSinkId{1};
+
+        struct ThreadRing
+        {
+            uint64_t sinkId{0};
+            LogRing* ring{nullptr};
+        };
+
+        // a thread usually logs into a single sink, the linear search is one comparison
+        thread_local std::vector<ThreadRing> threadRings{};
+    }
+
+    LogOverflowPolicy logOverflowPolicyFromString(const std::string& name)
+    {
+        if (name == "block")
+        {
+            return LogOverflowPolicy::BLOCK;
+        }
+        if (name == "overrun_oldest")
+        {
+            return LogOverflowPolicy::OVERRUN_OLDEST;
+        }
+        if (name == "discard_new")
+        {
+            return LogOverflowPolicy::DISCARD_NEW;
+        }
+        throw std::invalid_argument("Unknown log overflow policy: " + name);
+    }
+
+    RingBufferSink::RingBufferSink(size_t ringCapacity, LogOverflowPolicy policy, std::chrono::milliseconds drainPeriod) :
+        id_(nextSinkId.fetch_add(1, std::memory_order_relaxed)),
+        policy_(policy),
+        ringCapacity_(ringCapacity),
+        drainPeriod_(drainPeriod),
+        droppedTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_log_dropped_messages_total", "Log messages discarded because the thread's ring was full")),
+        overrunTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_log_overrun_messages_total", "Queued log messages overwritten because the thread's ring was full")),
+        truncatedTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_log_truncated_messages_total", "Log messages cut to the ring record size"))
+    {
+        if (ringCapacity == 0)
+        {
+            throw std::invalid_argument("Log ring capacity must be greater than zero");
+        }
+        drainThread_ = std::jthread{[this](std::stop_token stopToken) { drainRoutine_(std::move(stopToken)); }};
+    }
+
+    RingBufferSink::~RingBufferSink()
+    {
+        drainThread_.request_stop();
+        if (drainThread_.joinable())
+        {
+            drainThread_.join();
+        }
+
+        // whatever was logged after the last round
+        while (drainOnce_())
+        {
+        }
+        publishStats_();
+    }
+
+    void RingBufferSink::log(const spdlog::details::log_msg& msg)
+    {
+        auto& ring{ring_()};
+
+        bool truncated{false};
+        if (!ring.tryPush(msg, truncated))
+        {
+            switch (policy_.load(std::memory_order_relaxed))
+            {
+            case LogOverflowPolicy::DISCARD_NEW:
+                ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+
+            case LogOverflowPolicy::OVERRUN_OLDEST:
+                // the drain might empty the ring meanwhile, then there is nothing to overrun
+                do
+                {
+                    if (ring.dropOldest())
+                    {
+                        ring.overrun.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                while (!ring.tryPush(msg, truncated));
+                break;
+
+            case LogOverflowPolicy::BLOCK:
+                // a round frees the whole ring, the loop is for a record still in there from the round's start
+                do
+                {
+                    std::unique_lock lock{drainMutex_};
+                    const auto round{++requestedRound_};
+                    // producers blocked on a full ring wait on the same variable, the drain must be woken anyway
+                    drainCv_.notify_all();
+                    drainCv_.wait(lock, [this, round]() { return finishedRound_ >= round; });
+                }
+                while (!ring.tryPush(msg, truncated));
+                break;
+            }
+        }
+
+        if (truncated)
+        {
+            ring.truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void RingBufferSink::flush()
+    {
+        std::unique_lock lock{drainMutex_};
+        const auto round{++requestedRound_};
+        drainCv_.notify_all();
+        drainCv_.wait(lock, [this, round]() { return finishedRound_ >= round; });
+    }
+
+    void RingBufferSink::set_pattern(const std::string& pattern)
+    {
+        set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+
+    void RingBufferSink::set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter)
+    {
+        std::lock_guard lock{sinksMutex_};
+        formatter_ = std::move(sinkFormatter);
+        for (const auto& sink : sinks_)
+        {
+            sink->set_formatter(formatter_->clone());
+        }
+    }
+
+    void RingBufferSink::addSink(std::shared_ptr<spdlog::sinks::sink> sink)
+    {
+        std::lock_guard lock{sinksMutex_};
+        if (formatter_)
+        {
+            sink->set_formatter(formatter_->clone());
+        }
+        sinks_.push_back(std::move(sink));
+    }
+
+    void RingBufferSink::setRingCapacity(size_t ringCapacity)
+    {
+        if (ringCapacity == 0)
+        {
+            throw std::invalid_argument("Log ring capacity must be greater than zero");
+        }
+        ringCapacity_.store(ringCapacity, std::memory_order_relaxed);
+    }
+
+    LogDropStats RingBufferSink::stats() const
+    {
+        LogDropStats stats{};
+        std::lock_guard lock{ringsMutex_};
+        for (const auto& ring : rings_)
+        {
+            stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+            stats.overrun += ring->overrun.load(std::memory_order_relaxed);
+            stats.truncated += ring->truncated.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    LogRing& RingBufferSink::ring_()
+    {
+        for (const auto& threadRing : threadRings)
+        {
+            if (threadRing.sinkId == id_)
+            {
+                return *threadRing.ring;
+            }
+        }
+
+        // the first message of the thread, the only time the producer takes a lock
+        std::lock_guard lock{ringsMutex_};
+        auto& ring{rings_.emplace_back(std::make_unique<LogRing>(ringCapacity_.load(std::memory_order_relaxed)))};
+        threadRings.push_back({id_, ring.get()});
+        return *ring;
+    }
+
+    bool RingBufferSink::drainOnce_()
+    {
+        std::vector<LogRing*> rings{};
+        {
+            std::lock_guard lock{ringsMutex_};
+            rings.reserve(rings_.size());
+            for (const auto& ring : rings_)
+            {
+                rings.push_back(ring.get());
+            }
+        }
+
+        // a round takes at most a ring worth of records from every thread, nobody starves
+        LogRecord record{};
+        bool written{false};
+        std::lock_guard lock{sinksMutex_};
+        for (auto* ring : rings)
+        {
+            for (size_t i{0}; i < ring->capacity() && ring->tryPop(record); ++i)
+            {
+                const auto msg{record.message()};
+                for (const auto& sink : sinks_)
+                {
+                    if (sink->should_log(msg.level))
+                    {
+                        sink->log(msg);
+                    }
+                }
+                written = true;
+            }
+        }
+
+        // a single flush per batch, file sinks write their buffers in one go
+        if (written)
+        {
+            for (const auto& sink : sinks_)
+            {
+                sink->flush();
+            }
+        }
+        return written;
+    }
+
+    void RingBufferSink::drainRoutine_(std::stop_token stopToken)
+    {
+        bool busy{false};
+        while (!stopToken.stop_requested())
+        {
+            uint64_t round{0};
+            {
+                std::unique_lock lock{drainMutex_};
+                if (!busy)
+                {
+                    drainCv_.wait_for(lock, stopToken, drainPeriod_,
+                                      [this]() { return requestedRound_ > finishedRound_; });
+                }
+                round = requestedRound_;
+            }
+
+            // a ring can't hold more than a round takes, so the round covers everything logged before the request
+            busy = drainOnce_();
+            publishStats_();
+
+            {
+                std::lock_guard lock{drainMutex_};
+                finishedRound_ = std::max(finishedRound_, round);
+            }
+            drainCv_.notify_all();
+        }
+    }
+
+    void RingBufferSink::publishStats_()
+    {
+        const auto current{stats()};
+        droppedTotal_.inc(current.dropped - published_.dropped);
+        overrunTotal_.inc(current.overrun - published_.overrun);
+        truncatedTotal_.inc(current.truncated - published_.truncated);
+        published_ = current;
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef RING_BUFFER_SINK_H
+#define RING_BUFFER_SINK_H
+
+#include "log_ring.h"
+#include "metrics/metrics.h"
+
+#include <spdlog/sinks/sink.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ctask::logging
+{
+    constexpr size_t DEFAULT_LOG_RING_CAPACITY{4096};
+    constexpr std::chrono::milliseconds DEFAULT_LOG_DRAIN_PERIOD{5};
+
+    /**
+     * @enum LogOverflowPolicy
+     * @brief What the logging thread does when its ring is full.
+     */
+    enum class LogOverflowPolicy
+    {
+        BLOCK,          // wait for the drain, nothing is lost
+        OVERRUN_OLDEST, // throw the oldest record away, keep the new one
+        DISCARD_NEW,    // keep what is queued, drop the new record
+    };
+
+    /**
+     * @brief Parses "block", "overrun_oldest" or "discard_new".
+     *
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    LogOverflowPolicy logOverflowPolicyFromString(const std::string& name);
+
+    /**
+     * @struct LogDropStats
+     * @brief Totals of lost and damaged messages since the sink was created.
+     */
+    struct LogDropStats
+    {
+        uint64_t dropped{0};   // new messages discarded on a full ring
+        uint64_t overrun{0};   // old messages overwritten on a full ring
+        uint64_t truncated{0}; // messages cut to LOG_RECORD_PAYLOAD_LEN
+    };
+
+    /**
+     * @class RingBufferSink
+     * @brief spdlog sink which never makes the logging thread wait for I/O.
+     *
+     * Every thread formats its message into its own lock-free ring, a single drain thread empties the rings
+     * into the downstream sinks in batches and flushes them once per batch. Downstream sinks are touched
+     * by the drain thread only, so the single-threaded (_st) versions are enough.
+     *
+     * Rings are created on the first message of a thread and live as long as the sink,
+     * the amount of threads in the service is fixed.
+     */
+    class RingBufferSink final : public spdlog::sinks::sink
+    {
+    public:
+        /**
+         * @param ringCapacity Records per thread, rounded up to a power of two.
+         * @param policy What to do on a full ring.
+         * @param drainPeriod How long the drain thread sleeps when there is nothing to do.
+         *
+         * @throws std::invalid_argument If ringCapacity is zero.
+         */
+        explicit RingBufferSink(size_t ringCapacity = DEFAULT_LOG_RING_CAPACITY,
+                                LogOverflowPolicy policy = LogOverflowPolicy::BLOCK,
+                                std::chrono::milliseconds drainPeriod = DEFAULT_LOG_DRAIN_PERIOD);
+        ~RingBufferSink() override;
+        RingBufferSink(const RingBufferSink&) = delete;
+        RingBufferSink& operator=(const RingBufferSink&) = delete;
+        RingBufferSink(RingBufferSink&&) = delete;
+        RingBufferSink& operator=(RingBufferSink&&) = delete;
+
+        void log(const spdlog::details::log_msg& msg) override;
+
+        /**
+         * @brief Blocks until everything logged before the call is written and flushed downstream.
+         */
+        void flush() override;
+
+        void set_pattern(const std::string& pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter) override;
+
+        /**
+         * @brief Adds a sink written by the drain thread, it gets the current formatter.
+         */
+        void addSink(std::shared_ptr<spdlog::sinks::sink> sink);
+
+        void setOverflowPolicy(LogOverflowPolicy policy) noexcept { policy_.store(policy, std::memory_order_relaxed); }
+
+        /**
+         * @brief Capacity of rings of threads which haven't logged yet, existing rings keep theirs.
+         *
+         * @throws std::invalid_argument If ringCapacity is zero.
+         */
+        void setRingCapacity(size_t ringCapacity);
+
+        LogDropStats stats() const;
+
+    private:
+        LogRing& ring_();
+        bool drainOnce_();
+        void drainRoutine_(std::stop_token stopToken);
+        void publishStats_();
+
+        const uint64_t id_;
+        std::atomic<LogOverflowPolicy> policy_;
+        std::atomic<size_t> ringCapacity_;
+        const std::chrono::milliseconds drainPeriod_;
+
+        mutable std::mutex ringsMutex_;
+        std::vector<std::unique_ptr<LogRing>> rings_;
+
+        // guards downstream sinks and the formatter against set_pattern from other threads
+        std::mutex sinksMutex_;
+        std::vector<std::shared_ptr<spdlog::sinks::sink>> sinks_;
+        std::unique_ptr<spdlog::formatter> formatter_;
+
+        std::mutex drainMutex_;
+        std::condition_variable_any drainCv_;
+        uint64_t requestedRound_{0};
+        uint64_t finishedRound_{0};
+
+        LogDropStats published_{};
+        metrics::Counter& droppedTotal_;
+        metrics::Counter& overrunTotal_;
+        metrics::Counter& truncatedTotal_;
+
+        // the last member, it must stop before everything above goes away
+        std::jthread drainThread_;
+    };
+}
+
+#endif //RING_BUFFER_SINK_H
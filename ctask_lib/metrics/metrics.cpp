@@ -0,0 +1,66 @@
+#include "metrics.h"
+
+#include <stdexcept>
+
+namespace ctask::metrics
+{
+    size_t threadSlot() noexcept
+    {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local const size_t slot{nextSlot.fetch_add(1, std::memory_order_relaxed) % METRIC_SLOTS};
+        return slot;
+    }
+
+    uint64_t Counter::value() const noexcept
+    {
+        uint64_t result{0};
+        for (const auto& slot : slots_)
+        {
+            result += slot.value.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    Histogram::Histogram(std::vector<uint64_t> bounds, double unitDivisor) :
+        bounds_(std::move(bounds)), unitDivisor_(unitDivisor)
+    {
+        if (bounds_.empty() || bounds_.size() > MAX_BOUNDS)
+        {
+            throw std::invalid_argument("Invalid amount of histogram bounds");
+        }
+
+        for (size_t i{1}; i < bounds_.size(); ++i)
+        {
+            if (bounds_[i] <= bounds_[i - 1])
+            {
+                throw std::invalid_argument("Histogram bounds must be strictly increasing");
+            }
+        }
+    }
+
+    HistogramSnapshot Histogram::snapshot() const
+    {
+        HistogramSnapshot result{std::vector<uint64_t>(bounds_.size() + 1, 0)};
+        for (const auto& slot : slots_)
+        {
+            for (size_t i{0}; i < result.counts.size(); ++i)
+            {
+                const auto count{slot.counts[i].load(std::memory_order_relaxed)};
+                result.counts[i] += count;
+                result.count += count;
+            }
+            result.sum += slot.sum.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    const std::vector<uint64_t>& latencyBoundsNs()
+    {
+        static const std::vector<uint64_t> bounds{
+            50'000, 100'000, 250'000, 500'000,
+            1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000,
+            100'000'000, 250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000
+        };
+        return bounds;
+    }
+}
@@ -0,0 +1,215 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ctask::metrics
+{
+    // std::hardware_destructive_interference_size is not everywhere yet, 64 bytes fits x86 and most of arm
+    constexpr size_t CACHE_LINE_SIZE{64};
+
+    // number of per-thread slots of a single metric, threads over this number share slots (still correct, just slower)
+    constexpr size_t METRIC_SLOTS{16};
+
+    /**
+     * @brief Returns the slot of the calling thread.
+     *
+     * Slots are handed out round-robin on the first call from a thread and never change.
+     */
+    size_t threadSlot() noexcept;
+
+    /**
+     * @class Counter
+     * @brief Monotonic counter, incremented without contention.
+     *
+     * Every thread increments its own cache line padded slot with a relaxed atomic add,
+     * so hot path never bounces cache lines between cores. Slots are summed on scrape.
+     */
+    class Counter
+    {
+    public:
+        Counter() = default;
+        ~Counter() = default;
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+        Counter(Counter&&) = delete;
+        Counter& operator=(Counter&&) = delete;
+
+        void inc(uint64_t value = 1) noexcept
+        {
+            slots_[threadSlot()].value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Returns sum of all slots.
+         */
+        uint64_t value() const noexcept;
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::atomic<uint64_t> value{0};
+        };
+
+        std::array<Slot, METRIC_SLOTS> slots_{};
+    };
+
+    /**
+     * @class Gauge
+     * @brief Value which goes up and down, e.g. amount of open connections.
+     *
+     * Just a single atomic, gauges are updated rarely compared to counters.
+     * A value changing on every request is sampled on scrape instead, see MetricsRegistry::addCollector.
+     */
+    class Gauge
+    {
+    public:
+        Gauge() = default;
+        ~Gauge() = default;
+        Gauge(const Gauge&) = delete;
+        Gauge& operator=(const Gauge&) = delete;
+        Gauge(Gauge&&) = delete;
+        Gauge& operator=(Gauge&&) = delete;
+
+        void add(int64_t value) noexcept { value_.fetch_add(value, std::memory_order_relaxed); }
+        void set(int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+        int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        alignas(CACHE_LINE_SIZE) std::atomic<int64_t> value_{0};
+    };
+
+    /**
+     * @struct HistogramSnapshot
+     * @brief Aggregated histogram state, counts are per bucket (not cumulative), the last one is +Inf.
+     */
+    struct HistogramSnapshot
+    {
+        std::vector<uint64_t> counts;
+        uint64_t sum{0};
+        uint64_t count{0};
+    };
+
+    /**
+     * @class Histogram
+     * @brief Histogram with fixed bucket bounds, per-thread slots like Counter.
+     *
+     * Values are integers (e.g. nanoseconds), unitDivisor converts them into exposed units (e.g. seconds).
+     */
+    class Histogram
+    {
+    public:
+        /**
+         * @brief Max amount of bucket bounds, +Inf bucket is not counted.
+         */
+        static constexpr size_t MAX_BOUNDS{16};
+
+        /**
+         * @param bounds Inclusive upper bounds of buckets, strictly increasing.
+         * @param unitDivisor Bounds and sum are divided by it on exposition, e.g. 1e9 for nanoseconds → seconds.
+         *
+         * @throws std::invalid_argument If bounds are empty, too many or not increasing.
+         */
+        explicit Histogram(std::vector<uint64_t> bounds, double unitDivisor = 1.0);
+        ~Histogram() = default;
+        Histogram(const Histogram&) = delete;
+        Histogram& operator=(const Histogram&) = delete;
+        Histogram(Histogram&&) = delete;
+        Histogram& operator=(Histogram&&) = delete;
+
+        void observe(uint64_t value) noexcept
+        {
+            size_t bucket{0};
+            while (bucket < bounds_.size() && value > bounds_[bucket])
+            {
+                ++bucket;
+            }
+
+            auto& slot{slots_[threadSlot()]};
+            slot.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+            slot.sum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void observe(std::chrono::nanoseconds duration) noexcept
+        {
+            observe(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+        }
+
+        /**
+         * @brief Sums up all slots.
+         */
+        HistogramSnapshot snapshot() const;
+
+        const std::vector<uint64_t>& bounds() const noexcept { return bounds_; }
+        double unitDivisor() const noexcept { return unitDivisor_; }
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::array<std::atomic<uint64_t>, MAX_BOUNDS + 1> counts{};
+            std::atomic<uint64_t> sum{0};
+        };
+
+        std::vector<uint64_t> bounds_;
+        double unitDivisor_;
+        std::array<Slot, METRIC_SLOTS> slots_{};
+    };
+
+    /**
+     * @brief Default latency buckets in nanoseconds, from 50us to 2.5s.
+     */
+    const std::vector<uint64_t>& latencyBoundsNs();
+
+    /**
+     * @class ScopedLatency
+     * @brief Observes time spent in the scope.
+     */
+    class ScopedLatency
+    {
+    public:
+        explicit ScopedLatency(Histogram& histogram) noexcept :
+            histogram_(histogram), start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedLatency() { histogram_.observe(std::chrono::steady_clock::now() - start_); }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+        ScopedLatency(ScopedLatency&&) = delete;
+        ScopedLatency& operator=(ScopedLatency&&) = delete;
+
+    private:
+        Histogram& histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Locks the lock, observing time spent waiting for it.
+     *
+     * Lock is tried first, only contended acquisitions touch the clock and the histogram,
+     * so the uncontended path costs nothing extra.
+     *
+     * @param lock Deferred std::unique_lock or std::shared_lock.
+     * @param waitTime Histogram of wait times in nanoseconds.
+     */
+    template <typename Lock>
+    void lockMeasured(Lock& lock, Histogram& waitTime)
+    {
+        if (lock.try_lock())
+        {
+            return;
+        }
+
+        const auto start{std::chrono::steady_clock::now()};
+        lock.lock();
+        waitTime.observe(std::chrono::steady_clock::now() - start);
+    }
+}
+
+#endif //METRICS_H
@@ -0,0 +1,184 @@
+#include "metrics_registry.h"
+
+#include <format>
+#include <stdexcept>
+
+namespace ctask::metrics
+{
+    MetricsRegistry& MetricsRegistry::instance()
+    {
+        // never destroyed, metrics may be touched by detached threads during shutdown
+        static auto* registry{new MetricsRegistry()};
+        return *registry;
+    }
+
+    Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels)
+    {
+        std::lock_guard lock(mutex_);
+        auto& metric{family_(name, help, MetricType::Counter).counters[formatLabels_(labels)]};
+        if (metric == nullptr)
+        {
+            metric = std::make_unique<Counter>();
+        }
+        return *metric;
+    }
+
+    Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels)
+    {
+        std::lock_guard lock(mutex_);
+        auto& metric{family_(name, help, MetricType::Gauge).gauges[formatLabels_(labels)]};
+        if (metric == nullptr)
+        {
+            metric = std::make_unique<Gauge>();
+        }
+        return *metric;
+    }
+
+    Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                                          std::vector<uint64_t> bounds, double unitDivisor)
+    {
+        std::lock_guard lock(mutex_);
+        auto& histograms{family_(name, help, MetricType::Histogram).histograms};
+        auto key{formatLabels_(labels)};
+        if (auto it{histograms.find(key)}; it != histograms.end())
+        {
+            return *it->second;
+        }
+
+        // construct before insertion, invalid bounds must not leave an empty slot behind
+        auto metric{std::make_unique<Histogram>(std::move(bounds), unitDivisor)};
+        return *histograms.emplace(std::move(key), std::move(metric)).first->second;
+    }
+
+    Histogram& MetricsRegistry::latencyHistogram(const std::string& name, const std::string& help,
+                                                 const Labels& labels)
+    {
+        return histogram(name, help, labels, latencyBoundsNs(), 1e9);
+    }
+
+    uint64_t MetricsRegistry::addCollector(Collector collector)
+    {
+        std::lock_guard lock(collectorsMutex_);
+        const auto id{nextCollectorId_++};
+        collectors_.emplace(id, std::move(collector));
+        return id;
+    }
+
+    void MetricsRegistry::removeCollector(uint64_t id)
+    {
+        std::lock_guard lock(collectorsMutex_);
+        collectors_.erase(id);
+    }
+
+    std::string MetricsRegistry::scrape()
+    {
+        {
+            std::lock_guard lock(collectorsMutex_);
+            for (const auto& [id, collector] : collectors_)
+            {
+                collector();
+            }
+        }
+
+        std::string result{};
+        std::lock_guard lock(mutex_);
+
+        // joins metric labels with an extra one, e.g. "le" of histogram buckets
+        auto joinLabels = [](const std::string& labels, const std::string& extra)
+        {
+            if (labels.empty() && extra.empty())
+            {
+                return std::string{};
+            }
+            if (labels.empty() || extra.empty())
+            {
+                return std::format("{{{}}}", labels.empty() ? extra : labels);
+            }
+            return std::format("{{{},{}}}", labels, extra);
+        };
+
+        for (const auto& [name, family] : families_)
+        {
+            switch (family.type)
+            {
+            case MetricType::Counter:
+                result += std::format("# HELP {} {}\n# TYPE {} counter\n", name, family.help, name);
+                for (const auto& [labels, counter] : family.counters)
+                {
+                    result += std::format("{}{} {}\n", name, joinLabels(labels, {}), counter->value());
+                }
+                break;
+            case MetricType::Gauge:
+                result += std::format("# HELP {} {}\n# TYPE {} gauge\n", name, family.help, name);
+                for (const auto& [labels, gauge] : family.gauges)
+                {
+                    result += std::format("{}{} {}\n", name, joinLabels(labels, {}), gauge->value());
+                }
+                break;
+            case MetricType::Histogram:
+                result += std::format("# HELP {} {}\n# TYPE {} histogram\n", name, family.help, name);
+                for (const auto& [labels, histogram] : family.histograms)
+                {
+                    const auto snapshot{histogram->snapshot()};
+                    const auto& bounds{histogram->bounds()};
+                    const auto divisor{histogram->unitDivisor()};
+
+                    // exposed buckets are cumulative
+                    uint64_t cumulative{0};
+                    for (size_t i{0}; i < bounds.size(); ++i)
+                    {
+                        cumulative += snapshot.counts[i];
+                        const auto le{std::format("le=\"{}\"", static_cast<double>(bounds[i]) / divisor)};
+                        result += std::format("{}_bucket{} {}\n", name, joinLabels(labels, le), cumulative);
+                    }
+                    result += std::format("{}_bucket{} {}\n", name, joinLabels(labels, "le=\"+Inf\""), snapshot.count);
+                    result += std::format("{}_sum{} {}\n", name, joinLabels(labels, {}),
+                                          static_cast<double>(snapshot.sum) / divisor);
+                    result += std::format("{}_count{} {}\n", name, joinLabels(labels, {}), snapshot.count);
+                }
+                break;
+            }
+        }
+        return result;
+    }
+
+    MetricsRegistry::Family& MetricsRegistry::family_(const std::string& name, const std::string& help,
+                                                      MetricType type)
+    {
+        auto [it, inserted]{families_.try_emplace(name, Family{type, help})};
+        if (!inserted && it->second.type != type)
+        {
+            throw std::invalid_argument(std::format("{}, metric already registered with another type", name));
+        }
+        return it->second;
+    }
+
+    std::string MetricsRegistry::formatLabels_(const Labels& labels)
+    {
+        std::string result{};
+        for (const auto& [name, value] : labels)
+        {
+            if (!result.empty())
+            {
+                result += ',';
+            }
+            result += name;
+            result += "=\"";
+            for (char c : value)
+            {
+                switch (c)
+                {
+                case '\\': result += "\\\\";
+                    break;
+                case '"': result += "\\\"";
+                    break;
+                case '\n': result += "\\n";
+                    break;
+                default: result += c;
+                }
+            }
+            result += '"';
+        }
+        return result;
+    }
+}
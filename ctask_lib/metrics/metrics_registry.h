@@ -0,0 +1,144 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include "metrics.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ctask::metrics
+{
+    /**
+     * @brief Metric labels, name → value pairs, e.g. {{"route", "/paths/{event}"}, {"method", "GET"}}.
+     */
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief Called on every scrape before metrics are rendered, e.g. to sample gauges kept elsewhere.
+     */
+    using Collector = std::function<void()>;
+
+    /**
+     * @class MetricsRegistry
+     * @brief Global registry of metrics, renders them in Prometheus text format.
+     *
+     * Metrics are registered once (usually on first use of a module) and referenced afterward,
+     * registry lock is taken only on registration and scrape, never on metric updates.
+     * Asking for the same name and labels twice returns the same metric,
+     * so modules created several times (e.g. in tests) share their metrics.
+     * Metrics live as long as the process, references never dangle.
+     */
+    class MetricsRegistry
+    {
+    public:
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+        MetricsRegistry(MetricsRegistry&&) = delete;
+        MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+        /**
+         * @brief Global registry entry point
+         *
+         * @returns Registry instance
+         */
+        static MetricsRegistry& instance();
+
+        /**
+         * @brief Returns counter, registers it if needed.
+         *
+         * @throws std::invalid_argument If name is already registered with another metric type.
+         */
+        Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+
+        /**
+         * @brief Returns gauge, registers it if needed.
+         *
+         * @throws std::invalid_argument If name is already registered with another metric type.
+         */
+        Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+
+        /**
+         * @brief Returns histogram, registers it if needed, bounds of an already registered one are kept.
+         *
+         * @throws std::invalid_argument If name is already registered with another metric type or bounds are invalid.
+         */
+        Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels,
+                             std::vector<uint64_t> bounds, double unitDivisor = 1.0);
+
+        /**
+         * @brief Returns histogram of durations observed in nanoseconds and exposed in seconds.
+         */
+        Histogram& latencyHistogram(const std::string& name, const std::string& help, const Labels& labels = {});
+
+        /**
+         * @brief Registers the collector, it's called on every scrape until removed.
+         *
+         * Values which are already counted somewhere (e.g. requests in flight) are sampled this way,
+         * instead of updating a shared gauge on every change.
+         *
+         * @returns Id of the collector for removeCollector.
+         */
+        uint64_t addCollector(Collector collector);
+
+        /**
+         * @brief Removes the collector, waits for its running call if there is one.
+         */
+        void removeCollector(uint64_t id);
+
+        /**
+         * @brief Runs collectors, aggregates all metrics and renders them in Prometheus text exposition format.
+         */
+        std::string scrape();
+
+    private:
+        MetricsRegistry() = default;
+        ~MetricsRegistry() = default;
+
+        enum class MetricType
+        {
+            Counter,
+            Gauge,
+            Histogram,
+        };
+
+        /**
+         * @struct Family
+         * @brief All metrics of a single name, keyed by rendered labels.
+         */
+        struct Family
+        {
+            MetricType type;
+            std::string help;
+            std::map<std::string, std::unique_ptr<Counter>> counters;
+            std::map<std::string, std::unique_ptr<Gauge>> gauges;
+            std::map<std::string, std::unique_ptr<Histogram>> histograms;
+        };
+
+        std::mutex mutex_;
+        std::map<std::string, Family> families_;
+
+        // apart from mutex_, collectors may register metrics themselves
+        std::mutex collectorsMutex_;
+        std::map<uint64_t, Collector> collectors_;
+        uint64_t nextCollectorId_{1};
+
+        /**
+         * @brief Finds or creates family, registry must be locked.
+         *
+         * @throws std::invalid_argument If family exists with another type.
+         */
+        Family& family_(const std::string& name, const std::string& help, MetricType type);
+
+        /**
+         * @brief Renders labels as `name="value",...`, escaping values.
+         */
+        static std::string formatLabels_(const Labels& labels);
+    };
+}
+
+#endif //METRICS_REGISTRY_H
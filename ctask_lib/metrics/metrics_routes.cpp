@@ -0,0 +1,22 @@
+#include "metrics_routes.h"
+#include "metrics_registry.h"
+#include "network/http/router/router_builder.h"
+#include "utils/types/constants.h"
+
+namespace ctask::metrics
+{
+    using namespace ctask::utils::types;
+    using namespace ctask::utils::constants;
+
+    void MetricsRoutes::registerRoutes(Router::RouterBuilder& builder)
+    {
+        builder.registerGet("/metrics", [](const HttpRequest&)
+        {
+            return HttpResponse{
+                HttpStatusCode::HTTP_STATUS_OK,
+                MetricsRegistry::instance().scrape(),
+                {{CONTENT_TYPE_HEADER, PROMETHEUS_CONTENT_TYPE}}
+            };
+        });
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef METRICS_ROUTES_H
+#define METRICS_ROUTES_H
+
+namespace ctask::network::http::router
+{
+    class RouterBuilder;
+}
+
+namespace ctask::metrics
+{
+    namespace Router = network::http::router;
+
+    /**
+     * @class MetricsRoutes
+     * @brief Static utility class for registering metrics HTTP routes.
+     *
+     * GET /metrics renders MetricsRegistry in Prometheus text format.
+     *
+     * This class is non-instantiable and non-copyable.
+     */
+    class MetricsRoutes
+    {
+    public:
+        MetricsRoutes() = delete;
+        MetricsRoutes(const MetricsRoutes&) = delete;
+        MetricsRoutes(MetricsRoutes&&) = delete;
+        MetricsRoutes& operator=(const MetricsRoutes&) = delete;
+        MetricsRoutes& operator=(MetricsRoutes&&) = delete;
+        ~MetricsRoutes() = delete;
+
+        /**
+         * @brief Registers metrics routes.
+         *
+         * @param builder Router builder instance for route registration.
+         */
+        static void registerRoutes(Router::RouterBuilder& builder);
+    };
+}
+
+#endif //METRICS_ROUTES_H
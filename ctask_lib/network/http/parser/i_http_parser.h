@@ -34,6 +34,15 @@ namespace ctask::network::http::parser
          * @return HttpRequest A parsed representation of the request.
          */
         virtual Types::HttpRequest parseRequest(std::string_view rawRequest) = 0;
+
+        /**
+         * @brief Same as above, but every member of the request takes memory from the given resource.
+         *
+         * @param rawRequest The raw HTTP request as a string view.
+         * @param resource Memory of the request, must outlive it.
+         * @return HttpRequest A parsed representation of the request.
+         */
+        virtual Types::HttpRequest parseRequest(std::string_view rawRequest, std::pmr::memory_resource* resource) = 0;
     };
 }
 #endif //I_PARSER_H
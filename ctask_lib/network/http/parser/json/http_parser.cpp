@@ -1,5 +1,6 @@
 #include "http_parser.h"
 #include "utils/misc/misc.h"
+#include "tracing/tracer.h"
 
 #include <format>
 
@@ -29,6 +30,11 @@ namespace ctask::network::http::parser
     }
 
     HttpRequest JsonHttpParser::parseRequest(std::string_view rawRequest)
+    {
+        return parseRequest(rawRequest, std::pmr::get_default_resource());
+    }
+
+    HttpRequest JsonHttpParser::parseRequest(std::string_view rawRequest, std::pmr::memory_resource* resource)
     {
         // I have no idea why, but without initialization, the next parsing process returns
         // an empty request structure... well, to avoid this, let's prepare deferred initialization.
@@ -48,25 +54,32 @@ namespace ctask::network::http::parser
         }
 
         // prepare helper contained structure for parsing process
-        HttpRequestParsingState helper;
+        HttpRequestParsingState helper{resource};
         parser_.data = &helper;
 
         // run parsing
-        auto err{llhttp_execute(&parser_, rawRequest.data(), rawRequest.size())};
-        if (err != HPE_OK)
         {
-            throw std::runtime_error(std::format("Invalid request string : \"{}\", err : \"{}\"", rawRequest,
-                                                 llhttp_errno_name(err)));
+            tracing::ScopedSpan span{"llhttp"};
+            auto err{llhttp_execute(&parser_, rawRequest.data(), rawRequest.size())};
+            if (err != HPE_OK)
+            {
+                throw std::runtime_error(std::format("Invalid request string : \"{}\", err : \"{}\"", rawRequest,
+                                                     llhttp_errno_name(err)));
+            }
         }
 
         // final validations
-        for (auto& throwIfInvalid : validators_)
         {
-            throwIfInvalid(helper.request);
+            tracing::ScopedSpan span{"validate"};
+            for (auto& throwIfInvalid : validators_)
+            {
+                throwIfInvalid(helper.request);
+            }
         }
 
-        // Done, fresh request is ready to use
-        return helper.request;
+        // Done, fresh request is ready to use, it's a member of the helper, so no implicit move on return;
+        // moved containers keep their resource, nothing is copied
+        return std::move(helper.request);
     }
 
     // callback handlers implementation
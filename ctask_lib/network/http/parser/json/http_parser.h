@@ -5,8 +5,10 @@
 #include "utils/types/constants.h"
 
 #include <llhttp.h>
+#include <charconv>
 #include <stdexcept>
 #include <functional>
+#include <memory_resource>
 
 namespace ctask::network::http::parser
 {
@@ -40,6 +42,15 @@ namespace ctask::network::http::parser
          */
         Types::HttpRequest parseRequest(std::string_view rawRequest) override;
 
+        /**
+         * @brief Parses a raw HTTP request, the request memory comes from the given resource.
+         *
+         * @param rawRequest The raw HTTP request as a string view.
+         * @param resource Memory of the request, e.g. a per-connection arena.
+         * @return HttpRequest A structured representation of the request.
+         */
+        Types::HttpRequest parseRequest(std::string_view rawRequest, std::pmr::memory_resource* resource) override;
+
     private:
         /**
          * @struct HttpRequestParsingState
@@ -50,9 +61,19 @@ namespace ctask::network::http::parser
          */
         struct HttpRequestParsingState
         {
+            explicit HttpRequestParsingState(std::pmr::memory_resource* resource) :
+                request{
+                    Types::HttpMethod::UNKNOWN_METHOD, std::pmr::string{resource}, std::pmr::string{resource},
+                    Types::HttpHeaders{resource}, Types::HttpParameters{resource}, std::pmr::string{resource}
+                },
+                currentHeaderField{resource},
+                currentHeaderValue{resource}
+            {
+            }
+
             Types::HttpRequest request;
-            Types::HttpHeaderField currentHeaderField;
-            Types::HttpHeaderField currentHeaderValue;
+            std::pmr::string currentHeaderField;
+            std::pmr::string currentHeaderValue;
         };
 
         // third-party http parser and its settings
@@ -157,7 +178,11 @@ namespace ctask::network::http::parser
                 if (r.method == Types::HttpMethod::GET_METHOD || r.method == Types::HttpMethod::UNKNOWN_METHOD) return;
                 const auto it{r.headers.find(Constants::CONTENT_LENGTH_HEADER)};
                 if (it == r.headers.end()) throw std::runtime_error("Empty content length");
-                auto contentLen{static_cast<size_t>(std::stoll(it.operator->()->second))};
+                size_t contentLen{0};
+                const auto& value{it->second};
+                const auto [end, ec]{std::from_chars(value.data(), value.data() + value.size(), contentLen)};
+                if (ec != std::errc{} || end != value.data() + value.size())
+                    throw std::runtime_error("Invalid content length");
                 if (contentLen != r.body.size()) throw std::runtime_error("Content length mismatch");
             },
 
@@ -3,6 +3,8 @@
 
 #include "utils/types/types.h"
 
+#include <memory_resource>
+
 namespace ctask::network::http::response_serializer
 {
     namespace Types = utils::types;
@@ -31,6 +33,25 @@ namespace ctask::network::http::response_serializer
          * @return serialized Raw HTTP response (ready to send to client).
          */
         virtual std::string serialize(const Types::HttpResponseMeta& response) = 0;
+
+        /**
+         * @brief Serializes the HTTP response, appending it to the given string.
+         *
+         * Lets the caller decide where the memory comes from (e.g. a per-connection arena)
+         * and reuse it between requests.
+         *
+         * @param response Full response metadata (status, headers, body).
+         * @param out Destination, raw HTTP response is appended to it.
+         */
+        virtual void serialize(const Types::HttpResponseMeta& response, std::pmr::string& out) = 0;
+
+        /**
+         * @brief Serializes a single piece of a streamed (chunked) response body.
+         *
+         * @param chunk Body piece, an empty one produces the terminating chunk.
+         * @return serialized Raw chunk (ready to send to client).
+         */
+        virtual std::string serializeChunk(std::string_view chunk) = 0;
     };
 }
 #endif //I_RESPONSE_SERIALIZER_H
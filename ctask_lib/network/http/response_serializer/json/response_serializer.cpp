@@ -1,39 +1,138 @@
 #include "response_serializer.h"
 #include "utils/misc/misc.h"
+#include "utils/types/constants.h"
 
-#include <nlohmann/json.hpp>
-
+#include <array>
+#include <charconv>
 #include <format>
-#include <sstream>
+#include <limits>
 
 namespace ctask::network::http::response_serializer
 {
-    using namespace nlohmann;
     using namespace ctask::utils::misc;
+    using namespace ctask::utils::constants;
 
-    std::string JsonHttpResponseSerializer::serialize(const HttpResponseMeta& response)
+    // body of a response without message, the same as json::object().dump()
+    constexpr std::string_view EMPTY_JSON_BODY{"{}"};
+
+    // status line and the headers we always write, user headers are counted separately
+    constexpr size_t RESPONSE_HEAD_RESERVE{192};
+
+    // "timeout=65535, max=<size_t>" fits
+    constexpr size_t KEEP_ALIVE_VALUE_LEN{48};
+
+    /**
+     * @brief Appends raw HTTP response to any string-like destination.
+     *
+     * Everything is appended piece by piece, so the only allocation is the growth of the destination itself.
+     */
+    template <typename String>
+    static void appendResponse(const HttpResponseMeta& response, String& out)
     {
-        std::stringstream ss;
-        auto message{response.payload.message};
-        if (message.empty())
+        const bool streamed{static_cast<bool>(response.payload.bodyStream)};
+
+        std::string_view message{};
+        if (!streamed)
+        {
+            message = response.payload.message;
+            if (message.empty())
+            {
+                message = EMPTY_JSON_BODY;
+            }
+        }
+
+        size_t reserve{out.size() + RESPONSE_HEAD_RESERVE + message.size()};
+        for (const auto& header : response.payload.headers)
         {
-            message = json::object().dump();
+            reserve += header.first.size() + header.second.size() + 4;
         }
+        out.reserve(reserve);
+
+        auto appendHeader = [&out](std::string_view name, std::string_view value)
+        {
+            out.append(name).append(": ").append(value).append("\r\n");
+        };
 
-        // required response part
-        ss << std::format("HTTP/{} ", response.protocolVersion) << httpStatusCodeToString(response.payload.code) << " "
-            << httpStatusName(response.payload.code) << "\r\n"
-            << "Content-Type: application/json\r\n"
-            << "Content-Length: " << message.size() << "\r\n";
+        // required response part, content type might be overridden by handler (e.g. for streamed exports)
+        const auto contentTypeIt{response.payload.headers.find(CONTENT_TYPE_HEADER)};
+        out.append("HTTP/").append(response.protocolVersion).append(" ")
+           .append(httpStatusCodeToString(response.payload.code)).append(" ")
+           .append(httpStatusName(response.payload.code)).append("\r\n");
+        appendHeader(CONTENT_TYPE_HEADER,
+                     contentTypeIt != response.payload.headers.end()
+                         ? std::string_view{contentTypeIt->second}
+                         : std::string_view{JSON_CONTENT_TYPE});
+
+        // HTTP/1.0 knows nothing about chunks, body is just written as is until connection is closed
+        const bool closeDelimited{streamed && response.protocolVersion == "1.0"};
+        if (streamed && !closeDelimited)
+        {
+            appendHeader(TRANSFER_ENCODING_HEADER, CHUNKED_TRANSFER_ENCODING);
+        }
+        else
+        {
+            std::array<char, std::numeric_limits<size_t>::digits10 + 1> length{};
+            const auto [end, ec]{std::to_chars(length.data(), length.data() + length.size(), message.size())};
+            appendHeader(CONTENT_LENGTH_HEADER, std::string_view{length.data(), end});
+        }
+
+        // connection persistence is up to the server, handler can't override it;
+        // a close delimited body says so explicitly, whatever the server decided
+        const bool connectionHeader{response.keepAlive || closeDelimited};
+        if (connectionHeader)
+        {
+            if (!closeDelimited && response.keepAlive->persistent)
+            {
+                appendHeader(CONNECTION_HEADER, KEEP_ALIVE_CONNECTION);
+
+                std::array<char, KEEP_ALIVE_VALUE_LEN> value{};
+                const auto written{
+                    response.keepAlive->maxRequests == 0
+                        ? std::format_to_n(value.data(), value.size(), "timeout={}", response.keepAlive->timeoutSec)
+                        : std::format_to_n(value.data(), value.size(), "timeout={}, max={}",
+                                           response.keepAlive->timeoutSec, response.keepAlive->maxRequests)
+                };
+                appendHeader(KEEP_ALIVE_HEADER, std::string_view{value.data(), written.out});
+            }
+            else
+            {
+                appendHeader(CONNECTION_HEADER, CLOSE_CONNECTION);
+            }
+        }
 
         // add user defined headers
         for (const auto& header : response.payload.headers)
         {
-            ss << header.first << ": " << header.second << "\r\n";
+            if (header.first == CONTENT_TYPE_HEADER ||
+                (connectionHeader && CaseInsensitiveEqual{}(header.first, CONNECTION_HEADER)))
+            {
+                continue;
+            }
+            appendHeader(header.first, header.second);
         }
 
         // payload and serialize result
-        ss << "\r\n" << message;
-        return ss.str();
+        out.append("\r\n").append(message);
+    }
+
+    std::string JsonHttpResponseSerializer::serialize(const HttpResponseMeta& response)
+    {
+        std::string result{};
+        appendResponse(response, result);
+        return result;
+    }
+
+    void JsonHttpResponseSerializer::serialize(const HttpResponseMeta& response, std::pmr::string& out)
+    {
+        appendResponse(response, out);
+    }
+
+    std::string JsonHttpResponseSerializer::serializeChunk(std::string_view chunk)
+    {
+        std::string result{std::format("{:x}\r\n", chunk.size())};
+        result.reserve(result.size() + chunk.size() + 2);
+        result.append(chunk);
+        result.append("\r\n");
+        return result;
     }
 }
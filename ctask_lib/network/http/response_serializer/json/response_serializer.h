@@ -29,6 +29,23 @@ namespace ctask::network::http::response_serializer
          * @return std::string Raw HTTP response string.
          */
         std::string serialize(const Types::HttpResponseMeta& response) override;
+
+        /**
+         * @brief Same as above, but appends to the caller's string, no intermediate buffers are used.
+         *
+         * @param response Full response to serialize.
+         * @param out Destination string.
+         */
+        void serialize(const Types::HttpResponseMeta& response, std::pmr::string& out) override;
+
+        /**
+         * @brief Serializes the body piece into a transfer-encoding chunk.
+         * Format is "<hex size>\r\n<data>\r\n", an empty piece gives the last "0\r\n\r\n" chunk.
+         *
+         * @param chunk Body piece.
+         * @return std::string Raw chunk string.
+         */
+        std::string serializeChunk(std::string_view chunk) override;
     };
 }
 #endif //JSON_HTTP_RESPONSE_SERIALIZER_H
@@ -1,6 +1,10 @@
 #include "router.h"
+#include "metrics/metrics_registry.h"
+#include "tracing/tracer.h"
 
+#include <exception>
 #include <format>
+#include <optional>
 #include <sstream>
 
 namespace ctask::network::http::router
@@ -9,31 +13,40 @@ namespace ctask::network::http::router
 
     void HttpRouter::addGet(HttpPath path, HttpHandlerFn handler)
     {
-        registerHandler_(std::move(path), std::move(handler), getHandlers_);
+        registerHandler_(std::move(path), std::move(handler), {}, getHandlers_, "GET");
     }
 
     void HttpRouter::addPost(HttpPath path, HttpHandlerFn handler)
     {
-        registerHandler_(std::move(path), std::move(handler), postHandlers_);
+        registerHandler_(std::move(path), std::move(handler), {}, postHandlers_, "POST");
+    }
+
+    void HttpRouter::addGet(HttpPath path, HttpAsyncHandlerFn handler)
+    {
+        registerHandler_(std::move(path), {}, std::move(handler), getHandlers_, "GET");
+    }
+
+    void HttpRouter::addPost(HttpPath path, HttpAsyncHandlerFn handler)
+    {
+        registerHandler_(std::move(path), {}, std::move(handler), postHandlers_, "POST");
     }
 
     HttpResponse HttpRouter::route(HttpRequest& request) noexcept
     {
         try
         {
-            switch (request.method)
+            auto* handlers{handlersOf_(request.method)};
+            if (handlers == nullptr)
             {
-            case HttpMethod::GET_METHOD:
-                {
-                    return processRouting_(request, getHandlers_);
-                }
-            case HttpMethod::POST_METHOD:
-                {
-                    return processRouting_(request, postHandlers_);
-                }
-            default:
                 return HttpResponse{HttpStatusCode::HTTP_STATUS_NOT_IMPLEMENTED, "Method is not implemented"};
             }
+
+            auto* route{processRouting_(request, *handlers)};
+            if (route == nullptr)
+            {
+                return notFound_(request);
+            }
+            return route->handler ? invokeHandler_(*route, request) : invokeAsyncHandlerBlocking_(*route, request);
         }
         catch (const std::exception& e)
         {
@@ -41,8 +54,63 @@ namespace ctask::network::http::router
         }
     }
 
-    void HttpRouter::registerHandler_(HttpPath path, HttpHandlerFn handler, pathHandlerMap& map)
+    asio::awaitable<HttpResponse> HttpRouter::asyncRoute(HttpRequest& request, uint64_t traceRequestId)
+    {
+        try
+        {
+            auto* handlers{handlersOf_(request.method)};
+            if (handlers == nullptr)
+            {
+                co_return HttpResponse{HttpStatusCode::HTTP_STATUS_NOT_IMPLEMENTED, "Method is not implemented"};
+            }
+
+            auto* route{processRouting_(request, *handlers)};
+            if (route == nullptr)
+            {
+                co_return notFound_(request);
+            }
+
+            if (route->handler)
+            {
+                // doesn't suspend, so the trace scope can't outlive the thread
+                tracing::ActiveRequestScope activeRequest{traceRequestId};
+                co_return invokeHandler_(*route, request);
+            }
+            co_return co_await invokeAsyncHandler_(*route, request, traceRequestId);
+        }
+        catch (const std::exception& e)
+        {
+            co_return HttpResponse{HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR, e.what()};
+        }
+    }
+
+    HttpRouter::pathHandlerMap* HttpRouter::handlersOf_(HttpMethod method) noexcept
+    {
+        switch (method)
+        {
+        case HttpMethod::GET_METHOD:
+            return &getHandlers_;
+        case HttpMethod::POST_METHOD:
+            return &postHandlers_;
+        default:
+            return nullptr;
+        }
+    }
+
+    void HttpRouter::registerHandler_(HttpPath path, HttpHandlerFn handler, HttpAsyncHandlerFn asyncHandler,
+                                      pathHandlerMap& map, const char* method)
     {
+        // route metrics are labeled with the registered path, not the actual one, to keep cardinality bounded
+        auto& registry{metrics::MetricsRegistry::instance()};
+        const metrics::Labels labels{{"method", method}, {"route", path}};
+        RouteHandler route{
+            std::move(handler),
+            std::move(asyncHandler),
+            &registry.counter("ctask_route_requests_total", "Requests handled by route", labels),
+            &registry.counter("ctask_route_errors_total", "Requests finished with 4xx, 5xx or exception", labels),
+            &registry.latencyHistogram("ctask_route_duration_seconds", "Route handler duration", labels)
+        };
+
         if (path.find('{') == std::string::npos)
         {
             // direct path
@@ -51,7 +119,7 @@ namespace ctask::network::http::router
             {
                 throw std::invalid_argument(std::format("{}, handler already registered", path));
             }
-            map.emplace_hint(it, std::move(path), std::move(handler));
+            map.emplace_hint(it, std::move(path), std::move(route));
         }
         else
         {
@@ -64,39 +132,167 @@ namespace ctask::network::http::router
                 throw std::invalid_argument(std::format("{}, handler already registered", path));
             }
 
-            map.emplace_hint(it, std::move(pathTemplate), std::move(handler));
+            map.emplace_hint(it, pathTemplate, std::move(route));
 
-            RouteParameterInfo info{std::move(path), std::move(parameterNamesWithPositions)};
+            RouteParameterInfo info{std::move(path), std::move(parameterNamesWithPositions), std::move(pathTemplate)};
             pathParametersInfo_.emplace_back(std::move(info));
         }
     }
 
-    HttpResponse HttpRouter::processRouting_(HttpRequest& request, pathHandlerMap& handlersMap)
+    HttpRouter::RouteHandler* HttpRouter::processRouting_(HttpRequest& request, pathHandlerMap& handlersMap)
     {
         // try to find direct path and handle request
-        if (auto it{handlersMap.find(request.path)}; it != handlersMap.end())
+        if (auto it{handlersMap.find(std::string_view{request.path})}; it != handlersMap.end())
         {
-            return it->second(request);
+            return &it->second;
         }
 
         // try to find parameterizedPath and handle request
-        for (const auto& [parameterizedPath, paramsMeta] : pathParametersInfo_)
+        for (const auto& [parameterizedPath, paramsMeta, pathTemplate] : pathParametersInfo_)
         {
-            auto pathTemplate{buildParameterizedPathTemplate_(parameterizedPath)};
+            if (!matchParameterizedPath_(request.path, parameterizedPath))
+            {
+                continue;
+            }
 
             if (auto it = handlersMap.find(pathTemplate); it != handlersMap.end())
             {
-                auto parametersMap{parseParameters_(request.path, paramsMeta)};
+                auto parametersMap{
+                    parseParameters_(request.path, paramsMeta, request.parameters.get_allocator().resource())
+                };
                 request.parameters = std::move(parametersMap);
-                return it->second(request);
+                return &it->second;
             }
         }
 
+        return nullptr;
+    }
+
+    HttpResponse HttpRouter::notFound_(const HttpRequest& request)
+    {
+        static auto& notFound{
+            metrics::MetricsRegistry::instance().counter("ctask_route_not_found_total", "Requests of unknown paths")
+        };
+        notFound.inc();
         return HttpResponse{
             HttpStatusCode::HTTP_STATUS_NOT_FOUND, std::format("Path is not found : {}", request.path)
         };
     }
 
+    HttpResponse HttpRouter::invokeHandler_(RouteHandler& route, HttpRequest& request)
+    {
+        route.requests->inc();
+        metrics::ScopedLatency latency{*route.latency};
+        tracing::ScopedSpan span{"handler"};
+        try
+        {
+            auto response{route.handler(request)};
+            if (static_cast<uint16_t>(response.code) >= 400)
+            {
+                route.errors->inc();
+            }
+            return response;
+        }
+        catch (...)
+        {
+            route.errors->inc();
+            throw;
+        }
+    }
+
+    asio::awaitable<HttpResponse> HttpRouter::invokeAsyncHandler_(RouteHandler& route, HttpRequest& request,
+                                                                  uint64_t traceRequestId)
+    {
+        route.requests->inc();
+        metrics::ScopedLatency latency{*route.latency};
+
+        // the span only keeps the request id, so it may finish on another thread;
+        // spans nested into the handler are not recorded, the thread's scope can't live across co_await
+        std::optional<tracing::ScopedSpan> span{};
+        {
+            tracing::ActiveRequestScope activeRequest{traceRequestId};
+            span.emplace("handler");
+        }
+
+        std::exception_ptr error{};
+        try
+        {
+            auto response{co_await route.asyncHandler(request)};
+            if (static_cast<uint16_t>(response.code) >= 400)
+            {
+                route.errors->inc();
+            }
+            co_return response;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        route.errors->inc();
+        std::rethrow_exception(error);
+    }
+
+    HttpResponse HttpRouter::invokeAsyncHandlerBlocking_(RouteHandler& route, HttpRequest& request)
+    {
+        asio::io_context ctx{};
+        std::exception_ptr error{};
+        HttpResponse response{};
+        asio::co_spawn(ctx, invokeAsyncHandler_(route, request, 0),
+                       [&error, &response](std::exception_ptr e, HttpResponse result)
+                       {
+                           error = e;
+                           response = std::move(result);
+                       });
+        ctx.run();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return response;
+    }
+
+    bool HttpRouter::matchParameterizedPath_(std::string_view path, std::string_view parameterizedPath) const
+    {
+        size_t pathPos{0};
+        size_t parameterizedPos{0};
+
+        // walk both paths segment by segment, skipping empty segments like the rest of helpers do
+        auto nextPart = [](std::string_view str, size_t& pos)
+        {
+            while (pos < str.size() && str[pos] == '/')
+            {
+                ++pos;
+            }
+            auto endPos{str.find('/', pos)};
+            if (endPos == std::string::npos)
+            {
+                endPos = str.size();
+            }
+            auto part{str.substr(pos, endPos - pos)};
+            pos = endPos;
+            return part;
+        };
+
+        for (;;)
+        {
+            auto pathPart{nextPart(path, pathPos)};
+            auto parameterizedPart{nextPart(parameterizedPath, parameterizedPos)};
+
+            if (pathPart.empty() || parameterizedPart.empty())
+            {
+                // both paths must run out of segments at the same time
+                return pathPart.empty() && parameterizedPart.empty();
+            }
+
+            const bool isParameter{parameterizedPart.front() == '{' && parameterizedPart.back() == '}'};
+            if (!isParameter && pathPart != parameterizedPart)
+            {
+                return false;
+            }
+        }
+    }
+
     std::vector<HttpRouter::ParameterMetaData> HttpRouter::parseParameterNames_(std::string_view path) const
     {
         size_t pathEndPos{0};
@@ -158,10 +354,11 @@ namespace ctask::network::http::router
         return ss.str();
     }
 
-    std::unordered_map<ParameterName, ParameterValue> HttpRouter::parseParameters_(
-        std::string_view path, const std::vector<ParameterMetaData>& paramMeta) const
+    HttpParameters HttpRouter::parseParameters_(
+        std::string_view path, const std::vector<ParameterMetaData>& paramMeta,
+        std::pmr::memory_resource* resource) const
     {
-        std::vector<std::string_view> pathParts;
+        std::pmr::vector<std::string_view> pathParts{resource};
         pathParts.reserve(16);
 
         // split path, collect parts
@@ -184,14 +381,15 @@ namespace ctask::network::http::router
             }
         }
 
-        std::unordered_map<ParameterName, ParameterValue> result;
+        HttpParameters result{resource};
+        result.reserve(paramMeta.size());
         for (const auto& [parameterName, position] : paramMeta)
         {
             if (position >= pathParts.size())
             {
                 break;
             }
-            result[parameterName] = pathParts[position];
+            result.emplace(std::string_view{parameterName}, pathParts[position]);
         }
         return result;
     }
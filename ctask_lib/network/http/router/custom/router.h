@@ -2,6 +2,7 @@
 #define ROUTER_H
 
 #include "network/http/router/i_router.h"
+#include "metrics/metrics.h"
 
 namespace ctask::network::http::router
 {
@@ -13,6 +14,9 @@ namespace ctask::network::http::router
      *
      * The router maps routes to handler functions and supports parameter extraction
      * similar to lightweight web frameworks.
+     *
+     * A route is handled either by a plain function or by a coroutine (awaitable handler),
+     * asyncRoute awaits the latter, route() runs it to completion on a private io_context.
      */
     class HttpRouter final : public IRouter
     {
@@ -40,6 +44,19 @@ namespace ctask::network::http::router
           */
         void addPost(Types::HttpPath path, Types::HttpHandlerFn handler) override;
 
+        /**
+          * @brief Registers an awaitable handler for an HTTP GET path.
+          *
+          * @throws If path already registered
+          */
+        void addGet(Types::HttpPath path, HttpAsyncHandlerFn handler) override;
+
+        /**
+          * @brief Registers an awaitable handler for an HTTP POST path.
+          *
+          * @throws If path already registered
+          */
+        void addPost(Types::HttpPath path, HttpAsyncHandlerFn handler) override;
 
         /**
          * @brief Routes the request to the appropriate handler based on method and path.
@@ -58,8 +75,29 @@ namespace ctask::network::http::router
          */
         Types::HttpResponse route(Types::HttpRequest& request) noexcept override;
 
+        /**
+         * @brief Routes the request from a coroutine, awaitable handlers suspend it instead of blocking the thread.
+         *
+         * Plain handlers are called right away, the same as route() does.
+         */
+        asio::awaitable<Types::HttpResponse> asyncRoute(Types::HttpRequest& request,
+                                                        uint64_t traceRequestId) override;
+
     private:
-        using pathHandlerMap = std::unordered_map<Types::HttpPath, Types::HttpHandlerFn>;
+        /**
+         * @struct RouteHandler
+         * @brief Registered handler along with its route metrics, only one of handlers is set.
+         */
+        struct RouteHandler
+        {
+            Types::HttpHandlerFn handler;
+            HttpAsyncHandlerFn asyncHandler;
+            metrics::Counter* requests;
+            metrics::Counter* errors;
+            metrics::Histogram* latency;
+        };
+
+        using pathHandlerMap = std::unordered_map<Types::HttpPath, RouteHandler, Types::StringHash, std::equal_to<>>;
         pathHandlerMap getHandlers_;
         pathHandlerMap postHandlers_;
 
@@ -69,13 +107,37 @@ namespace ctask::network::http::router
          * Also parses and stores parameter metadata if the path is parameterized.
          *
          * @param path The route path.
-         * @param handler The request handler function.
+         * @param handler The request handler function, empty for an awaitable route.
+         * @param asyncHandler The request handler coroutine, empty for a plain route.
          * @param map The map (GET or POST) where the handler is stored.
+         * @param method Method name, used as metrics label.
          *
          * @throws If path already registered
          */
-        void registerHandler_(Types::HttpPath path, Types::HttpHandlerFn handler,
-                              pathHandlerMap& map);
+        void registerHandler_(Types::HttpPath path, Types::HttpHandlerFn handler, HttpAsyncHandlerFn asyncHandler,
+                              pathHandlerMap& map, const char* method);
+
+        /**
+         * @brief Calls the route handler, counting requests, errors (4xx, 5xx and exceptions) and latency.
+         */
+        static Types::HttpResponse invokeHandler_(RouteHandler& route, Types::HttpRequest& request);
+
+        /**
+         * @brief Awaits the route handler coroutine, counting the same as invokeHandler_.
+         */
+        static asio::awaitable<Types::HttpResponse> invokeAsyncHandler_(RouteHandler& route,
+                                                                        Types::HttpRequest& request,
+                                                                        uint64_t traceRequestId);
+
+        /**
+         * @brief Runs the route handler coroutine to completion on the calling thread.
+         */
+        static Types::HttpResponse invokeAsyncHandlerBlocking_(RouteHandler& route, Types::HttpRequest& request);
+
+        /**
+         * @brief Returns handlers of the request method, nullptr if the method is not supported.
+         */
+        pathHandlerMap* handlersOf_(Types::HttpMethod method) noexcept;
 
         /**
          * @brief Internal routing logic for a given method.
@@ -85,9 +147,14 @@ namespace ctask::network::http::router
          *
          * @param request The request to route.
          * @param handlersMap The map of handlers (GET or POST).
-         * @return HttpResponse The result of the matched handler.
+         * @return Matched route or nullptr if the path is unknown.
          */
-        Types::HttpResponse processRouting_(Types::HttpRequest& request, pathHandlerMap& handlersMap);
+        RouteHandler* processRouting_(Types::HttpRequest& request, pathHandlerMap& handlersMap);
+
+        /**
+         * @brief Response to a request of an unknown path.
+         */
+        static Types::HttpResponse notFound_(const Types::HttpRequest& request);
 
 
         // parameter positions and helper methods to operate with parameterized pathes,
@@ -112,6 +179,7 @@ namespace ctask::network::http::router
         {
             Types::HttpPath parameterizedPath;
             std::vector<ParameterMetaData> parametersMeta;
+            Types::HttpPath pathTemplate;
         };
 
         std::vector<RouteParameterInfo> pathParametersInfo_;
@@ -135,6 +203,18 @@ namespace ctask::network::http::router
          */
         Types::HttpPath buildParameterizedPathTemplate_(std::string_view path) const;
 
+        /**
+         * @brief Checks whether the actual path fits the registered parameterized route.
+         *
+         * Example: "/paths/home/export" fits "/paths/{event}/export", but doesn't fit "/paths/{event}/meanLength"
+         * Static segments must be equal, parameter segments accept any non-empty value.
+         *
+         * @param path The actual request path.
+         * @param parameterizedPath The registered route (may contain parameters like {id}).
+         * @return true if path matches the route.
+         */
+        bool matchParameterizedPath_(std::string_view path, std::string_view parameterizedPath) const;
+
         /**
          * @brief Parses parameter values from the actual path.
          *
@@ -142,11 +222,12 @@ namespace ctask::network::http::router
          *
          * @param path The actual request path.
          * @param paramMeta Parameter positions and names.
+         * @param resource Memory of the result, the same as of the request it's for.
          * @return Map of parameter names to values.
          */
-        std::unordered_map<Types::ParameterName, Types::ParameterValue> parseParameters_(std::string_view path,
+        Types::HttpParameters parseParameters_(std::string_view path,
             const std::vector<ParameterMetaData>&
-            paramMeta)
+            paramMeta, std::pmr::memory_resource* resource)
         const;
 
         /**
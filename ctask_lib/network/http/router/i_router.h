@@ -3,10 +3,19 @@
 
 #include "utils/types/types.h"
 
+#include <asio.hpp>
+
 namespace ctask::network::http::router
 {
     namespace Types = utils::types;
 
+    /**
+     * @brief Handler which may suspend, e.g. to offload heavy work or to wait for a lock.
+     *
+     * The request outlives the handler's coroutine.
+     */
+    using HttpAsyncHandlerFn = std::function<asio::awaitable<Types::HttpResponse>(const Types::HttpRequest&)>;
+
     /**
      * @interface IRouter
      * @brief Interface for an HTTP router.
@@ -45,6 +54,16 @@ namespace ctask::network::http::router
          */
         virtual void addPost(Types::HttpPath path, Types::HttpHandlerFn handler) = 0;
 
+        /**
+         * @brief Registers an awaitable handler for an HTTP GET route.
+         */
+        virtual void addGet(Types::HttpPath path, HttpAsyncHandlerFn handler) = 0;
+
+        /**
+         * @brief Registers an awaitable handler for an HTTP POST route.
+         */
+        virtual void addPost(Types::HttpPath path, HttpAsyncHandlerFn handler) = 0;
+
         /**
          * @brief Routes an incoming request to the appropriate handler.
          *
@@ -52,6 +71,20 @@ namespace ctask::network::http::router
          * @return HttpResponse The result from the matched handler.
          */
         virtual Types::HttpResponse route(Types::HttpRequest& request) noexcept = 0;
+
+        /**
+         * @brief Routes an incoming request from a coroutine, awaitable handlers are awaited.
+         *
+         * Synchronous routers can rely on the default, which just calls route().
+         *
+         * @param request The incoming HTTP request, must outlive the call.
+         * @param traceRequestId Sampled request id (0 if not sampled), spans of the handler are recorded under it.
+         * @return HttpResponse The result from the matched handler.
+         */
+        virtual asio::awaitable<Types::HttpResponse> asyncRoute(Types::HttpRequest& request, uint64_t traceRequestId)
+        {
+            co_return route(request);
+        }
     };
 }
 
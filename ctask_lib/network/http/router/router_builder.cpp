@@ -17,16 +17,28 @@ namespace ctask::network::http::router
         return *this;
     }
 
+    RouterBuilder& RouterBuilder::registerGet(HttpPath path, HttpAsyncHandlerFn handler)
+    {
+        getHandlers_.emplace(std::move(path), std::move(handler));
+        return *this;
+    }
+
+    RouterBuilder& RouterBuilder::registerPost(HttpPath path, HttpAsyncHandlerFn handler)
+    {
+        postHandlers_.emplace(std::move(path), std::move(handler));
+        return *this;
+    }
+
     std::unique_ptr<IRouter> RouterBuilder::build()
     {
         std::unique_ptr<HttpRouter> router(new HttpRouter());
         for (const auto& [path, handler] : getHandlers_)
         {
-            router->addGet(path, handler);
+            std::visit([&router, &path](const auto& fn) { router->addGet(path, fn); }, handler);
         }
         for (const auto& [path, handler] : postHandlers_)
         {
-            router->addPost(path, handler);
+            std::visit([&router, &path](const auto& fn) { router->addPost(path, fn); }, handler);
         }
         return router;
     }
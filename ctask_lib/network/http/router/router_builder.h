@@ -4,6 +4,7 @@
 #include "network/http/router/i_router.h"
 
 #include <memory>
+#include <variant>
 
 namespace ctask::network::http::router
 {
@@ -45,6 +46,24 @@ namespace ctask::network::http::router
          */
         RouterBuilder& registerPost(Types::HttpPath path, Types::HttpHandlerFn handler);
 
+        /**
+         * @brief Registers an awaitable handler for an HTTP GET path.
+         *
+         * @param path The path for which to register the handler.
+         * @param handler The coroutine to handle the request.
+         * @return RouterBuilder& instance.
+         */
+        RouterBuilder& registerGet(Types::HttpPath path, HttpAsyncHandlerFn handler);
+
+        /**
+         * @brief Registers an awaitable handler for an HTTP POST path.
+         *
+         * @param path The path for which to register the handler.
+         * @param handler The coroutine to handle the request.
+         * @return RouterBuilder& instance.
+         */
+        RouterBuilder& registerPost(Types::HttpPath path, HttpAsyncHandlerFn handler);
+
         /**
          *@brief Builds and returns a fully configured router.
          *
@@ -58,8 +77,10 @@ namespace ctask::network::http::router
         std::unique_ptr<IRouter> build();
 
     private:
-        std::unordered_map<Types::HttpPath, Types::HttpHandlerFn> getHandlers_;
-        std::unordered_map<Types::HttpPath, Types::HttpHandlerFn> postHandlers_;
+        using AnyHandlerFn = std::variant<Types::HttpHandlerFn, HttpAsyncHandlerFn>;
+
+        std::unordered_map<Types::HttpPath, AnyHandlerFn> getHandlers_;
+        std::unordered_map<Types::HttpPath, AnyHandlerFn> postHandlers_;
     };
 }
 
@@ -0,0 +1,70 @@
+#include "admission_control.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ctask::service
+{
+    static size_t limitOrUnlimited(size_t limit)
+    {
+        return limit == 0 ? std::numeric_limits<size_t>::max() : limit;
+    }
+
+    AdmissionControl::AdmissionControl(Types::AdmissionLimits limits, size_t workers) :
+        maxConnections_(limitOrUnlimited(limits.maxConnections)),
+        maxInFlightRequests_(limitOrUnlimited(limits.maxInFlightRequests)),
+        workers_(workers)
+    {
+        // the queue starts where the threads end, so its limit is just one more in-flight limit
+        if (limits.maxQueueDepth != 0)
+        {
+            maxInFlightRequests_ = std::min(maxInFlightRequests_, workers_ + limits.maxQueueDepth);
+        }
+    }
+
+    bool AdmissionControl::tryAdmitConnection() noexcept
+    {
+        return tryAcquire_(connections_, maxConnections_);
+    }
+
+    void AdmissionControl::releaseConnection() noexcept
+    {
+        connections_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool AdmissionControl::tryAdmitRequest() noexcept
+    {
+        return tryAcquire_(inFlightRequests_, maxInFlightRequests_);
+    }
+
+    void AdmissionControl::releaseRequest() noexcept
+    {
+        inFlightRequests_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    size_t AdmissionControl::connections() const noexcept
+    {
+        return connections_.load(std::memory_order_relaxed);
+    }
+
+    size_t AdmissionControl::inFlightRequests() const noexcept
+    {
+        return inFlightRequests_.load(std::memory_order_relaxed);
+    }
+
+    size_t AdmissionControl::queueDepth() const noexcept
+    {
+        const auto inFlight{inFlightRequests()};
+        return inFlight > workers_ ? inFlight - workers_ : 0;
+    }
+
+    bool AdmissionControl::tryAcquire_(std::atomic<size_t>& value, size_t limit) noexcept
+    {
+        if (value.fetch_add(1, std::memory_order_relaxed) < limit)
+        {
+            return true;
+        }
+        value.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+}
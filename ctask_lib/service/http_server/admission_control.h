@@ -0,0 +1,70 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include "utils/types/types.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace ctask::service
+{
+    namespace Types = utils::types;
+
+    /**
+     * @class AdmissionControl
+     * @brief Decides whether the server takes one more connection or request.
+     *
+     * Every request which is read and not answered yet is in flight, the ones over the amount of
+     * io threads can't be served right now and wait for a thread, that's the queue.
+     * Two request limits are there because they scale differently: maxInFlightRequests is absolute,
+     * maxQueueDepth follows the amount of threads, so the same config fits any machine.
+     *
+     * Admission is a single atomic increment, rolled back when the limit is exceeded,
+     * so concurrent admissions might reject a bit more than needed but never let more in.
+     */
+    class AdmissionControl final
+    {
+    public:
+        /**
+         * @param limits Configured limits, 0 means unlimited.
+         * @param workers Amount of io threads serving requests.
+         */
+        AdmissionControl(Types::AdmissionLimits limits, size_t workers);
+        ~AdmissionControl() = default;
+        AdmissionControl(const AdmissionControl&) = delete;
+        AdmissionControl& operator=(const AdmissionControl&) = delete;
+        AdmissionControl(AdmissionControl&&) = delete;
+        AdmissionControl& operator=(AdmissionControl&&) = delete;
+
+        /**
+         * @brief Takes a connection slot, every successful call must be paired with releaseConnection().
+         */
+        bool tryAdmitConnection() noexcept;
+        void releaseConnection() noexcept;
+
+        /**
+         * @brief Takes a request slot, every successful call must be paired with releaseRequest().
+         */
+        bool tryAdmitRequest() noexcept;
+        void releaseRequest() noexcept;
+
+        size_t connections() const noexcept;
+        size_t inFlightRequests() const noexcept;
+
+        /**
+         * @brief Admitted requests waiting for a free io thread.
+         */
+        size_t queueDepth() const noexcept;
+
+    private:
+        size_t maxConnections_;
+        size_t maxInFlightRequests_;
+        size_t workers_;
+        std::atomic<size_t> connections_{0};
+        std::atomic<size_t> inFlightRequests_{0};
+
+        static bool tryAcquire_(std::atomic<size_t>& value, size_t limit) noexcept;
+    };
+}
+
+#endif //ADMISSION_CONTROL_H
@@ -2,10 +2,16 @@
 #include <utils/misc/misc.h>
 #include "network/http/parser/json/http_parser.h"
 #include "network/http/response_serializer/json/response_serializer.h"
+#include "metrics/metrics_registry.h"
+#include "tracing/tracer.h"
+#include "utils/memory/connection_arena.h"
+#include "utils/concurrency/async_shared_mutex.h"
 #include "logger.h"
 
 #include <asio.hpp>
 
+#include <optional>
+
 namespace ctask::service
 {
     auto log{Logger::instance().getLogger()};
@@ -13,11 +19,79 @@ namespace ctask::service
     using namespace asio;
     using namespace asio::ip;
     using namespace ctask::utils::misc;
+    using namespace ctask::utils::memory;
     using namespace ctask::utils::constants;
     using namespace ctask::network::http::router;
     using namespace ctask::network::http::parser;
     using namespace ctask::network::http::response_serializer;
 
+    // per-connection scratch memory for a single request, fits a typical response,
+    // bigger ones borrow the rest from the heap
+    constexpr size_t SESSION_ARENA_LEN{8 * 1024};
+
+    // keep-alive deadlines are met with this precision, a round of the wheel covers a minute
+    constexpr std::chrono::milliseconds KEEP_ALIVE_TICK{250};
+    constexpr size_t KEEP_ALIVE_SLOTS{240};
+
+    // overloaded server asks clients to come back a bit later
+    constexpr const char* OVERLOAD_RETRY_AFTER_SEC{"1"};
+
+    /**
+     * @struct SessionMetrics
+     * @brief Server-wide connection and request metrics, registered on first use.
+     */
+    struct SessionMetrics
+    {
+        metrics::Counter& connections;
+        metrics::Gauge& activeConnections;
+        metrics::Counter& requests;
+        metrics::Counter& badRequests;
+        metrics::Counter& receivedBytes;
+        metrics::Counter& sentBytes;
+        metrics::Histogram& requestDuration;
+        metrics::Gauge& inFlightRequests;
+        metrics::Gauge& queueDepth;
+        metrics::Counter& rejectedConnections;
+        metrics::Counter& shedRequests;
+    };
+
+    /**
+     * @brief HTTP/1.1 connection is persistent unless the client says "close", HTTP/1.0 one only on demand.
+     */
+    static bool wantsPersistentConnection(const HttpRequest& request)
+    {
+        const auto it{request.headers.find(CONNECTION_HEADER)};
+        if (it != request.headers.end() && hasHeaderToken(it->second, CLOSE_CONNECTION))
+        {
+            return false;
+        }
+        if (request.version == "1.0")
+        {
+            return it != request.headers.end() && hasHeaderToken(it->second, KEEP_ALIVE_CONNECTION);
+        }
+        return true;
+    }
+
+    static SessionMetrics& sessionMetrics()
+    {
+        auto& registry{metrics::MetricsRegistry::instance()};
+        static SessionMetrics instance{
+            registry.counter("ctask_http_connections_total", "Accepted connections"),
+            registry.gauge("ctask_http_active_connections", "Currently open connections"),
+            registry.counter("ctask_http_requests_total", "Received requests"),
+            registry.counter("ctask_http_bad_requests_total", "Requests failed to parse"),
+            registry.counter("ctask_http_received_bytes_total", "Bytes read from clients"),
+            registry.counter("ctask_http_sent_bytes_total", "Bytes written to clients"),
+            registry.latencyHistogram("ctask_http_request_duration_seconds",
+                                      "Time from request read to response written"),
+            registry.gauge("ctask_http_in_flight_requests", "Requests read and not answered yet"),
+            registry.gauge("ctask_http_queue_depth", "In-flight requests waiting for a free io thread"),
+            registry.counter("ctask_http_rejected_connections_total", "Connections rejected over the limit"),
+            registry.counter("ctask_http_shed_requests_total", "Requests answered 503 without parsing"),
+        };
+        return instance;
+    }
+
 #ifdef IGNORE_ONE_INSTANCE_CREATION_POLICY
     std::shared_ptr<HttpServer> HttpServer::сreateService(io_service& ctx, HttpServerArgs serverArgs,
                                                           std::unique_ptr<IRouter> router)
@@ -25,7 +99,7 @@ namespace ctask::service
         return std::shared_ptr<HttpServer>(new HttpServer{
             ctx,
             std::move(serverArgs.address), serverArgs.port, serverArgs.threads, serverArgs.keepAliveSec,
-            std::move(router)
+            serverArgs.keepAliveMaxRequests, serverArgs.admission, std::move(router)
         });
     }
 #else
@@ -39,7 +113,7 @@ namespace ctask::service
         {
             server = std::shared_ptr<HttpServer>(new HttpServer{
                 ctx, std::move(serverArgs.address), serverArgs.port, serverArgs.threads, serverArgs.keepAliveSec,
-                std::move(router)
+                serverArgs.keepAliveMaxRequests, serverArgs.admission, std::move(router)
             });
         });
         return server;
@@ -47,11 +121,13 @@ namespace ctask::service
 #endif
 
     HttpServer::HttpServer(io_service& ctx, std::string address, uint16_t port, size_t threads, uint16_t keepAliveSec,
+                           size_t keepAliveMaxRequests, AdmissionLimits admission,
                            std::unique_ptr<IRouter> router) : ctxRef_(ctx),
-                                                              address_(std::move(address)), port_(port),
-                                                              threads_(threads), keepAliveSec_(keepAliveSec),
-                                                              threadPool_(threads_),
-                                                              router_(std::move(router))
+        address_(std::move(address)), port_(port),
+        threads_(threads), keepAliveSec_(keepAliveSec), keepAliveMaxRequests_(keepAliveMaxRequests),
+        threadPool_(threads_),
+        router_(std::move(router)),
+        admission_(admission, threads_)
     {
         if (router_ == nullptr)
         {
@@ -62,6 +138,27 @@ namespace ctask::service
         {
             throw std::invalid_argument("Keep-Alive must be greater than zero");
         }
+
+        // a shard per io thread, so sessions of different threads rarely meet on the same lock
+        keepAliveWheel_ = std::make_unique<KeepAliveWheel>(ctxRef_.get(), std::max<size_t>(threads_, 1),
+                                                           KEEP_ALIVE_TICK, KEEP_ALIVE_SLOTS);
+
+        JsonHttpResponseSerializer serializer;
+        HttpResponse overloaded{
+            HttpStatusCode::HTTP_STATUS_SERVICE_UNAVAILABLE, R"({"error":"Server is overloaded"})",
+            {{RETRY_AFTER_HEADER, OVERLOAD_RETRY_AFTER_SEC}}
+        };
+        requestShedResponse_ = serializer.serialize({overloaded, "1.1"});
+        connectionRejectedResponse_ = serializer.serialize({overloaded, "1.1", HttpKeepAlive{}});
+
+        // admission control counts requests anyway, the gauges are sampled from it on scrape
+        // instead of bouncing their cache lines between io threads on every request
+        metricsCollector_ = metrics::MetricsRegistry::instance().addCollector([this]()
+        {
+            auto& sessionStats{sessionMetrics()};
+            sessionStats.inFlightRequests.set(static_cast<int64_t>(admission_.inFlightRequests()));
+            sessionStats.queueDepth.set(static_cast<int64_t>(admission_.queueDepth()));
+        });
     }
 
     void HttpServer::start()
@@ -81,9 +178,16 @@ namespace ctask::service
             }
         });
 
+        keepAliveWheel_->start();
+
         for (size_t i = 0; i < threads_; ++i)
         {
-            post(threadPool_, [&]() { ctxRef_.get().run(); });
+            post(threadPool_, [&]()
+            {
+                // io threads never wait for the storage locks blocked, see AsyncSharedMutex
+                utils::concurrency::AsyncSharedMutex::NonBlockingThreadScope nonBlocking{};
+                ctxRef_.get().run();
+            });
         }
 
         threadPool_.join();
@@ -103,18 +207,25 @@ namespace ctask::service
 
     HttpServer::~HttpServer()
     {
+        metrics::MetricsRegistry::instance().removeCollector(metricsCollector_);
         stop();
     }
 
     awaitable<void> HttpServer::clientSession_(std::shared_ptr<tcp::socket> socket)
     {
-        log->info("Handle new client");
+        CTASK_LOG_DEBUG(log, "Handle new client");
+
+        auto& sessionStats{sessionMetrics()};
+        sessionStats.connections.inc();
+        sessionStats.activeConnections.add(1);
 
         std::array<char, 2048> readBuffer{};
         Defer closeSocketOnExit{
-            [socket]()
+            [this, socket, &sessionStats]()
             {
-                log->info("Close client's session");
+                CTASK_LOG_DEBUG(log, "Close client's session");
+                sessionStats.activeConnections.add(-1);
+                admission_.releaseConnection();
                 if (socket->is_open())
                 {
                     socket->close();
@@ -122,43 +233,40 @@ namespace ctask::service
             }
         };
 
-        auto keepAliveTimer = std::make_shared<steady_timer>(ctxRef_.get());
-
-        // since it's not possible to reset the timer obviously
-        // create lambda to reset it and spin up new async waiting ¯\_(ツ)_/¯
-        auto resetTimer = [socket, keepAliveTimer, alive = keepAliveSec_]()
-        {
-            keepAliveTimer->expires_after(std::chrono::seconds(alive));
-            keepAliveTimer->async_wait([socket, keepAliveTimer](const error_code& er)
+        // the wheel closes the socket once the connection is idle for longer than keep-alive,
+        // every request just moves the deadline, no timer is re-armed
+        auto keepAlive{
+            keepAliveWheel_->add(std::chrono::seconds(keepAliveSec_), [socket]()
             {
-                if (er == error::operation_aborted)
-                {
-                    return;
-                }
-
-                if (!er)
-                {
-                    log->warn("Keep-alive expired, close socket");
-                    socket->close();
-                }
-            });
+                CTASK_LOG_WARN(log, "Keep-alive expired, close socket");
+                error_code ec;
+                socket->close(ec);
+            })
+        };
+        auto resetTimer = [&keepAlive]()
+        {
+            keepAlive->refresh();
         };
 
-        // subscribe time resetter in event loop
-        post(ctxRef_.get(), resetTimer);
-
-        // stop timer in case the connection was closed by client
+        // forget the connection in case it was closed by client
         Defer cancelTimerOnExit{
-            [&keepAliveTimer]()
+            [&keepAlive]()
             {
-                keepAliveTimer->cancel();
+                keepAlive->cancel();
             }
         };
 
+        // parser and serializer keep no state between requests, so they live as long as the connection,
+        // the request and the response string are carved out of the arena which is wiped once the request is done
+        JsonHttpParser parser;
+        JsonHttpResponseSerializer responseGenerator;
+        ConnectionArena<SESSION_ARENA_LEN> arena{};
+        size_t servedRequests{0};
+
         for (;;)
         {
-            JsonHttpParser parser;
-            JsonHttpResponseSerializer responseGenerator;
+            // everything allocated from the arena belongs to the previous iteration and is gone already
+            arena.reset();
 
             resetTimer();
             error_code ec;
@@ -174,69 +282,233 @@ namespace ctask::service
             {
                 if (ec == error::eof)
                 {
-                    log->debug("Socket closed");
+                    CTASK_LOG_DEBUG(log, "Socket closed");
                     co_return;
                 }
-                log->error("Reading socket error : {}", ec.message());
+                CTASK_LOG_ERROR(log, "Reading socket error : {}", ec.message());
                 co_return;
             }
 
             size = std::min(size, readBuffer.size());
             if (size == 0)
             {
-                log->debug("End of session");
+                CTASK_LOG_DEBUG(log, "End of session");
                 co_return;
             }
 
-            HttpRequest request;
+            // the idle window is over, the deadline counts from the request, not from the previous one,
+            // so a request coming late in the window isn't closed in the middle of a slow handler
+            resetTimer();
+
+            const auto requestStart{std::chrono::steady_clock::now()};
+            sessionStats.requests.inc();
+            sessionStats.receivedBytes.inc(size);
+
+            // overloaded server doesn't even look into the request, the answer is prepared in advance
+            if (!admission_.tryAdmitRequest())
+            {
+                sessionStats.shedRequests.inc();
+                co_await async_write(*socket, buffer(requestShedResponse_), redirect_error(use_awaitable, ec));
+                if (ec)
+                {
+                    CTASK_LOG_ERROR(log, "Send overloaded response error : {}", ec.message());
+                    co_return;
+                }
+                sessionStats.sentBytes.inc(requestShedResponse_.size());
+                continue;
+            }
+            Defer releaseRequestOnExit{
+                [this]()
+                {
+                    admission_.releaseRequest();
+                }
+            };
+
+            // sampled requests record their stages, nested spans (parser, handler, storage) find
+            // the request through ActiveRequestScope, which must never live across co_await
+            tracing::RequestTrace trace{};
+
+            // the request lives in the arena, moving it into a default constructed one would copy
+            // everything to the heap, so it's constructed in place
+            std::optional<HttpRequest> request{};
             bool validRequest{true};
             std::string erroMessage{};
             try
             {
-                request = std::move(parser.parseRequest(std::string_view{readBuffer.data(), size}));
+                tracing::ActiveRequestScope activeRequest{trace.requestId()};
+                request.emplace(parser.parseRequest(std::string_view{readBuffer.data(), size}, arena.resource()));
             }
             catch (const std::exception& e)
             {
                 // can't use async in try/catch
                 validRequest = false;
                 erroMessage = e.what();
-                log->error("Parsing request error : {}", erroMessage);
+                CTASK_LOG_ERROR(log, "Parsing request error : {}", erroMessage);
             }
+            trace.mark("parse");
 
             if (!validRequest)
             {
-                HttpResponseMeta badRequestResp{{HttpStatusCode::HTTP_STATUS_BAD_REQUEST, erroMessage}, "1.1"};
-                auto serialized{responseGenerator.serialize(badRequestResp)};
-                co_await socket->async_write_some(buffer(serialized),
-                                                  redirect_error(use_awaitable, ec));
+                sessionStats.badRequests.inc();
+                HttpResponseMeta badRequestResp{
+                    {HttpStatusCode::HTTP_STATUS_BAD_REQUEST, erroMessage}, "1.1", HttpKeepAlive{}
+                };
+                std::pmr::string serialized{arena.resource()};
+                responseGenerator.serialize(badRequestResp, serialized);
+                sessionStats.sentBytes.inc(serialized.size());
+                co_await async_write(*socket, buffer(serialized), redirect_error(use_awaitable, ec));
 
                 if (ec)
                 {
-                    log->error("Send invalid request, write response error : {}", ec.message());
+                    CTASK_LOG_ERROR(log, "Send invalid request, write response error : {}", ec.message());
                 }
                 co_return;
             }
 
-            resetTimer();
-
-            HttpResponseMeta responseMeta{std::move(router_->route(request)), std::move(request.version)};
-            auto serialized{responseGenerator.serialize(responseMeta)};
-            co_await socket->async_write_some(buffer(serialized),
-                                              redirect_error(use_awaitable, ec));
+            // awaitable handlers suspend the session here, the io thread serves other connections meanwhile
+            // awaited apart from the braced init, GCC mishandles temporaries of co_await inside of it
+            auto response{co_await router_->asyncRoute(*request, trace.requestId())};
+            HttpResponseMeta responseMeta{std::move(response), std::string{request->version}};
+            trace.mark("route");
+
+            // HTTP/1.0 streamed body ends with the connection, so it can't be persistent;
+            // limited connection is closed by its last request, so a long-living client gets rebalanced sometimes
+            ++servedRequests;
+            const bool limited{keepAliveMaxRequests_ != 0};
+            const bool persistent{
+                (!limited || servedRequests < keepAliveMaxRequests_) && wantsPersistentConnection(*request) &&
+                !(responseMeta.payload.bodyStream && responseMeta.protocolVersion == "1.0")
+            };
+            responseMeta.keepAlive = HttpKeepAlive{
+                persistent, keepAliveSec_, limited ? keepAliveMaxRequests_ - servedRequests : 0
+            };
+
+            std::pmr::string serialized{arena.resource()};
+            responseGenerator.serialize(responseMeta, serialized);
+            trace.mark("serialize");
+
+            co_await async_write(*socket, buffer(serialized), redirect_error(use_awaitable, ec));
             if (ec)
             {
-                log->error("Send response error : {}", ec.message());
+                CTASK_LOG_ERROR(log, "Send response error : {}", ec.message());
                 co_return;
             }
+            sessionStats.sentBytes.inc(serialized.size());
+            trace.mark("write");
+
+            if (responseMeta.payload.bodyStream)
+            {
+                // HTTP/1.0 client has no idea about chunks, the end of body is the end of connection
+                const bool chunked{responseMeta.protocolVersion != "1.0"};
+                auto streamed{
+                    co_await writeBodyStream_(*socket, responseMeta.payload.bodyStream, responseGenerator, chunked,
+                                              resetTimer)
+                };
+                trace.mark("stream");
+                if (!streamed || !chunked)
+                {
+                    trace.finish();
+                    co_return;
+                }
+            }
+            sessionStats.requestDuration.observe(std::chrono::steady_clock::now() - requestStart);
+            trace.finish();
 
-            auto it{request.headers.find(CONNECTION_HEADER)};
-            if (it == request.headers.end() || it->second != KEEP_ALIVE_CONNECTION)
+            if (!persistent)
             {
                 co_return;
             }
         }
     }
 
+    awaitable<bool> HttpServer::writeBodyStream_(tcp::socket& socket, const HttpBodyStreamFn& bodyStream,
+                                                 IResponseSerializer& serializer, bool chunked,
+                                                 const std::function<void()>& onProgress)
+    {
+        auto& sentBytes{sessionMetrics().sentBytes};
+        std::string chunk{};
+        for (;;)
+        {
+            // pull the next piece only when the previous one is completely written,
+            // so the slow client holds back the producer instead of growing memory
+            chunk.clear();
+            bool hasChunk{false};
+            try
+            {
+                hasChunk = co_await bodyStream(chunk);
+            }
+            catch (const std::exception& e)
+            {
+                // headers are already sent, the only honest way to report an error is to break the connection
+                CTASK_LOG_ERROR(log, "Body stream error : {}", e.what());
+                co_return false;
+            }
+
+            if (hasChunk && chunk.empty())
+            {
+                // empty chunk terminates chunked body, nothing to send
+                continue;
+            }
+
+            error_code ec;
+            if (!hasChunk)
+            {
+                if (chunked)
+                {
+                    co_await async_write(socket, buffer(serializer.serializeChunk({})),
+                                         redirect_error(use_awaitable, ec));
+                }
+                if (ec)
+                {
+                    CTASK_LOG_ERROR(log, "Send last body chunk error : {}", ec.message());
+                    co_return false;
+                }
+                co_return true;
+            }
+
+            size_t written{0};
+            if (chunked)
+            {
+                written = co_await async_write(socket, buffer(serializer.serializeChunk(chunk)),
+                                               redirect_error(use_awaitable, ec));
+            }
+            else
+            {
+                written = co_await async_write(socket, buffer(chunk), redirect_error(use_awaitable, ec));
+            }
+            sentBytes.inc(written);
+
+            if (ec)
+            {
+                CTASK_LOG_ERROR(log, "Send body chunk error : {}", ec.message());
+                co_return false;
+            }
+
+            // client is alive and reading, long streams must not be cut by keep-alive timer
+            onProgress();
+        }
+    }
+
+    awaitable<void> HttpServer::rejectConnection_(tcp::socket socket)
+    {
+        CTASK_LOG_WARN(log, "Too many connections, reject client");
+
+        error_code ec;
+        co_await async_write(socket, buffer(connectionRejectedResponse_), redirect_error(use_awaitable, ec));
+        if (ec)
+        {
+            CTASK_LOG_DEBUG(log, "Send rejected connection response error : {}", ec.message());
+        }
+        else
+        {
+            sessionMetrics().sentBytes.inc(connectionRejectedResponse_.size());
+        }
+
+        // the request is never read, so let the response go first, otherwise close might reset the connection
+        socket.shutdown(tcp::socket::shutdown_send, ec);
+        socket.close(ec);
+    }
+
     awaitable<void> HttpServer::connectionHandler_(io_context& ctx, const std::string& address, port_type port)
     {
         tcp::endpoint endpoint(address::from_string(address), port);
@@ -247,7 +519,7 @@ namespace ctask::service
         acceptor.bind(endpoint);
         acceptor.listen(socket_base::max_listen_connections);
 
-        log->info("Listening on {}:{}", address, port);
+        CTASK_LOG_INFO(log, "Listening on {}:{}", address, port);
         for (;;)
         {
             try
@@ -255,12 +527,20 @@ namespace ctask::service
                 // wait for a client's connection
                 tcp::socket socket = co_await acceptor.async_accept(use_awaitable);
 
+                // connection slot is released by the session once it's over
+                if (!admission_.tryAdmitConnection())
+                {
+                    sessionMetrics().rejectedConnections.inc();
+                    co_spawn(ctx, rejectConnection_(std::move(socket)), detached);
+                    continue;
+                }
+
                 // client is connected, run client's session coroutine
                 co_spawn(ctx, clientSession_(std::make_shared<tcp::socket>(std::move(socket))), detached);
             }
             catch (const std::exception& e)
             {
-                log->error("Connection handler error : {}", e.what());
+                CTASK_LOG_ERROR(log, "Connection handler error : {}", e.what());
             }
         }
     }
@@ -2,8 +2,11 @@
 #define SERVER_H
 
 #include "service/i_service.h"
+#include "service/http_server/admission_control.h"
+#include "service/http_server/keep_alive_wheel.h"
 #include "utils/types/types.h"
 #include "network/http/router/i_router.h"
+#include "network/http/response_serializer/i_response_serializer.h"
 
 #include <asio.hpp>
 
@@ -11,6 +14,7 @@ namespace ctask::service
 {
     namespace Types = utils::types;
     namespace Router = network::http::router;
+    namespace Serializer = network::http::response_serializer;
 
 
     /**
@@ -74,19 +78,29 @@ namespace ctask::service
          * @param port Server port.
          * @param threads Number of worker threads.
          * @param keepAliveSec Keep-alive timeout in seconds.
+         * @param keepAliveMaxRequests Requests served by a persistent connection before it's closed, 0 - no limit.
+         * @param admission Overload protection limits.
          * @param router Router pointer.
          */
         explicit HttpServer(asio::io_service& ctx,
                             std::string address, uint16_t port, size_t threads, uint16_t keepAliveSec,
-                            std::unique_ptr<Router::IRouter> router);
+                            size_t keepAliveMaxRequests, Types::AdmissionLimits admission, std::unique_ptr<Router::IRouter> router);
 
         std::reference_wrapper<asio::io_service> ctxRef_;
         std::string address_{0};
         asio::ip::port_type port_{0};
         size_t threads_{0};
         uint16_t keepAliveSec_{0};
+        size_t keepAliveMaxRequests_{0};
         asio::thread_pool threadPool_;
         std::unique_ptr<Router::IRouter> router_{nullptr};
+        std::unique_ptr<KeepAliveWheel> keepAliveWheel_{nullptr};
+        AdmissionControl admission_;
+        uint64_t metricsCollector_{0};
+
+        // overload answers are always the same, so they are serialized once
+        std::string connectionRejectedResponse_{};
+        std::string requestShedResponse_{};
 
         /**
          * @brief Handles new incoming connections asynchronously.
@@ -108,6 +122,31 @@ namespace ctask::service
          * @param socket Pointer to the client socket.
          */
         asio::awaitable<void> clientSession_(std::shared_ptr<asio::ip::tcp::socket> socket);
+
+        /**
+         * @brief Answers 503 to a connection over the limit and closes it, nothing is read.
+         *
+         * @param socket Client socket.
+         */
+        asio::awaitable<void> rejectConnection_(asio::ip::tcp::socket socket);
+
+        /**
+         * @brief Writes a streamed response body.
+         *
+         * Pulls chunks from the body stream one by one and writes each of them before asking for the next,
+         * so the socket speed naturally throttles the producer (backpressure).
+         *
+         * @param socket Client socket, response headers are expected to be already written.
+         * @param bodyStream Body producer.
+         * @param serializer Serializer used to frame chunks.
+         * @param chunked Use chunked transfer encoding or write raw body (HTTP/1.0).
+         * @param onProgress Called after every written chunk, used to keep connection alive.
+         * @return true if the whole body was written.
+         */
+        asio::awaitable<bool> writeBodyStream_(asio::ip::tcp::socket& socket,
+                                               const Types::HttpBodyStreamFn& bodyStream,
+                                               Serializer::IResponseSerializer& serializer, bool chunked,
+                                               const std::function<void()>& onProgress);
     };
 }
 
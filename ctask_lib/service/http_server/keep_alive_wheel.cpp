@@ -0,0 +1,160 @@
+#include "keep_alive_wheel.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace ctask::service
+{
+    KeepAliveWheel::Entry::Entry(Clock::duration timeout, std::function<void()> onExpired) :
+        timeout_(timeout),
+        deadline_((Clock::now() + timeout).time_since_epoch().count()),
+        onExpired_(std::move(onExpired))
+    {
+    }
+
+    void KeepAliveWheel::Entry::refresh() noexcept
+    {
+        // the sweep reads it without any ordering requirements, the worst case is an extra round in the wheel
+        deadline_.store((Clock::now() + timeout_).time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void KeepAliveWheel::Entry::cancel() noexcept
+    {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    KeepAliveWheel::KeepAliveWheel(asio::io_context& ctx, size_t shards, Clock::duration tick, size_t slots) :
+        tick_(tick),
+        epoch_(Clock::now())
+    {
+        if (shards == 0 || slots == 0 || tick.count() <= 0)
+        {
+            throw std::invalid_argument("Keep-alive wheel shards, slots and tick must be positive");
+        }
+
+        shards_.reserve(shards);
+        for (size_t i{0}; i < shards; ++i)
+        {
+            shards_.emplace_back(std::make_unique<Shard>(ctx, slots));
+        }
+    }
+
+    void KeepAliveWheel::start()
+    {
+        for (auto& shard : shards_)
+        {
+            scheduleSweep_(*shard);
+        }
+    }
+
+    std::shared_ptr<KeepAliveWheel::Entry> KeepAliveWheel::add(Clock::duration timeout,
+                                                               std::function<void()> onExpired)
+    {
+        auto entry{std::make_shared<Entry>(timeout, std::move(onExpired))};
+        auto& shard{*shards_[nextShard_.fetch_add(1, std::memory_order_relaxed) % shards_.size()]};
+        insert_(shard, entry);
+        return entry;
+    }
+
+    size_t KeepAliveWheel::size()
+    {
+        size_t result{0};
+        for (auto& shard : shards_)
+        {
+            std::lock_guard lock{shard->mutex};
+            for (const auto& slot : shard->slots)
+            {
+                result += slot.size();
+            }
+        }
+        return result;
+    }
+
+    uint64_t KeepAliveWheel::tickOf_(Clock::rep deadline) const
+    {
+        // rounded up, so the slot is never swept before the deadline
+        const auto sinceEpoch{deadline - epoch_.time_since_epoch().count()};
+        if (sinceEpoch <= 0)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>((sinceEpoch + tick_.count() - 1) / tick_.count());
+    }
+
+    void KeepAliveWheel::insert_(Shard& shard, std::shared_ptr<Entry> entry)
+    {
+        const auto tick{tickOf_(entry->deadline_.load(std::memory_order_relaxed))};
+        std::lock_guard lock{shard.mutex};
+
+        // already swept ticks are never visited again, the next one takes care of late entries
+        const auto target{std::max(tick, shard.nextTick)};
+        shard.slots[target % shard.slots.size()].emplace_back(std::move(entry));
+    }
+
+    void KeepAliveWheel::scheduleSweep_(Shard& shard)
+    {
+        uint64_t nextTick{0};
+        {
+            std::lock_guard lock{shard.mutex};
+            nextTick = shard.nextTick;
+        }
+
+        shard.timer.expires_at(epoch_ + tick_ * nextTick);
+        shard.timer.async_wait([this, &shard](const asio::error_code& ec)
+        {
+            // the wheel might be already destroyed on abort, don't touch it
+            if (ec)
+            {
+                return;
+            }
+            sweep_(shard);
+            scheduleSweep_(shard);
+        });
+    }
+
+    void KeepAliveWheel::sweep_(Shard& shard)
+    {
+        const auto now{Clock::now()};
+        const auto currentTick{static_cast<uint64_t>((now - epoch_) / tick_)};
+
+        // take all due slots at once, if the sweep is late for a whole round every slot is due
+        auto& batch{shard.batch};
+        {
+            std::lock_guard lock{shard.mutex};
+            const auto slotsCount{static_cast<uint64_t>(shard.slots.size())};
+            const auto firstTick{std::max(shard.nextTick, currentTick >= slotsCount ? currentTick - slotsCount + 1 : 0)};
+            for (auto tick{firstTick}; tick <= currentTick; ++tick)
+            {
+                auto& slot{shard.slots[tick % slotsCount]};
+                std::move(slot.begin(), slot.end(), std::back_inserter(batch));
+                slot.clear();
+            }
+            shard.nextTick = std::max(shard.nextTick, currentTick + 1);
+        }
+
+        // callbacks are called without the lock, they are free to close sockets and register new connections
+        auto keep{batch.begin()};
+        for (auto& entry : batch)
+        {
+            if (entry->cancelled_.load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+            if (entry->deadline_.load(std::memory_order_relaxed) <= now.time_since_epoch().count())
+            {
+                entry->cancel();
+                entry->onExpired_();
+                continue;
+            }
+            // refreshed meanwhile
+            *keep++ = std::move(entry);
+        }
+
+        for (auto it{batch.begin()}; it != keep; ++it)
+        {
+            insert_(shard, std::move(*it));
+        }
+        batch.clear();
+    }
+}
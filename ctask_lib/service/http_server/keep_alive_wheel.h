@@ -0,0 +1,133 @@
+#ifndef KEEP_ALIVE_WHEEL_H
+#define KEEP_ALIVE_WHEEL_H
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ctask::service
+{
+    /**
+     * @class KeepAliveWheel
+     * @brief Hashed timer wheel of connection deadlines.
+     *
+     * Connections refresh their deadline on every request, so the refresh has to be dirt cheap:
+     * it's a single atomic store, no timer is cancelled or re-armed and no lock is taken.
+     * The wheel is swept tick by tick, the sweep looks at a single slot and handles all its
+     * connections in one batch:
+     * - the deadline has passed, the connection is expired;
+     * - the deadline was refreshed meanwhile, the connection is moved to the slot of the new deadline;
+     * - the connection is gone, it's dropped.
+     * So a busy connection is touched by the wheel once per timeout, not once per request.
+     *
+     * The wheel is split into shards, one per io thread, with a lock and a sweep timer of its own;
+     * connections are spread over shards round robin, so sweeps and registrations of different
+     * shards never meet.
+     */
+    class KeepAliveWheel final
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @class Entry
+         * @brief Deadline of a single connection, shared by the connection and the wheel.
+         */
+        class Entry
+        {
+        public:
+            /**
+             * @param timeout Time of inactivity after which the connection is expired.
+             * @param onExpired Called once from the sweep, when the deadline has passed, must not throw.
+             */
+            Entry(Clock::duration timeout, std::function<void()> onExpired);
+
+            /**
+             * @brief Moves the deadline to now + timeout.
+             */
+            void refresh() noexcept;
+
+            /**
+             * @brief Forgets the connection, it's never expired and is dropped by the next sweep of its slot.
+             */
+            void cancel() noexcept;
+
+        private:
+            friend class KeepAliveWheel;
+
+            Clock::duration timeout_;
+            std::atomic<Clock::rep> deadline_;
+            std::atomic<bool> cancelled_{false};
+            std::function<void()> onExpired_;
+        };
+
+        /**
+         * @param ctx IO context the sweeps run on.
+         * @param shards Amount of shards, usually the amount of io threads.
+         * @param tick Sweep period, deadlines are met with this precision.
+         * @param slots Amount of slots per shard, deadlines further than slots * tick make extra rounds.
+         *
+         * @throws std::invalid_argument If any of the values is zero.
+         */
+        KeepAliveWheel(asio::io_context& ctx, size_t shards, Clock::duration tick, size_t slots);
+        ~KeepAliveWheel() = default;
+        KeepAliveWheel(const KeepAliveWheel&) = delete;
+        KeepAliveWheel& operator=(const KeepAliveWheel&) = delete;
+        KeepAliveWheel(KeepAliveWheel&&) = delete;
+        KeepAliveWheel& operator=(KeepAliveWheel&&) = delete;
+
+        /**
+         * @brief Starts sweeping, sweeps go on while the context runs.
+         */
+        void start();
+
+        /**
+         * @brief Registers a connection with the deadline of now + timeout.
+         *
+         * @param timeout Time of inactivity after which the connection is expired.
+         * @param onExpired Called once from a sweep (any io thread), when the deadline has passed, must not throw.
+         * @return Entry to refresh the deadline with, must be cancelled when the connection is closed.
+         */
+        std::shared_ptr<Entry> add(Clock::duration timeout, std::function<void()> onExpired);
+
+        /**
+         * @brief Amount of registered connections, cancelled ones are counted until their slot is swept.
+         */
+        size_t size();
+
+    private:
+        /**
+         * @struct Shard
+         * @brief Part of the wheel with its own slots, lock and sweep timer.
+         */
+        struct Shard
+        {
+            Shard(asio::io_context& ctx, size_t slotsCount) : timer(ctx), slots(slotsCount)
+            {
+            }
+
+            asio::steady_timer timer;
+            std::mutex mutex;
+            std::vector<std::vector<std::shared_ptr<Entry>>> slots;
+            uint64_t nextTick{0}; // the first tick which is not swept yet
+            std::vector<std::shared_ptr<Entry>> batch{}; // swept slot, reused between sweeps
+        };
+
+        Clock::duration tick_;
+        Clock::time_point epoch_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        std::atomic<size_t> nextShard_{0};
+
+        uint64_t tickOf_(Clock::rep deadline) const;
+        void insert_(Shard& shard, std::shared_ptr<Entry> entry);
+        void scheduleSweep_(Shard& shard);
+        void sweep_(Shard& shard);
+    };
+}
+
+#endif //KEEP_ALIVE_WHEEL_H
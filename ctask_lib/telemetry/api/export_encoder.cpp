@@ -0,0 +1,112 @@
+#include "export_encoder.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace ctask::telemetry::api
+{
+    using namespace ctask::telemetry::core;
+
+    // binary format is declared as little-endian, so raw memory is just copied as is
+    static_assert(std::endian::native == std::endian::little, "Columnar export expects little-endian host");
+
+    template <size_t N>
+    void ExportEncoder::encode(ExportFormat format, const std::vector<BasicInteractionTimesEventModel<N>>& events,
+                               std::string& out)
+    {
+        if (events.empty())
+        {
+            return;
+        }
+
+        switch (format)
+        {
+        case ExportFormat::Ndjson:
+            encodeNdjson_(events, out);
+            break;
+        case ExportFormat::Columnar:
+            encodeColumnar_(events, out);
+            break;
+        }
+    }
+
+    const char* ExportEncoder::contentType(ExportFormat format)
+    {
+        return format == ExportFormat::Ndjson ? "application/x-ndjson" : "application/octet-stream";
+    }
+
+    template <size_t N>
+    void ExportEncoder::encodeNdjson_(const std::vector<BasicInteractionTimesEventModel<N>>& events, std::string& out)
+    {
+        // json library is way too slow for hundreds of MB, lines are simple enough to be printed by hand.
+        // Worst case line: {"date":<20 digits>,"values":[<11 chars> * N + commas]}\n
+        constexpr size_t maxLineSize{32 + 20 + N * 12};
+
+        auto offset{out.size()};
+        out.resize(offset + events.size() * maxLineSize);
+        char* pos{out.data() + offset};
+
+        auto put = [&pos](std::string_view str)
+        {
+            std::memcpy(pos, str.data(), str.size());
+            pos += str.size();
+        };
+
+        for (const auto& [date, values] : events)
+        {
+            put(R"({"date":)");
+            pos = std::to_chars(pos, pos + 20, date).ptr;
+            put(R"(,"values":[)");
+            for (size_t i{0}; i < values.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    *pos++ = ',';
+                }
+                pos = std::to_chars(pos, pos + 11, values[i]).ptr;
+            }
+            put("]}\n");
+        }
+
+        out.resize(pos - out.data());
+    }
+
+    template <size_t N>
+    void ExportEncoder::encodeColumnar_(const std::vector<BasicInteractionTimesEventModel<N>>& events, std::string& out)
+    {
+        const auto rows{static_cast<uint32_t>(events.size())};
+        const uint32_t valuesPerRow{N};
+
+        auto offset{out.size()};
+        out.resize(offset + 2 * sizeof(uint32_t) + rows * (sizeof(EventDateType) +
+            valuesPerRow * sizeof(InteractionTimeType)));
+        char* pos{out.data() + offset};
+
+        std::memcpy(pos, &rows, sizeof(rows));
+        pos += sizeof(rows);
+        std::memcpy(pos, &valuesPerRow, sizeof(valuesPerRow));
+        pos += sizeof(valuesPerRow);
+
+        for (const auto& event : events)
+        {
+            std::memcpy(pos, &event.date, sizeof(event.date));
+            pos += sizeof(event.date);
+        }
+
+        for (uint32_t column{0}; column < valuesPerRow; ++column)
+        {
+            for (const auto& event : events)
+            {
+                std::memcpy(pos, &event.values[column], sizeof(InteractionTimeType));
+                pos += sizeof(InteractionTimeType);
+            }
+        }
+    }
+
+#define CTASK_INSTANTIATE_EXPORT_ENCODER(len) \
+    template void ExportEncoder::encode<len>(ExportFormat, const std::vector<BasicInteractionTimesEventModel<len>>&, \
+                                             std::string&);
+    CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INSTANTIATE_EXPORT_ENCODER)
+#undef CTASK_INSTANTIATE_EXPORT_ENCODER
+}
@@ -0,0 +1,60 @@
+#ifndef TELEMETRY_EXPORT_ENCODER_H
+#define TELEMETRY_EXPORT_ENCODER_H
+
+#include "telemetry/core/models.h"
+
+#include <string>
+#include <vector>
+
+namespace ctask::telemetry::api
+{
+    /**
+     * @class ExportEncoder
+     * @brief Static utility class for encoding raw events into export wire formats.
+     *
+     * Both formats are appendable: every chunk of events is encoded independently,
+     * so a consumer can concatenate chunks of a streamed response without any framing knowledge.
+     *
+     * NDJSON: one {"date":<date>,"values":[...]} object per line.
+     *
+     * Binary columnar (little-endian), repeated block per chunk:
+     *  uint32 rows | uint32 valuesPerRow | uint64 date[rows] | int32 values[valuesPerRow][rows]
+     * i.e. every interaction step is a separate contiguous column, which is what analytic tools like the most.
+     */
+    class ExportEncoder
+    {
+    public:
+        ExportEncoder() = delete;
+        ExportEncoder(const ExportEncoder&) = delete;
+        ExportEncoder(ExportEncoder&&) = delete;
+        ExportEncoder& operator=(const ExportEncoder&) = delete;
+        ExportEncoder& operator=(ExportEncoder&&) = delete;
+        ~ExportEncoder() = delete;
+
+        /**
+         * @brief Appends encoded events to the output.
+         *
+         * @param format Export format.
+         * @param events Events to encode, valuesPerRow of the binary format is their length.
+         * @param out Output buffer, encoded data is appended.
+         */
+        template <size_t N>
+        static void encode(core::ExportFormat format,
+                           const std::vector<core::BasicInteractionTimesEventModel<N>>& events, std::string& out);
+
+        /**
+         * @brief Returns content type of the export format.
+         */
+        static const char* contentType(core::ExportFormat format);
+
+    private:
+        template <size_t N>
+        static void encodeNdjson_(const std::vector<core::BasicInteractionTimesEventModel<N>>& events, std::string& out);
+
+        template <size_t N>
+        static void encodeColumnar_(const std::vector<core::BasicInteractionTimesEventModel<N>>& events,
+                                    std::string& out);
+    };
+}
+
+#endif //TELEMETRY_EXPORT_ENCODER_H
@@ -1,10 +1,15 @@
 #include "routes.h"
+#include "export_encoder.h"
 #include "telemetry/dto/dto.h"
 #include "utils/types/types.h"
 #include "telemetry/core/misc.h"
 #include "telemetry/core/models.h"
 #include "telemetry/core/telemetry_storage.h"
+#include "telemetry/core/mean_length_cache.h"
+#include "telemetry/core/ingest_pipeline.h"
 #include "network/http/router/router_builder.h"
+#include "utils/types/constants.h"
+#include "utils/concurrency/compute_pool.h"
 
 #include <nlohmann/json.hpp>
 
@@ -15,21 +20,293 @@ namespace ctask::telemetry::api
     using namespace nlohmann;
     using namespace ctask::telemetry;
     using namespace ctask::utils::types;
+    using namespace ctask::utils::constants;
     using namespace ctask::network::http::router;
 
     auto log{Logger::instance().getLogger()};
 
-    void TelemetryRoutes::registerRoutes(RouterBuilder& builder, std::shared_ptr<core::TelemetryStorage> storage)
+    // amount of events copied from storage under a single entry lock during export,
+    // big enough to amortize locking and socket writes, small enough to not hold writers for long
+    constexpr size_t EXPORT_CHUNK_EVENTS{8192};
+
+    // upper bound of queries in a single batch request, keeps a single request from occupying the server
+    constexpr size_t MAX_BATCH_QUERIES{1024};
+
+    static core::MeanLengthQueryModel toMeanLengthQueryModel(const dto::MeanLengthQueryDto& dto)
+    {
+        return {
+            core::parseTimeUnit(dto.resultUnit),
+            dto.startTimestamp.value_or(0),
+            dto.endTimestamp.value_or(std::numeric_limits<uint64_t>::max())
+        };
+    }
+
+    template <size_t N>
+    static double queryMeanLength(core::BasicTelemetryStorage<N>& storage, core::MeanLengthCache* cache,
+                                  utils::concurrency::ComputePool* pool, std::string_view eventName,
+                                  const core::MeanLengthQueryModel& model)
     {
-        builder.registerGet("/paths/{event}/meanLength", [storage](const HttpRequest& req)
+        // huge events are summed in parallel on the pool, see TelemetryStorage::getEventPathLengthTotal
+        auto calculate = [&storage, pool, eventName, &model]()
+        {
+            return storage.getEventPathLengthTotal(eventName, model.startTimestamp, model.endTimestamp, pool)
+                          .mean(model.resultUnit);
+        };
+
+        // unknown event has nothing to cache
+        const auto eventId{cache != nullptr ? storage.findEventId(eventName) : std::nullopt};
+        if (!eventId)
+        {
+            return calculate();
+        }
+
+        core::MeanLengthCacheKey key{*eventId, model.startTimestamp, model.endTimestamp, model.resultUnit};
+
+        // version is taken before the storage is touched, events stored meanwhile
+        // can only make the cached value look older than it is, never fresher
+        const auto version{storage.getEventVersion(eventName)};
+        if (auto cached{cache->get(key)})
+        {
+            if (cached->version == version)
+            {
+                return cached->mean;
+            }
+
+            // fresh events outside of the range don't change the result, just move the entry to the new version
+            if (!storage.isRangeModifiedSince(eventName, cached->version, model.startTimestamp, model.endTimestamp))
+            {
+                cache->put(key, {cached->mean, version});
+                return cached->mean;
+            }
+        }
+
+        auto mean{calculate()};
+        cache->put(key, {mean, version});
+        return mean;
+    }
+
+    template <size_t N>
+    void TelemetryRoutes::registerRoutes(RouterBuilder& builder,
+                                         std::shared_ptr<core::BasicTelemetryStorage<N>> storage,
+                                         std::shared_ptr<utils::concurrency::ComputePool> computePool,
+                                         std::shared_ptr<core::MeanLengthCache> meanLengthCache,
+                                         std::type_identity_t<std::shared_ptr<core::BasicIngestPipeline<N>>> ingestPipeline)
+    {
+        // offloaded work refers to the handler's locals, the handler stays suspended until it's done
+
+        builder.registerGet("/paths/{event}/meanLength",
+                            [storage, computePool, meanLengthCache](const HttpRequest& req)
+                            -> asio::awaitable<HttpResponse>
         {
             try
             {
-                log->debug(std::format("Handle path : {}, body : {}", req.path, req.body));
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
 
                 auto meanLenDto{json::parse(req.body).get<dto::MeanLengthQueryDto>()};
                 auto it{req.parameters.find("event")};
                 if (it == req.parameters.end())
+                {
+                    co_return HttpResponse{
+                        HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
+                        json{{"error", "No event name"}}.dump()
+                    };
+                }
+
+                const auto model{toMeanLengthQueryModel(meanLenDto)};
+                double mean{
+                    co_await computePool->run([&]()
+                    {
+                        return queryMeanLength(*storage, meanLengthCache.get(), computePool.get(), it->second, model);
+                    })
+                };
+                co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, json{{"mean", mean}}.dump()};
+            }
+            catch (const std::exception& e)
+            {
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
+                co_return HttpResponse{
+                    HttpStatusCode::HTTP_STATUS_BAD_REQUEST, json{{"error", e.what()}}.dump()
+                };
+            }
+        });
+
+        builder.registerGet("/paths/meanLength/batch",
+                            [storage, computePool, meanLengthCache](const HttpRequest& req)
+                            -> asio::awaitable<HttpResponse>
+        {
+            try
+            {
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
+
+                auto batchDto{json::parse(req.body).get<std::vector<dto::MeanLengthBatchQueryDto>>()};
+                if (batchDto.size() > MAX_BATCH_QUERIES)
+                {
+                    co_return HttpResponse{
+                        HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
+                        json{{"error", std::format("Too many queries, max is {}", MAX_BATCH_QUERIES)}}.dump()
+                    };
+                }
+
+                // every query is independent, evaluate them on the compute pool and gather results in order,
+                // a broken query doesn't break the whole batch, its error is reported in place
+                std::vector<json> results(batchDto.size());
+                co_await computePool->run([&]()
+                {
+                    computePool->parallelFor(batchDto.size(), [&](size_t i)
+                    {
+                        const auto& [event, query]{batchDto[i]};
+                        try
+                        {
+                            auto mean{
+                                queryMeanLength(*storage, meanLengthCache.get(), computePool.get(), event,
+                                                toMeanLengthQueryModel(query))
+                            };
+                            results[i] = json{{"event", event}, {"mean", mean}};
+                        }
+                        catch (const std::exception& e)
+                        {
+                            results[i] = json{{"event", event}, {"error", e.what()}};
+                        }
+                    });
+                });
+
+                co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, json{{"results", std::move(results)}}.dump()};
+            }
+            catch (const std::exception& e)
+            {
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
+                co_return HttpResponse{
+                    HttpStatusCode::HTTP_STATUS_BAD_REQUEST, json{{"error", e.what()}}.dump()
+                };
+            }
+        });
+
+        builder.registerGet("/paths/{event}/percentiles",
+                            [storage, computePool](const HttpRequest& req) -> asio::awaitable<HttpResponse>
+        {
+            try
+            {
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
+
+                auto percentilesDto{json::parse(req.body).get<dto::PercentilesQueryDto>()};
+                auto it{req.parameters.find("event")};
+                if (it == req.parameters.end())
+                {
+                    co_return HttpResponse{
+                        HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
+                        json{{"error", "No event name"}}.dump()
+                    };
+                }
+
+                for (auto percentile : percentilesDto.percentiles)
+                {
+                    if (percentile < 0.0 || percentile > 100.0)
+                    {
+                        co_return HttpResponse{
+                            HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
+                            json{{"error", "Percentile must be in [0, 100] range"}}.dump()
+                        };
+                    }
+                }
+
+                core::PercentilesQueryModel model{
+                    core::parseTimeUnit(percentilesDto.resultUnit),
+                    percentilesDto.startTimestamp.value_or(0),
+                    percentilesDto.endTimestamp.value_or(std::numeric_limits<uint64_t>::max()),
+                    std::move(percentilesDto.percentiles)
+                };
+
+                auto sketch{
+                    co_await computePool->run([&]()
+                    {
+                        return storage->getEventSketch(it->second, model.startTimestamp, model.endTimestamp);
+                    })
+                };
+                const double unitScale{model.resultUnit == core::TimeUnit::Milliseconds ? 1000.0 : 1.0};
+
+                json percentiles = json::object();
+                for (auto percentile : model.percentiles)
+                {
+                    percentiles[std::format("p{}", percentile)] = sketch.quantile(percentile / 100.0) * unitScale;
+                }
+
+                co_return HttpResponse{
+                    HttpStatusCode::HTTP_STATUS_OK,
+                    json{{"count", sketch.count()}, {"percentiles", std::move(percentiles)}}.dump()
+                };
+            }
+            catch (const std::exception& e)
+            {
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
+                co_return HttpResponse{
+                    HttpStatusCode::HTTP_STATUS_BAD_REQUEST, json{{"error", e.what()}}.dump()
+                };
+            }
+        });
+
+        builder.registerGet("/paths/{event}/series",
+                            [storage, computePool](const HttpRequest& req) -> asio::awaitable<HttpResponse>
+        {
+            try
+            {
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
+
+                auto seriesDto{json::parse(req.body).get<dto::SeriesQueryDto>()};
+                auto it{req.parameters.find("event")};
+                if (it == req.parameters.end())
+                {
+                    co_return HttpResponse{
+                        HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
+                        json{{"error", "No event name"}}.dump()
+                    };
+                }
+
+                core::SeriesQueryModel model{
+                    core::parseTimeUnit(seriesDto.resultUnit),
+                    seriesDto.startTimestamp.value_or(0),
+                    seriesDto.endTimestamp.value_or(std::numeric_limits<uint64_t>::max()),
+                    seriesDto.interval
+                };
+
+                auto buckets{
+                    co_await computePool->run([&]()
+                    {
+                        return storage->getEventSeries(it->second, model.startTimestamp, model.endTimestamp,
+                                                       model.interval);
+                    })
+                };
+                const double unitScale{model.resultUnit == core::TimeUnit::Milliseconds ? 1000.0 : 1.0};
+
+                json series = json::array();
+                for (const auto& [bucketStart, totalPathLength, count] : buckets)
+                {
+                    series.push_back({
+                        {"bucketStart", bucketStart},
+                        {"mean", static_cast<double>(totalPathLength) / count * unitScale},
+                        {"count", count}
+                    });
+                }
+
+                co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, json{{"series", std::move(series)}}.dump()};
+            }
+            catch (const std::exception& e)
+            {
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
+                co_return HttpResponse{
+                    HttpStatusCode::HTTP_STATUS_BAD_REQUEST, json{{"error", e.what()}}.dump()
+                };
+            }
+        });
+
+        builder.registerGet("/paths/{event}/export", [storage](const HttpRequest& req)
+        {
+            try
+            {
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
+
+                auto exportDto{(req.body.empty() ? json::object() : json::parse(req.body)).get<dto::ExportQueryDto>()};
+                auto it{req.parameters.find("event")};
+                if (it == req.parameters.end())
                 {
                     return HttpResponse{
                         HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
@@ -37,40 +314,65 @@ namespace ctask::telemetry::api
                     };
                 }
 
-                core::MeanLengthQueryModel model{
-                    core::parseTimeUnit(meanLenDto.resultUnit),
-                    meanLenDto.startTimestamp.value_or(0),
-                    meanLenDto.endTimestamp.value_or(std::numeric_limits<uint64_t>::max())
+                core::ExportQueryModel model{
+                    core::parseExportFormat(exportDto.format),
+                    exportDto.startTimestamp.value_or(0),
+                    exportDto.endTimestamp.value_or(std::numeric_limits<uint64_t>::max())
                 };
 
-                auto interactions = storage->getEventInteractions(
-                    it->second,
-                    model.startTimestamp,
-                    model.endTimestamp
-                );
+                HttpResponse response{
+                    HttpStatusCode::HTTP_STATUS_OK, {},
+                    {{CONTENT_TYPE_HEADER, ExportEncoder::contentType(model.format)}}
+                };
+
+                // walk the range chunk by chunk, the storage is touched only when the client is ready for more data;
+                // the stream outlives the request and its memory, so the name is copied out.
+                // It's pulled on the io thread, a contended entry suspends it instead of blocking the thread
+                response.bodyStream = [storage, eventName = std::string{it->second}, model,
+                        events = std::vector<core::BasicInteractionTimesEventModel<N>>{}, finished = false
+                    ](std::string& chunk) mutable -> asio::awaitable<bool>
+                    {
+                        if (finished)
+                        {
+                            co_return false;
+                        }
+
+                        co_await storage->asyncGetEventEntries(eventName, model.startTimestamp, model.endTimestamp,
+                                                               EXPORT_CHUNK_EVENTS, events);
+                        if (events.empty())
+                        {
+                            co_return false;
+                        }
+
+                        const auto lastDate{events.back().date};
+                        finished = events.size() < EXPORT_CHUNK_EVENTS || lastDate >= model.endTimestamp;
+                        model.startTimestamp = lastDate + 1;
 
-                double mean{calculateMeanPathLength(interactions, model.resultUnit)};
-                return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, json{{"mean", mean}}.dump()};
+                        ExportEncoder::encode(model.format, events, chunk);
+                        co_return true;
+                    };
+                return response;
             }
             catch (const std::exception& e)
             {
-                log->error("Handler error, path : {}, error : {}", req.path, e.what());
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
                 return HttpResponse{
                     HttpStatusCode::HTTP_STATUS_BAD_REQUEST, json{{"error", e.what()}}.dump()
                 };
             }
         });
 
-        builder.registerPost("/paths/{event}", [storage](const HttpRequest& req)
+        builder.registerPost("/paths/{event}", [storage, ingestPipeline](const HttpRequest& req)
+                             -> asio::awaitable<HttpResponse>
         {
             try
             {
-                log->debug(std::format("Handle path : {}, body : {}", req.path, req.body));
+                CTASK_LOG_DEBUG(log, "Handle path : {}, body : {}", req.path, req.body);
                 auto eventDto{json::parse(req.body).get<dto::InteractionTimesEventDto>()};
 
-                if (eventDto.values.size() != core::INTERACTION_TIMES_LEN)
+                if (eventDto.values.size() != N)
                 {
-                    return HttpResponse{
+                    co_return HttpResponse{
                         HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
                         json{{"error", "Invalid values len"}}.dump()
                     };
@@ -79,27 +381,43 @@ namespace ctask::telemetry::api
                 auto it{req.parameters.find("event")};
                 if (it == req.parameters.end())
                 {
-                    return HttpResponse{
+                    co_return HttpResponse{
                         HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
                         json{{"error", "No event name"}}.dump()
                     };
                 }
 
-                core::InteractionTimesEventModel model{};
+                core::BasicInteractionTimesEventModel<N> model{};
                 model.date = eventDto.date;
                 std::copy(eventDto.values.begin(), eventDto.values.end(), model.values.begin());
 
-                storage->storeEvent(it->second, std::move(model));
-                return HttpResponse{HttpStatusCode::HTTP_STATUS_OK};
+                if (ingestPipeline)
+                {
+                    co_await ingestPipeline->asyncIngest(it->second, std::move(model));
+                    co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK};
+                }
+
+                // cheap, stays on the io thread, only a contended entry suspends it
+                co_await storage->asyncStoreEvent(it->second, std::move(model));
+                co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK};
             }
             catch (const std::exception& e)
             {
-                log->error("Handler error, path : {}, error : {}", req.path, e.what());
-                return HttpResponse{
+                CTASK_LOG_ERROR(log, "Handler error, path : {}, error : {}", req.path, e.what());
+                co_return HttpResponse{
                     HttpStatusCode::HTTP_STATUS_BAD_REQUEST,
                     json{{"error", e.what()}}.dump()
                 };
             }
         });
     }
+
+#define CTASK_INSTANTIATE_TELEMETRY_ROUTES(len) \
+    template void TelemetryRoutes::registerRoutes<len>(RouterBuilder&, \
+                                                       std::shared_ptr<core::BasicTelemetryStorage<len>>, \
+                                                       std::shared_ptr<utils::concurrency::ComputePool>, \
+                                                       std::shared_ptr<core::MeanLengthCache>, \
+                                                       std::shared_ptr<core::BasicIngestPipeline<len>>);
+    CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INSTANTIATE_TELEMETRY_ROUTES)
+#undef CTASK_INSTANTIATE_TELEMETRY_ROUTES
 }
@@ -1,11 +1,17 @@
 #ifndef TELEMETRY_ROUTES_H
 #define TELEMETRY_ROUTES_H
 
+#include <cstddef>
 #include <memory>
+#include <type_traits>
 
 namespace ctask::telemetry::core
 {
-    class TelemetryStorage;
+    template <size_t N>
+    class BasicTelemetryStorage;
+    class MeanLengthCache;
+    template <size_t N>
+    class BasicIngestPipeline;
 }
 
 namespace ctask::network::http::router
@@ -13,6 +19,11 @@ namespace ctask::network::http::router
     class RouterBuilder;
 }
 
+namespace ctask::utils::concurrency
+{
+    class ComputePool;
+}
+
 namespace ctask::telemetry::api
 {
     namespace Router = network::http::router;
@@ -25,6 +36,11 @@ namespace ctask::telemetry::api
      * Routes are registered via RouterBuilder, with handlers interacting
      * with TelemetryStorage.
      *
+     * Handlers are coroutines: queries are offloaded to the compute pool and the session resumes
+     * on its io thread with the result, ingest waits for a contended storage entry suspended
+     * or hands events over to the ingest pipeline. Export streams read the storage through its awaitable API,
+     * an io thread never waits for a storage entry lock blocked.
+     *
      * This class is non-instantiable and non-copyable.
      */
     class TelemetryRoutes
@@ -45,9 +61,20 @@ namespace ctask::telemetry::api
          *
          * @param builder Router builder instance for route registration.
          * @param storage Shared pointer to the telemetry storage instance.
+         * @param computePool Pool of heavy work, queries run there instead of the io threads.
+         * @param meanLengthCache Cache of meanLength results, nullptr to always query the storage.
+         * @param ingestPipeline Pipeline POST handlers queue events into, nullptr to store them in place.
+         *
+         * @tparam N Length of interaction times, POST handlers reject events of any other length.
+         *           Instantiated for CTASK_INTERACTION_TIMES_FAMILIES.
          */
+        template <size_t N>
         static void registerRoutes(Router::RouterBuilder& builder,
-                                   std::shared_ptr<core::TelemetryStorage> storage);
+                                   std::shared_ptr<core::BasicTelemetryStorage<N>> storage,
+                                   std::shared_ptr<utils::concurrency::ComputePool> computePool,
+                                   std::shared_ptr<core::MeanLengthCache> meanLengthCache = nullptr,
+                                   std::type_identity_t<std::shared_ptr<core::BasicIngestPipeline<N>>>
+                                   ingestPipeline = nullptr);
     };
 }
 
@@ -0,0 +1,174 @@
+#include "event_lsm_tree.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ctask::telemetry::core
+{
+    template <size_t N>
+    BasicEventLsmTree<N>::BasicEventLsmTree(size_t bufferCapacity) :
+        bufferCapacity_(bufferCapacity)
+    {
+        if (bufferCapacity == 0)
+        {
+            throw std::invalid_argument("Write buffer capacity must be greater than zero");
+        }
+    }
+
+    template <size_t N>
+    void BasicEventLsmTree<N>::insert(const Event& event)
+    {
+        // events arriving in order keep the buffer sorted, readers don't have to sort it then
+        if (!buffer_.empty() && event.date < buffer_.back().date)
+        {
+            bufferSorted_.store(false, std::memory_order_relaxed);
+        }
+        buffer_.push_back(event);
+
+        ++size_;
+        minDate_ = std::min(minDate_, event.date);
+        maxDate_ = std::max(maxDate_, event.date);
+
+        if (buffer_.size() >= bufferCapacity_)
+        {
+            sealBuffer();
+        }
+    }
+
+    template <size_t N>
+    void BasicEventLsmTree<N>::sealBuffer()
+    {
+        if (buffer_.empty())
+        {
+            return;
+        }
+
+        sortBuffer_();
+        const auto sealed{buffer_.size()};
+        runs_.push_back(std::make_shared<const Run>(std::move(buffer_)));
+
+        // the moved-from buffer has no memory, the next one is likely as big as this one
+        buffer_.clear();
+        buffer_.reserve(std::min(sealed, bufferCapacity_));
+    }
+
+    template <size_t N>
+    std::optional<typename BasicEventLsmTree<N>::Compaction> BasicEventLsmTree<N>::planCompaction() const
+    {
+        // the longest tail of runs which isn't less than half of the run before it
+        size_t first{runs_.size()};
+        size_t tailSize{0};
+        while (first > 0 && (first == runs_.size() || runs_[first - 1]->size() <= 2 * tailSize))
+        {
+            --first;
+            tailSize += runs_[first]->size();
+        }
+
+        if (runs_.size() - first < 2)
+        {
+            return std::nullopt;
+        }
+        return Compaction{first, {runs_.begin() + static_cast<ptrdiff_t>(first), runs_.end()}};
+    }
+
+    template <size_t N>
+    typename BasicEventLsmTree<N>::Run BasicEventLsmTree<N>::merge(const std::vector<RunPtr>& inputs)
+    {
+        size_t total{0};
+        std::vector<Events> sources{};
+        sources.reserve(inputs.size());
+        for (const auto& input : inputs)
+        {
+            total += input->size();
+            if (!input->empty())
+            {
+                sources.emplace_back(*input);
+            }
+        }
+
+        Run merged{};
+        merged.reserve(total);
+        mergeWalk_(sources, [&merged](const Event& event)
+        {
+            merged.push_back(event);
+            return true;
+        });
+        return merged;
+    }
+
+    template <size_t N>
+    bool BasicEventLsmTree<N>::installCompaction(const Compaction& compaction, Run merged)
+    {
+        if (compaction.first + compaction.inputs.size() > runs_.size() ||
+            !std::equal(compaction.inputs.begin(), compaction.inputs.end(),
+                        runs_.begin() + static_cast<ptrdiff_t>(compaction.first)))
+        {
+            return false;
+        }
+
+        const auto first{runs_.begin() + static_cast<ptrdiff_t>(compaction.first)};
+        *first = std::make_shared<const Run>(std::move(merged));
+        runs_.erase(first + 1, first + static_cast<ptrdiff_t>(compaction.inputs.size()));
+        return true;
+    }
+
+    template <size_t N>
+    size_t BasicEventLsmTree<N>::count(uint64_t from, uint64_t to) const
+    {
+        if (empty() || from > maxDate_ || to < minDate_)
+        {
+            return 0;
+        }
+
+        sortBuffer_();
+        size_t result{rangeOf_(buffer_, from, to).size()};
+        for (const auto& run : runs_)
+        {
+            result += rangeOf_(*run, from, to).size();
+        }
+        return result;
+    }
+
+    template <size_t N>
+    typename BasicEventLsmTree<N>::Events BasicEventLsmTree<N>::rangeOf_(Events sorted, uint64_t from, uint64_t to)
+    {
+        auto lower{std::lower_bound(sorted.begin(), sorted.end(), from,
+                                    [](const Event& event, uint64_t date)
+                                    {
+                                        return event.date < date;
+                                    })};
+        auto upper{std::upper_bound(lower, sorted.end(), to,
+                                    [](uint64_t date, const Event& event)
+                                    {
+                                        return date < event.date;
+                                    })};
+        return {lower, upper};
+    }
+
+    template <size_t N>
+    void BasicEventLsmTree<N>::sortBuffer_() const
+    {
+        if (bufferSorted_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        std::lock_guard lock{bufferSortMutex_};
+        if (bufferSorted_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // stable, events of a date keep their arrival order
+        std::stable_sort(buffer_.begin(), buffer_.end(),
+                         [](const Event& lhs, const Event& rhs)
+                         {
+                             return lhs.date < rhs.date;
+                         });
+        bufferSorted_.store(true, std::memory_order_release);
+    }
+
+#define CTASK_INSTANTIATE_EVENT_LSM_TREE(len) template class BasicEventLsmTree<len>;
+    CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INSTANTIATE_EVENT_LSM_TREE)
+#undef CTASK_INSTANTIATE_EVENT_LSM_TREE
+}
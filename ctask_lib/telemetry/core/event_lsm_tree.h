@@ -0,0 +1,284 @@
+#ifndef EVENT_LSM_TREE_H
+#define EVENT_LSM_TREE_H
+
+#include "models.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ctask::telemetry::core
+{
+    /**
+     * @class BasicEventLsmTree
+     * @brief Events of a single name kept as an append-only write buffer and immutable sorted runs.
+     *
+     * Inserts are appends to the buffer: a full buffer is sorted once and sealed into a run, so the cost
+     * of ordering is paid in bulk over contiguous memory instead of a tree insertion per event.
+     * Runs are never modified, compaction merges a few of them into a new one and swaps it in,
+     * so the heavy merge needs no lock at all (see planCompaction, merge and installCompaction).
+     * Runs are kept size-tiered: every run is more than twice as big as all runs after it together,
+     * so there are O(log n) of them and every event is merged O(log n) times.
+     *
+     * Events sharing a date are all kept: a run is a plain sorted array which may repeat a date, so a group
+     * of such events costs nothing but the events themselves (no per-event node as in std::multimap) and
+     * is read as a contiguous block. Events of a date keep their arrival order, sorting is stable and
+     * merges prefer older runs on ties. Unordered reads walk the runs and the buffer one by one,
+     * ordered reads merge them on the fly.
+     *
+     * Not synchronized, the owner locks: insert, sealBuffer and installCompaction exclusively,
+     * everything else shared. Readers sort an unsorted buffer in place under their own small mutex,
+     * the first reader after a write pays for it.
+     *
+     * @tparam N Length of interaction times, instantiated for CTASK_INTERACTION_TIMES_FAMILIES.
+     */
+    template <size_t N>
+    class BasicEventLsmTree
+    {
+    public:
+        using Event = BasicInteractionTimesEventModel<N>;
+        using Run = std::vector<Event>;
+        using RunPtr = std::shared_ptr<const Run>;
+
+        static constexpr size_t DEFAULT_BUFFER_CAPACITY{4096};
+
+        /**
+         * @struct Compaction
+         * @brief Runs [first, first + inputs.size()) to be merged into one.
+         */
+        struct Compaction
+        {
+            size_t first{0};
+            std::vector<RunPtr> inputs{};
+        };
+
+        /**
+         * @param bufferCapacity Events buffered before they're sealed into a run.
+         *
+         * @throws std::invalid_argument If bufferCapacity is zero.
+         */
+        explicit BasicEventLsmTree(size_t bufferCapacity = DEFAULT_BUFFER_CAPACITY);
+        ~BasicEventLsmTree() = default;
+        BasicEventLsmTree(const BasicEventLsmTree&) = delete;
+        BasicEventLsmTree& operator=(const BasicEventLsmTree&) = delete;
+        BasicEventLsmTree(BasicEventLsmTree&&) = delete;
+        BasicEventLsmTree& operator=(BasicEventLsmTree&&) = delete;
+
+        /**
+         * @brief Appends the event, seals the buffer when it's full.
+         */
+        void insert(const Event& event);
+
+        /**
+         * @brief Sorts the buffer and turns it into a run, the new buffer reserves as much as the sealed one had.
+         */
+        void sealBuffer();
+
+        /**
+         * @brief Picks the runs which break the size tiers.
+         *
+         * @return Runs to merge or std::nullopt if the tiers are fine.
+         */
+        std::optional<Compaction> planCompaction() const;
+
+        /**
+         * @brief Merges sorted runs into one, events of a date keep the order of inputs.
+         *
+         * Touches no state of the tree.
+         */
+        static Run merge(const std::vector<RunPtr>& inputs);
+
+        /**
+         * @brief Replaces the planned runs with the merged one.
+         *
+         * Runs sealed after the plan was made are kept, they're only ever appended.
+         *
+         * @return false if the planned runs are not there anymore, nothing is changed then.
+         */
+        bool installCompaction(const Compaction& compaction, Run merged);
+
+        /**
+         * @brief Calls fn(event) for every event within [from, to], in no particular order.
+         *
+         * Runs and the buffer are walked one by one without merging, cheaper than forEachOrdered.
+         */
+        template <typename Fn>
+        void forEach(uint64_t from, uint64_t to, Fn&& fn) const;
+
+        /**
+         * @brief Calls fn(event) for every event within [from, to] in date order, until fn returns false.
+         */
+        template <typename Fn>
+        void forEachOrdered(uint64_t from, uint64_t to, Fn&& fn) const;
+
+        /**
+         * @brief Counts events within [from, to], a pair of binary searches per run, nothing is walked.
+         */
+        size_t count(uint64_t from, uint64_t to) const;
+
+        size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // dates of the oldest and the newest events, meaningful only if not empty
+        EventDateType minDate() const noexcept { return minDate_; }
+        EventDateType maxDate() const noexcept { return maxDate_; }
+
+        size_t runs() const noexcept { return runs_.size(); }
+        size_t buffered() const noexcept { return buffer_.size(); }
+
+    private:
+        using Events = std::span<const Event>;
+
+        /**
+         * @brief Events of a sorted span within [from, to].
+         */
+        static Events rangeOf_(Events sorted, uint64_t from, uint64_t to);
+
+        /**
+         * @brief Calls fn(event) for every event of the sorted sources in date order, until fn returns false.
+         *
+         * Events of a date come out in the order of sources.
+         */
+        template <typename Fn>
+        static void mergeWalk_(std::vector<Events>& sources, Fn&& fn);
+
+        /**
+         * @brief Sorts the buffer if a write left it unsorted, safe for concurrent readers.
+         */
+        void sortBuffer_() const;
+
+        const size_t bufferCapacity_;
+        std::vector<RunPtr> runs_;
+
+        // sorted in place by readers
+        mutable std::vector<Event> buffer_;
+        mutable std::atomic<bool> bufferSorted_{true};
+        mutable std::mutex bufferSortMutex_;
+
+        size_t size_{0};
+        EventDateType minDate_{std::numeric_limits<EventDateType>::max()};
+        EventDateType maxDate_{0};
+    };
+
+    using EventLsmTree = BasicEventLsmTree<INTERACTION_TIMES_LEN>;
+
+    template <size_t N>
+    template <typename Fn>
+    void BasicEventLsmTree<N>::forEach(uint64_t from, uint64_t to, Fn&& fn) const
+    {
+        if (empty() || from > maxDate_ || to < minDate_)
+        {
+            return;
+        }
+
+        // another reader might be sorting the buffer right now, it can't be read as is
+        sortBuffer_();
+        for (const auto& run : runs_)
+        {
+            for (const auto& event : rangeOf_(*run, from, to))
+            {
+                fn(event);
+            }
+        }
+        for (const auto& event : rangeOf_(buffer_, from, to))
+        {
+            fn(event);
+        }
+    }
+
+    template <size_t N>
+    template <typename Fn>
+    void BasicEventLsmTree<N>::forEachOrdered(uint64_t from, uint64_t to, Fn&& fn) const
+    {
+        if (empty() || from > maxDate_ || to < minDate_)
+        {
+            return;
+        }
+
+        sortBuffer_();
+        std::vector<Events> sources{};
+        sources.reserve(runs_.size() + 1);
+        for (const auto& run : runs_)
+        {
+            if (auto events{rangeOf_(*run, from, to)}; !events.empty())
+            {
+                sources.push_back(events);
+            }
+        }
+        if (auto events{rangeOf_(buffer_, from, to)}; !events.empty())
+        {
+            sources.push_back(events);
+        }
+        mergeWalk_(sources, std::forward<Fn>(fn));
+    }
+
+    template <size_t N>
+    template <typename Fn>
+    void BasicEventLsmTree<N>::mergeWalk_(std::vector<Events>& sources, Fn&& fn)
+    {
+        // a handful of sources, a linear pick of the smallest head beats a heap
+        while (sources.size() > 1)
+        {
+            size_t smallest{0};
+            for (size_t i{1}; i < sources.size(); ++i)
+            {
+                if (sources[i].front().date < sources[smallest].front().date)
+                {
+                    smallest = i;
+                }
+            }
+            // sources before the smallest one have greater heads, ties with later ones go to the smallest
+            auto beforeBound{std::numeric_limits<EventDateType>::max()};
+            auto afterBound{std::numeric_limits<EventDateType>::max()};
+            for (size_t i{0}; i < sources.size(); ++i)
+            {
+                if (i < smallest)
+                {
+                    beforeBound = std::min(beforeBound, sources[i].front().date);
+                }
+                else if (i > smallest)
+                {
+                    afterBound = std::min(afterBound, sources[i].front().date);
+                }
+            }
+
+            // everything below the next smallest head goes out without another pick,
+            // runs of data arriving in order barely overlap
+            auto& source{sources[smallest]};
+            size_t taken{0};
+            while (taken < source.size() && source[taken].date < beforeBound && source[taken].date <= afterBound)
+            {
+                if (!fn(source[taken]))
+                {
+                    return;
+                }
+                ++taken;
+            }
+            source = source.subspan(taken);
+            if (source.empty())
+            {
+                // erased, not swapped with the last one, the order of sources breaks ties
+                sources.erase(sources.begin() + static_cast<ptrdiff_t>(smallest));
+            }
+        }
+
+        // the last source left is walked without comparisons
+        if (!sources.empty())
+        {
+            for (const auto& event : sources[0])
+            {
+                if (!fn(event))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+#endif //EVENT_LSM_TREE_H
@@ -0,0 +1,44 @@
+#include "event_name_table.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace ctask::telemetry::core
+{
+    std::optional<EventId> EventNameTable::find(std::string_view name) const
+    {
+        auto it{ids_.find(name)};
+        if (it == ids_.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    EventId EventNameTable::intern(std::string_view name)
+    {
+        if (auto it{ids_.find(name)}; it != ids_.end())
+        {
+            return it->second;
+        }
+
+        if (names_.size() >= std::numeric_limits<EventId>::max())
+        {
+            throw std::length_error("Too many distinct event names");
+        }
+
+        const auto id{static_cast<EventId>(names_.size())};
+        auto [it, inserted]{ids_.emplace(name, id)};
+        names_.emplace_back(it->first);
+        return id;
+    }
+
+    std::string_view EventNameTable::name(EventId id) const
+    {
+        if (id >= names_.size())
+        {
+            throw std::out_of_range("Unknown event id");
+        }
+        return names_[id];
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_EVENT_NAME_TABLE_H
+#define TELEMETRY_EVENT_NAME_TABLE_H
+
+#include "misc.h"
+#include "utils/types/types.h"
+
+#include <deque>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace ctask::telemetry::core
+{
+    /**
+     * @class EventNameTable
+     * @brief Interns event names, maps every distinct name to a dense id.
+     *
+     * Ids are handed out from 0 in order of appearance and never change, so per-event data
+     * can live in plain arrays indexed by id instead of hash maps keyed by strings.
+     * Every name is stored once, lookups hash the passed string_view and allocate nothing.
+     *
+     * Not thread-safe on purpose, the owner guards it together with whatever it indexes by id.
+     */
+    class EventNameTable
+    {
+    public:
+        EventNameTable() = default;
+        ~EventNameTable() = default;
+        EventNameTable(const EventNameTable&) = delete;
+        EventNameTable& operator=(const EventNameTable&) = delete;
+        EventNameTable(EventNameTable&&) = delete;
+        EventNameTable& operator=(EventNameTable&&) = delete;
+
+        /**
+         * @brief Looks the name up.
+         *
+         * @return Id of the name or std::nullopt if it was never interned.
+         */
+        std::optional<EventId> find(std::string_view name) const;
+
+        /**
+         * @brief Returns id of the name, interning it if needed.
+         *
+         * @throws std::length_error If ids are exhausted.
+         */
+        EventId intern(std::string_view name);
+
+        /**
+         * @brief Returns the name of an id, the view lives as long as the table.
+         *
+         * @throws std::out_of_range If the id is unknown.
+         */
+        std::string_view name(EventId id) const;
+
+        /**
+         * @brief Returns amount of interned names, all ids are below it.
+         */
+        size_t size() const noexcept { return names_.size(); }
+
+    private:
+        std::unordered_map<EventName, EventId, utils::types::StringHash, std::equal_to<>> ids_;
+
+        // views of ids_ keys, map nodes never move, so views stay valid on rehash
+        std::deque<std::string_view> names_;
+    };
+}
+
+#endif //TELEMETRY_EVENT_NAME_TABLE_H
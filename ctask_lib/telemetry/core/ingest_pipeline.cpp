@@ -0,0 +1,392 @@
+#include "ingest_pipeline.h"
+#include "telemetry_storage.h"
+#include "metrics/metrics_registry.h"
+#include "utils/misc/misc.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace ctask::telemetry::core
+{
+    namespace
+    {
+        // pipeline ids are never reused, so a stale thread-local entry of a destroyed pipeline is never matched
+        std::atomic<uint64_t> nextPipelineId{1};
+
+        struct ThreadProducer
+        {
+            uint64_t pipelineId{0};
+            void* producer{nullptr};
+        };
+
+        // a thread usually feeds a single pipeline, the linear search is one comparison
+        thread_local std::vector<ThreadProducer> threadProducers{};
+    }
+
+    IngestAck ingestAckFromString(const std::string& name)
+    {
+        if (name == "enqueued")
+        {
+            return IngestAck::ENQUEUED;
+        }
+        if (name == "applied")
+        {
+            return IngestAck::APPLIED;
+        }
+        throw std::invalid_argument("Unknown ingest ack: " + name);
+    }
+
+    template <size_t N>
+    BasicIngestPipeline<N>::BasicIngestPipeline(std::shared_ptr<BasicTelemetryStorage<N>> storage, IngestAck ack,
+                                                size_t writers, size_t queueCapacity,
+                                                std::chrono::milliseconds drainPeriod) :
+        id_(nextPipelineId.fetch_add(1, std::memory_order_relaxed)),
+        storage_(std::move(storage)),
+        ack_(ack),
+        writers_(std::max<size_t>(writers, 1)),
+        queueCapacity_(queueCapacity),
+        drainPeriod_(drainPeriod),
+        enqueuedTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_ingest_enqueued_events_total", "Events queued for the ingest writers")),
+        inlineTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_ingest_inline_events_total", "Events stored by the handler itself because its ring was full")),
+        batchesTotal_(metrics::MetricsRegistry::instance().counter(
+            "ctask_ingest_batches_total", "Batches stored by the ingest writers"))
+    {
+        if (queueCapacity == 0)
+        {
+            throw std::invalid_argument("Ingest queue capacity must be greater than zero");
+        }
+
+        writerThreads_.reserve(writers_);
+        for (size_t writer{0}; writer < writers_; ++writer)
+        {
+            writerThreads_.emplace_back([this, writer](std::stop_token stopToken)
+            {
+                writerRoutine_(writer, std::move(stopToken));
+            });
+        }
+    }
+
+    template <size_t N>
+    BasicIngestPipeline<N>::~BasicIngestPipeline()
+    {
+        for (auto& thread : writerThreads_)
+        {
+            thread.request_stop();
+        }
+        wakeWriters_();
+        writerThreads_.clear();
+
+        // whatever was queued after the last batch
+        for (size_t writer{0}; writer < writers_; ++writer)
+        {
+            WriterBuffers buffers{};
+            while (drainOnce_(writer, buffers))
+            {
+            }
+        }
+    }
+
+    template <size_t N>
+    asio::awaitable<void> BasicIngestPipeline<N>::asyncIngest(std::string_view eventName, Event event)
+    {
+        auto& producer{producer_()};
+
+        // the ticket is taken on the producing thread right when the event can't be queued,
+        // before the coroutine gets a chance to move to another thread
+        std::optional<std::pair<uint64_t, uint64_t>> inPlace{};
+        auto takeTicket = [&producer, &inPlace]()
+        {
+            inPlace.emplace(producer.nextTicket++, producer.pushed);
+        };
+
+        if (producer.nextTicket != producer.servedTickets.load(std::memory_order_acquire))
+        {
+            // events of the thread are being stored in place, this one must not overtake them
+            takeTicket();
+        }
+        else if (ack_ == IngestAck::ENQUEUED)
+        {
+            if (!tryEnqueue_(producer, eventName, event, {}))
+            {
+                takeTicket();
+            }
+        }
+        else
+        {
+            co_await asio::async_initiate<decltype(asio::use_awaitable), void()>(
+                [this, &producer, eventName, &event, &takeTicket](auto handler)
+                {
+                    // std::function needs a copyable target, the handler is move-only
+                    auto shared{std::make_shared<decltype(handler)>(std::move(handler))};
+                    if (!tryEnqueue_(producer, eventName, event, [shared]() { asio::post(std::move(*shared)); }))
+                    {
+                        takeTicket();
+                        asio::post(std::move(*shared));
+                    }
+                }, asio::use_awaitable);
+        }
+
+        if (inPlace)
+        {
+            co_await storeInPlace_(producer, inPlace->first, inPlace->second, eventName, std::move(event));
+        }
+    }
+
+    template <size_t N>
+    bool BasicIngestPipeline<N>::tryEnqueue(std::string_view eventName, const Event& event,
+                                            std::function<void()> applied)
+    {
+        auto& producer{producer_()};
+        if (producer.nextTicket != producer.servedTickets.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        return tryEnqueue_(producer, eventName, event, std::move(applied));
+    }
+
+    template <size_t N>
+    bool BasicIngestPipeline<N>::tryEnqueue_(Producer& producer, std::string_view eventName, const Event& event,
+                                             std::function<void()> applied)
+    {
+        const bool awaited{static_cast<bool>(applied)};
+        Item item{std::string{eventName}, event, std::move(applied)};
+        if (!producer.ring.tryPush(item))
+        {
+            return false;
+        }
+        ++producer.pushed;
+        enqueued_.fetch_add(1, std::memory_order_release);
+        enqueuedTotal_.inc();
+
+        if (awaited)
+        {
+            wakeWriters_();
+        }
+        return true;
+    }
+
+    template <size_t N>
+    asio::awaitable<void> BasicIngestPipeline<N>::storeInPlace_(Producer& producer, uint64_t ticket, uint64_t pushed,
+                                                                std::string_view eventName, Event event)
+    {
+        // the next ticket's turn comes even if the store throws
+        utils::misc::Defer serveTicketOnExit{
+            [&producer]()
+            {
+                producer.servedTickets.fetch_add(1, std::memory_order_release);
+                wakeInPlaceWaiters_(producer);
+            }
+        };
+
+        if (!isInPlaceTurn_(producer, ticket, pushed))
+        {
+            // the writer may sleep for the whole drain period, what the ring holds is needed right now
+            wakeWriters_();
+            co_await asio::async_initiate<decltype(asio::use_awaitable), void()>(
+                [&producer, ticket, pushed](auto handler)
+                {
+                    auto shared{std::make_shared<decltype(handler)>(std::move(handler))};
+                    std::function<void()> resume{[shared]() { asio::post(std::move(*shared)); }};
+                    {
+                        // the turn is checked again under the lock, whoever changes it wakes the waiters under it
+                        std::lock_guard lock{producer.waitersMutex};
+                        if (!isInPlaceTurn_(producer, ticket, pushed))
+                        {
+                            producer.waiters.push_back({ticket, pushed, std::move(resume)});
+                            return;
+                        }
+                    }
+                    resume();
+                }, asio::use_awaitable);
+        }
+
+        inlineTotal_.inc();
+        co_await storage_->asyncStoreEvent(eventName, std::move(event));
+    }
+
+    template <size_t N>
+    bool BasicIngestPipeline<N>::isInPlaceTurn_(const Producer& producer, uint64_t ticket, uint64_t pushed) noexcept
+    {
+        return producer.servedTickets.load(std::memory_order_acquire) == ticket &&
+            producer.applied.load(std::memory_order_acquire) >= pushed;
+    }
+
+    template <size_t N>
+    void BasicIngestPipeline<N>::wakeInPlaceWaiters_(Producer& producer)
+    {
+        std::vector<std::function<void()>> ready{};
+        {
+            std::lock_guard lock{producer.waitersMutex};
+            auto& waiters{producer.waiters};
+            for (auto it{waiters.begin()}; it != waiters.end();)
+            {
+                if (isInPlaceTurn_(producer, it->ticket, it->pushed))
+                {
+                    ready.push_back(std::move(it->resume));
+                    it = waiters.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        for (auto& resume : ready)
+        {
+            resume();
+        }
+    }
+
+    template <size_t N>
+    void BasicIngestPipeline<N>::flush()
+    {
+        const auto target{enqueued_.load(std::memory_order_acquire)};
+        wakeWriters_();
+
+        std::unique_lock lock{flushMutex_};
+        flushCv_.wait(lock, [this, target]() { return applied_.load(std::memory_order_acquire) >= target; });
+    }
+
+    template <size_t N>
+    typename BasicIngestPipeline<N>::Producer& BasicIngestPipeline<N>::producer_()
+    {
+        for (const auto& threadProducer : threadProducers)
+        {
+            if (threadProducer.pipelineId == id_)
+            {
+                return *static_cast<Producer*>(threadProducer.producer);
+            }
+        }
+
+        // the first event of the thread, the only time the producer takes a lock
+        std::lock_guard lock{ringsMutex_};
+        auto& producer{producers_.emplace_back(std::make_unique<Producer>(queueCapacity_))};
+        threadProducers.push_back({id_, producer.get()});
+        return *producer;
+    }
+
+    template <size_t N>
+    bool BasicIngestPipeline<N>::drainOnce_(size_t writer, WriterBuffers& buffers)
+    {
+        buffers.producers.clear();
+        {
+            std::lock_guard lock{ringsMutex_};
+            for (size_t i{writer}; i < producers_.size(); i += writers_)
+            {
+                buffers.producers.push_back(producers_[i].get());
+            }
+        }
+
+        // a batch takes at most a ring worth of items from every thread, nobody starves
+        buffers.batch.clear();
+        buffers.popped.assign(buffers.producers.size(), 0);
+        Item item{};
+        for (size_t p{0}; p < buffers.producers.size(); ++p)
+        {
+            auto& ring{buffers.producers[p]->ring};
+            for (size_t i{0}; i < ring.capacity() && ring.tryPop(item); ++i)
+            {
+                buffers.batch.push_back(std::move(item));
+                ++buffers.popped[p];
+            }
+        }
+
+        if (buffers.batch.empty())
+        {
+            return false;
+        }
+        apply_(buffers);
+
+        // events waiting to be stored in place behind the applied ones may go now
+        for (size_t p{0}; p < buffers.producers.size(); ++p)
+        {
+            if (buffers.popped[p] != 0)
+            {
+                buffers.producers[p]->applied.fetch_add(buffers.popped[p], std::memory_order_release);
+                wakeInPlaceWaiters_(*buffers.producers[p]);
+            }
+        }
+        return true;
+    }
+
+    template <size_t N>
+    void BasicIngestPipeline<N>::apply_(WriterBuffers& buffers)
+    {
+        auto& batch{buffers.batch};
+
+        // stable, so of the events with the same date the one which came first is still stored first
+        std::stable_sort(batch.begin(), batch.end(), [](const Item& lhs, const Item& rhs)
+        {
+            return std::tie(lhs.eventName, lhs.event.date) < std::tie(rhs.eventName, rhs.event.date);
+        });
+
+        for (auto groupBegin{batch.begin()}; groupBegin != batch.end();)
+        {
+            auto groupEnd{
+                std::find_if(groupBegin, batch.end(),
+                             [groupBegin](const Item& item) { return item.eventName != groupBegin->eventName; })
+            };
+
+            buffers.group.clear();
+            std::transform(groupBegin, groupEnd, std::back_inserter(buffers.group),
+                           [](const Item& item) { return item.event; });
+            storage_->storeEvents(groupBegin->eventName, buffers.group);
+            groupBegin = groupEnd;
+        }
+        batchesTotal_.inc();
+
+        for (auto& item : batch)
+        {
+            if (item.applied)
+            {
+                item.applied();
+            }
+        }
+
+        applied_.fetch_add(batch.size(), std::memory_order_release);
+        {
+            std::lock_guard lock{flushMutex_};
+        }
+        flushCv_.notify_all();
+    }
+
+    template <size_t N>
+    void BasicIngestPipeline<N>::wakeWriters_()
+    {
+        {
+            std::lock_guard lock{wakeMutex_};
+            ++wakeups_;
+        }
+        wakeCv_.notify_all();
+    }
+
+    template <size_t N>
+    void BasicIngestPipeline<N>::writerRoutine_(size_t writer, std::stop_token stopToken)
+    {
+        WriterBuffers buffers{};
+        uint64_t seenWakeups{0};
+        bool busy{false};
+        while (!stopToken.stop_requested())
+        {
+            if (!busy)
+            {
+                std::unique_lock lock{wakeMutex_};
+                wakeCv_.wait_for(lock, stopToken, drainPeriod_,
+                                 [this, seenWakeups]() { return wakeups_ != seenWakeups; });
+                seenWakeups = wakeups_;
+            }
+            busy = drainOnce_(writer, buffers);
+        }
+    }
+
+#define CTASK_INSTANTIATE_INGEST_PIPELINE(len) template class BasicIngestPipeline<len>;
+    CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INSTANTIATE_INGEST_PIPELINE)
+#undef CTASK_INSTANTIATE_INGEST_PIPELINE
+}
@@ -0,0 +1,264 @@
+#ifndef INGEST_PIPELINE_H
+#define INGEST_PIPELINE_H
+
+#include "models.h"
+#include "metrics/metrics.h"
+#include "utils/concurrency/spsc_ring.h"
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ctask::telemetry::core
+{
+    template <size_t N>
+    class BasicTelemetryStorage;
+
+    constexpr size_t DEFAULT_INGEST_WRITERS{1};
+    constexpr size_t DEFAULT_INGEST_QUEUE_CAPACITY{8192};
+    constexpr std::chrono::milliseconds DEFAULT_INGEST_DRAIN_PERIOD{1};
+
+    /**
+     * @enum IngestAck
+     * @brief When an ingested event is acknowledged to the client.
+     */
+    enum class IngestAck
+    {
+        ENQUEUED, // as soon as it's queued, a crash loses what is queued
+        APPLIED,  // once a writer has stored it, the handler waits suspended
+    };
+
+    /**
+     * @brief Parses "enqueued" or "applied".
+     *
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    IngestAck ingestAckFromString(const std::string& name);
+
+    /**
+     * @class BasicIngestPipeline
+     * @brief Moves storage writes off the io threads.
+     *
+     * Every producing thread pushes events into its own lock-free ring, the rings are spread over
+     * dedicated writer threads. A writer takes whatever its rings hold, sorts the batch by event name
+     * and date and stores every event name's group with storeEvents, so a single entry lock acquisition
+     * covers the whole group and the write buffer is filled in date order.
+     *
+     * Events of a single thread are applied in order, events of different threads race the same way
+     * concurrent requests do. An event which finds its ring full is stored in place, the same way as without
+     * the pipeline, but only once the writer has applied everything the thread queued before it: the coroutine
+     * waits suspended meanwhile, that's the backpressure of a full ring. Events of the thread coming while
+     * such a store is pending are stored in place as well, in the order they came (every one takes a ticket).
+     *
+     * Rings are created on the first event of a thread and live as long as the pipeline,
+     * the amount of threads in the service is fixed.
+     *
+     * @tparam N Length of interaction times, instantiated for CTASK_INTERACTION_TIMES_FAMILIES.
+     */
+    template <size_t N>
+    class BasicIngestPipeline
+    {
+    public:
+        using Event = BasicInteractionTimesEventModel<N>;
+
+        /**
+         * @param storage Storage the events are applied to.
+         * @param ack When the events are acknowledged.
+         * @param writers Amount of writer threads, at least one is started.
+         * @param queueCapacity Events per producing thread, rounded up to a power of two.
+         * @param drainPeriod How long an idle writer sleeps before it looks at its rings again.
+         *
+         * @throws std::invalid_argument If queueCapacity is zero.
+         */
+        explicit BasicIngestPipeline(std::shared_ptr<BasicTelemetryStorage<N>> storage,
+                                     IngestAck ack = IngestAck::ENQUEUED,
+                                     size_t writers = DEFAULT_INGEST_WRITERS,
+                                     size_t queueCapacity = DEFAULT_INGEST_QUEUE_CAPACITY,
+                                     std::chrono::milliseconds drainPeriod = DEFAULT_INGEST_DRAIN_PERIOD);
+
+        /**
+         * @brief Stops the writers and applies whatever is still queued.
+         */
+        ~BasicIngestPipeline();
+        BasicIngestPipeline(const BasicIngestPipeline&) = delete;
+        BasicIngestPipeline& operator=(const BasicIngestPipeline&) = delete;
+        BasicIngestPipeline(BasicIngestPipeline&&) = delete;
+        BasicIngestPipeline& operator=(BasicIngestPipeline&&) = delete;
+
+        /**
+         * @brief Ingests the event, resumes according to the ack mode.
+         *
+         * With ENQUEUED the coroutine isn't suspended at all unless the ring is full and the storage entry
+         * is contended, with APPLIED it resumes on its own executor once a writer has stored the event.
+         *
+         * @param eventName The name of the event, copied.
+         * @param event The event data.
+         */
+        asio::awaitable<void> asyncIngest(std::string_view eventName, Event event);
+
+        /**
+         * @brief Queues the event without waiting for anything.
+         *
+         * @param eventName The name of the event, copied.
+         * @param event The event data.
+         * @param applied Called by the writer once the event is stored, may be empty.
+         * @return false if the thread's ring is full or asyncIngest of the thread is storing in place,
+         *         nothing is queued then.
+         */
+        bool tryEnqueue(std::string_view eventName, const Event& event, std::function<void()> applied = {});
+
+        /**
+         * @brief Blocks until everything queued before the call is stored.
+         */
+        void flush();
+
+        IngestAck ack() const noexcept { return ack_; }
+
+    private:
+        /**
+         * @struct Item
+         * @brief Queued event, the name is owned, the request it came from is gone by the time it's applied.
+         */
+        struct Item
+        {
+            std::string eventName{};
+            Event event{};
+            std::function<void()> applied{};
+        };
+
+        using Ring = utils::concurrency::SpscRing<Item>;
+
+        /**
+         * @struct InPlaceWaiter
+         * @brief Event waiting for its turn to be stored in place.
+         */
+        struct InPlaceWaiter
+        {
+            uint64_t ticket{0};
+            uint64_t pushed{0};
+            std::function<void()> resume{};
+        };
+
+        /**
+         * @struct Producer
+         * @brief Ring of a producing thread and the order of its events stored in place.
+         *
+         * An event stored in place takes the next ticket and the amount of events pushed so far,
+         * its turn comes once the writer has applied that many and the tickets before it are served.
+         */
+        struct Producer
+        {
+            explicit Producer(size_t capacity) : ring(capacity)
+            {
+            }
+
+            Ring ring;
+
+            // touched by the producing thread only
+            uint64_t pushed{0};
+            uint64_t nextTicket{0};
+
+            std::atomic<uint64_t> applied{0};
+            std::atomic<uint64_t> servedTickets{0};
+
+            std::mutex waitersMutex;
+            std::vector<InPlaceWaiter> waiters;
+        };
+
+        /**
+         * @struct WriterBuffers
+         * @brief Buffers a writer reuses from batch to batch.
+         */
+        struct WriterBuffers
+        {
+            std::vector<Producer*> producers{};
+            std::vector<size_t> popped{};
+            std::vector<Item> batch{};
+            std::vector<Event> group{};
+        };
+
+        /**
+         * @brief Producer of the calling thread, created on its first event.
+         */
+        Producer& producer_();
+
+        /**
+         * @brief Pushes the item into the producer's ring, must be called by its thread.
+         */
+        bool tryEnqueue_(Producer& producer, std::string_view eventName, const Event& event,
+                         std::function<void()> applied);
+
+        /**
+         * @brief Waits for the turn of the ticket and stores the event in place, see InPlaceWaiter.
+         */
+        asio::awaitable<void> storeInPlace_(Producer& producer, uint64_t ticket, uint64_t pushed,
+                                            std::string_view eventName, Event event);
+
+        static bool isInPlaceTurn_(const Producer& producer, uint64_t ticket, uint64_t pushed) noexcept;
+
+        /**
+         * @brief Resumes the in-place waiters whose turn has come.
+         */
+        static void wakeInPlaceWaiters_(Producer& producer);
+
+        /**
+         * @brief Takes up to a ring worth of items from every ring of the writer and stores them.
+         *
+         * @return false if there was nothing to store.
+         */
+        bool drainOnce_(size_t writer, WriterBuffers& buffers);
+
+        /**
+         * @brief Stores the batch grouped by event name, calls applied callbacks after that.
+         */
+        void apply_(WriterBuffers& buffers);
+
+        /**
+         * @brief Makes sleeping writers look at their rings right away.
+         */
+        void wakeWriters_();
+
+        void writerRoutine_(size_t writer, std::stop_token stopToken);
+
+        const uint64_t id_;
+        const std::shared_ptr<BasicTelemetryStorage<N>> storage_;
+        const IngestAck ack_;
+        const size_t writers_;
+        const size_t queueCapacity_;
+        const std::chrono::milliseconds drainPeriod_;
+
+        // ring i is drained by writer i % writers_ only, so every ring has a single consumer
+        mutable std::mutex ringsMutex_;
+        std::vector<std::unique_ptr<Producer>> producers_;
+
+        std::atomic<uint64_t> enqueued_{0};
+        std::atomic<uint64_t> applied_{0};
+        std::mutex flushMutex_;
+        std::condition_variable_any flushCv_;
+
+        // idle writers sleep here, producers wake them only in APPLIED mode where somebody waits
+        std::mutex wakeMutex_;
+        std::condition_variable_any wakeCv_;
+        uint64_t wakeups_{0};
+
+        metrics::Counter& enqueuedTotal_;
+        metrics::Counter& inlineTotal_;
+        metrics::Counter& batchesTotal_;
+
+        // the last member, writers must stop before everything above goes away
+        std::vector<std::jthread> writerThreads_;
+    };
+
+    using IngestPipeline = BasicIngestPipeline<INTERACTION_TIMES_LEN>;
+}
+
+#endif //INGEST_PIPELINE_H
@@ -0,0 +1,99 @@
+#include "mean_length_cache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace ctask::telemetry::core
+{
+    MeanLengthCache::MeanLengthCache(size_t capacity, size_t shards)
+    {
+        if (capacity == 0 || shards == 0)
+        {
+            throw std::invalid_argument("Cache capacity and shards must be positive");
+        }
+
+        // tiny caches don't need many shards, every shard must be able to keep at least a single entry
+        shards = std::min(shards, capacity);
+        shardCapacity_ = (capacity + shards - 1) / shards;
+
+        shards_.reserve(shards);
+        for (size_t i{0}; i < shards; ++i)
+        {
+            shards_.emplace_back(std::make_unique<Shard>());
+        }
+    }
+
+    std::optional<MeanLengthCacheValue> MeanLengthCache::get(const MeanLengthCacheKey& key)
+    {
+        auto& shard{shardFor_(key)};
+        std::lock_guard lock(shard.mutex);
+
+        auto it{shard.index.find(key)};
+        if (it == shard.index.end())
+        {
+            return std::nullopt;
+        }
+
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->second;
+    }
+
+    void MeanLengthCache::put(const MeanLengthCacheKey& key, MeanLengthCacheValue value)
+    {
+        auto& shard{shardFor_(key)};
+        std::lock_guard lock(shard.mutex);
+
+        auto it{shard.index.find(key)};
+        if (it != shard.index.end())
+        {
+            it->second->second = value;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+
+        if (shard.lru.size() >= shardCapacity_)
+        {
+            // reuse the evicted node, no need to free and allocate it again
+            auto lastIt{std::prev(shard.lru.end())};
+            shard.index.erase(lastIt->first);
+            lastIt->first = key;
+            lastIt->second = value;
+            shard.lru.splice(shard.lru.begin(), shard.lru, lastIt);
+        }
+        else
+        {
+            shard.lru.emplace_front(key, value);
+        }
+        shard.index.emplace(key, shard.lru.begin());
+    }
+
+    size_t MeanLengthCache::size()
+    {
+        size_t result{0};
+        for (auto& shard : shards_)
+        {
+            std::lock_guard lock(shard->mutex);
+            result += shard->lru.size();
+        }
+        return result;
+    }
+
+    size_t MeanLengthCache::KeyHash::operator()(const MeanLengthCacheKey& key) const noexcept
+    {
+        // boost::hash_combine flavour
+        size_t seed{std::hash<EventId>{}(key.eventId)};
+        auto combine = [&seed](size_t value) { seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2); };
+        combine(std::hash<uint64_t>{}(key.startTimestamp));
+        combine(std::hash<uint64_t>{}(key.endTimestamp));
+        combine(static_cast<size_t>(key.resultUnit));
+        return seed;
+    }
+
+    MeanLengthCache::Shard& MeanLengthCache::shardFor_(const MeanLengthCacheKey& key)
+    {
+        // unordered_map of the shard picks buckets by the low bits, mix the high ones in to pick the shard
+        const auto hash{KeyHash{}(key)};
+        return *shards_[(hash >> 32 ^ hash) % shards_.size()];
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef TELEMETRY_MEAN_LENGTH_CACHE_H
+#define TELEMETRY_MEAN_LENGTH_CACHE_H
+
+#include "models.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace ctask::telemetry::core
+{
+    /**
+     * @struct MeanLengthCacheKey
+     * @brief Identity of a meanLength query, the event is referred by its storage id.
+     */
+    struct MeanLengthCacheKey
+    {
+        EventId eventId;
+        uint64_t startTimestamp;
+        uint64_t endTimestamp;
+        TimeUnit resultUnit;
+
+        bool operator==(const MeanLengthCacheKey&) const = default;
+    };
+
+    /**
+     * @struct MeanLengthCacheValue
+     * @brief Cached mean and event version it was calculated for.
+     */
+    struct MeanLengthCacheValue
+    {
+        double mean;
+        uint64_t version;
+    };
+
+    /**
+     * @class MeanLengthCache
+     * @brief Bounded thread-safe LRU cache of meanLength query results.
+     *
+     * Keys are spread over independent shards, each shard has its own mutex and LRU list,
+     * so concurrent lookups of different queries rarely meet on the same lock.
+     * The least recently used entry of a shard is evicted once the shard is full.
+     *
+     * Cache knows nothing about the storage, whether a cached value is still valid
+     * is decided by the caller with the help of the stored event version.
+     */
+    class MeanLengthCache
+    {
+    public:
+        /**
+         * @brief Default number of shards.
+         */
+        static constexpr size_t DEFAULT_SHARDS{16};
+
+        /**
+         * @param capacity Max number of cached queries, split evenly between shards.
+         * @param shards Number of shards.
+         *
+         * @throws std::invalid_argument If capacity or shards is zero.
+         */
+        explicit MeanLengthCache(size_t capacity, size_t shards = DEFAULT_SHARDS);
+        ~MeanLengthCache() = default;
+        MeanLengthCache(const MeanLengthCache&) = delete;
+        MeanLengthCache& operator=(const MeanLengthCache&) = delete;
+        MeanLengthCache(MeanLengthCache&&) = delete;
+        MeanLengthCache& operator=(MeanLengthCache&&) = delete;
+
+        /**
+         * @brief Looks the query up, found entry becomes the most recently used one.
+         *
+         * @return Cached value or std::nullopt on miss.
+         */
+        std::optional<MeanLengthCacheValue> get(const MeanLengthCacheKey& key);
+
+        /**
+         * @brief Inserts or overwrites cached value, evicting the least recently used entry if needed.
+         */
+        void put(const MeanLengthCacheKey& key, MeanLengthCacheValue value);
+
+        /**
+         * @brief Returns amount of cached entries.
+         */
+        size_t size();
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(const MeanLengthCacheKey& key) const noexcept;
+        };
+
+        using LruList = std::list<std::pair<MeanLengthCacheKey, MeanLengthCacheValue>>;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            LruList lru;
+            std::unordered_map<MeanLengthCacheKey, LruList::iterator, KeyHash> index;
+        };
+
+        size_t shardCapacity_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        Shard& shardFor_(const MeanLengthCacheKey& key);
+    };
+}
+
+#endif //TELEMETRY_MEAN_LENGTH_CACHE_H
@@ -6,7 +6,19 @@
 #include <vector>
 #include <numeric>
 #include <cstdint>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Lengths of interaction times vectors (funnel steps) the telemetry is compiled for.
+ *
+ * X(len) is expanded for every family: storage, its LSM tree, ingest pipeline, export encoder and routes
+ * are explicitly instantiated per family, withInteractionTimesFamily dispatches a runtime length to them.
+ * Adding a length here is all it takes to serve another family.
+ */
+#define CTASK_INTERACTION_TIMES_FAMILIES(X) X(5) X(10) X(32)
 
 namespace ctask::telemetry::core
 {
@@ -15,15 +27,45 @@ namespace ctask::telemetry::core
      *
      */
 
-    constexpr uint8_t INTERACTION_TIMES_LEN{10};
+    // the default family, the one the service runs unless configured otherwise
+    constexpr size_t INTERACTION_TIMES_LEN{10};
 
     using EventDateType = uint64_t;
     using InteractionTimeType = int32_t;
 
-    using InteractionTimesCollection = std::array<InteractionTimeType, INTERACTION_TIMES_LEN>;
+    template <size_t N>
+    using InteractionTimes = std::array<InteractionTimeType, N>;
+
+    using InteractionTimesCollection = InteractionTimes<INTERACTION_TIMES_LEN>;
+
+#define CTASK_INTERACTION_TIMES_FAMILY_LEN(len) size_t{len},
+    constexpr std::array INTERACTION_TIMES_FAMILIES{CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INTERACTION_TIMES_FAMILY_LEN)};
+#undef CTASK_INTERACTION_TIMES_FAMILY_LEN
+
+    /**
+     * @brief Calls fn(std::integral_constant<size_t, len>{}) for a registered family length.
+     *
+     * @return What fn returns.
+     * @throws std::invalid_argument If there's no such family.
+     */
+    template <typename Fn>
+    decltype(auto) withInteractionTimesFamily(size_t len, Fn&& fn)
+    {
+        switch (len)
+        {
+#define CTASK_INTERACTION_TIMES_FAMILY_CASE(len) case len: return fn(std::integral_constant<size_t, len>{});
+            CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INTERACTION_TIMES_FAMILY_CASE)
+#undef CTASK_INTERACTION_TIMES_FAMILY_CASE
+        default:
+            throw std::invalid_argument("Unsupported interaction times length: " + std::to_string(len));
+        }
+    }
 
     using EventName = std::string;
 
+    // dense id of an interned event name, ids go from 0 in order of appearance
+    using EventId = uint32_t;
+
     enum class TimeUnit
     {
         Seconds,
@@ -44,8 +86,52 @@ namespace ctask::telemetry::core
         throw std::invalid_argument("Invalid time unit");
     };
 
-    inline double calculateMeanPathLength(
-        const std::vector<InteractionTimesCollection>& interactions,
+    enum class ExportFormat
+    {
+        Ndjson,
+        Columnar
+    };
+
+    inline ExportFormat parseExportFormat(const std::string& str)
+    {
+        if (str == "ndjson")
+        {
+            return ExportFormat::Ndjson;
+        }
+        if (str == "binary")
+        {
+            return ExportFormat::Columnar;
+        }
+
+        throw std::invalid_argument("Invalid export format");
+    };
+
+    /**
+     * @brief Path length of a single event, the total of its interaction times.
+     *
+     * The length is known at compile time, the sum is a fold without a loop, so short vectors
+     * turn into a few straight additions and long ones into vector instructions.
+     */
+    template <size_t N>
+    int64_t calculatePathLength(const InteractionTimes<N>& interaction)
+    {
+        return [&interaction]<size_t... I>(std::index_sequence<I...>)
+        {
+            return (int64_t{0} + ... + int64_t{interaction[I]});
+        }(std::make_index_sequence<N>{});
+    }
+
+    /**
+     * @brief Path length of interaction times of any length, for vectors not backed by a family.
+     */
+    inline int64_t calculatePathLength(std::span<const InteractionTimeType> interaction)
+    {
+        return std::accumulate(interaction.begin(), interaction.end(), int64_t{0});
+    }
+
+    template <size_t N>
+    double calculateMeanPathLength(
+        const std::vector<InteractionTimes<N>>& interactions,
         TimeUnit unit = TimeUnit::Seconds
     )
     {
@@ -54,10 +140,10 @@ namespace ctask::telemetry::core
             return 0.0;
         }
 
-        uint64_t totalTime{0};
+        int64_t totalTime{0};
         for (const auto& interaction : interactions)
         {
-            totalTime += std::accumulate(interaction.begin(), interaction.end(), 0);
+            totalTime += calculatePathLength(interaction);
         }
 
         double mean = static_cast<double>(totalTime) / interactions.size();
@@ -4,21 +4,27 @@
 #include "misc.h"
 
 #include <array>
+#include <vector>
 
 namespace ctask::telemetry::core
 {
     /**
-     * @struct InteractionTimesEventModel
+     * @struct BasicInteractionTimesEventModel
      * @brief Validated model for storing interaction times events.
      *
      * Ensures correctness and is ready for processing.
+     *
+     * @tparam N Length of interaction times, one of CTASK_INTERACTION_TIMES_FAMILIES.
      */
-    struct InteractionTimesEventModel
+    template <size_t N>
+    struct BasicInteractionTimesEventModel
     {
         EventDateType date{};
-        std::array<InteractionTimeType, INTERACTION_TIMES_LEN> values{};
+        InteractionTimes<N> values{};
     };
 
+    using InteractionTimesEventModel = BasicInteractionTimesEventModel<INTERACTION_TIMES_LEN>;
+
     /**
      * @struct MeanLengthQueryModel
      * @brief Validated model for querying mean interaction length.
@@ -31,6 +37,88 @@ namespace ctask::telemetry::core
         uint64_t startTimestamp;
         uint64_t endTimestamp;
     };
+
+    /**
+     * @struct PercentilesQueryModel
+     * @brief Validated model for querying path length percentiles.
+     *
+     * Ensures correctness and is ready for processing.
+     */
+    struct PercentilesQueryModel
+    {
+        TimeUnit resultUnit;
+        uint64_t startTimestamp;
+        uint64_t endTimestamp;
+        std::vector<double> percentiles;
+    };
+
+    /**
+     * @struct SeriesQueryModel
+     * @brief Validated model for querying mean path length per time bucket.
+     *
+     * Ensures correctness and is ready for processing.
+     */
+    struct SeriesQueryModel
+    {
+        TimeUnit resultUnit;
+        uint64_t startTimestamp;
+        uint64_t endTimestamp;
+        uint64_t interval;
+    };
+
+    /**
+     * @struct PathLengthSeriesBucket
+     * @brief Sum and count of path lengths within a single time bucket.
+     */
+    struct PathLengthSeriesBucket
+    {
+        EventDateType bucketStart{};
+        int64_t totalPathLength{};
+        uint64_t count{};
+    };
+
+    /**
+     * @struct PathLengthTotal
+     * @brief Sum and count of path lengths within a time range, partial totals of sub-ranges just add up.
+     */
+    struct PathLengthTotal
+    {
+        int64_t totalPathLength{};
+        uint64_t count{};
+
+        PathLengthTotal& operator+=(const PathLengthTotal& other) noexcept
+        {
+            totalPathLength += other.totalPathLength;
+            count += other.count;
+            return *this;
+        }
+
+        /**
+         * @brief Mean path length, the same value calculateMeanPathLength gives for the range.
+         */
+        double mean(TimeUnit unit = TimeUnit::Seconds) const noexcept
+        {
+            if (count == 0)
+            {
+                return 0.0;
+            }
+            const double value{static_cast<double>(totalPathLength) / count};
+            return unit == TimeUnit::Milliseconds ? value * 1000.0 : value;
+        }
+    };
+
+    /**
+     * @struct ExportQueryModel
+     * @brief Validated model for raw events export.
+     *
+     * Ensures correctness and is ready for processing.
+     */
+    struct ExportQueryModel
+    {
+        ExportFormat format;
+        uint64_t startTimestamp;
+        uint64_t endTimestamp;
+    };
 }
 
 #endif //TELEMETRY_MODEL_H
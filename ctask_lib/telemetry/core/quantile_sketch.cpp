@@ -0,0 +1,145 @@
+#include "quantile_sketch.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace ctask::telemetry::core
+{
+    // values closer to zero than that are counted as zeros
+    constexpr double MIN_INDEXABLE_VALUE{1e-9};
+
+    QuantileSketch::QuantileSketch(double relativeAccuracy)
+    {
+        if (relativeAccuracy <= 0.0 || relativeAccuracy >= 1.0)
+        {
+            throw std::invalid_argument("Relative accuracy must be in (0, 1) range");
+        }
+        gamma_ = (1.0 + relativeAccuracy) / (1.0 - relativeAccuracy);
+        logGamma_ = std::log(gamma_);
+    }
+
+    void QuantileSketch::add(double value)
+    {
+        if (value > MIN_INDEXABLE_VALUE)
+        {
+            positive_.add(index_(value), 1);
+        }
+        else if (value < -MIN_INDEXABLE_VALUE)
+        {
+            negative_.add(index_(-value), 1);
+        }
+        else
+        {
+            ++zeroCount_;
+        }
+        ++count_;
+    }
+
+    void QuantileSketch::merge(const QuantileSketch& other)
+    {
+        if (other.gamma_ != gamma_)
+        {
+            throw std::invalid_argument("Can't merge sketches with different accuracy");
+        }
+
+        positive_.merge(other.positive_);
+        negative_.merge(other.negative_);
+        zeroCount_ += other.zeroCount_;
+        count_ += other.count_;
+    }
+
+    double QuantileSketch::quantile(double q) const
+    {
+        if (q < 0.0 || q > 1.0)
+        {
+            throw std::invalid_argument("Quantile must be in [0, 1] range");
+        }
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+
+        // rank of the wanted value, values are ordered as: negatives (biggest magnitude first), zeros, positives
+        const auto rank{static_cast<uint64_t>(q * static_cast<double>(count_ - 1))};
+        uint64_t seen{0};
+
+        for (size_t i{negative_.counts.size()}; i > 0; --i)
+        {
+            seen += negative_.counts[i - 1];
+            if (seen > rank)
+            {
+                return -value_(negative_.offset + static_cast<int32_t>(i - 1));
+            }
+        }
+
+        seen += zeroCount_;
+        if (seen > rank)
+        {
+            return 0.0;
+        }
+
+        for (size_t i{0}; i < positive_.counts.size(); ++i)
+        {
+            seen += positive_.counts[i];
+            if (seen > rank)
+            {
+                return value_(positive_.offset + static_cast<int32_t>(i));
+            }
+        }
+
+        // unreachable while counters are consistent
+        return value_(positive_.offset + static_cast<int32_t>(positive_.counts.size()) - 1);
+    }
+
+    int32_t QuantileSketch::index_(double value) const
+    {
+        return static_cast<int32_t>(std::ceil(std::log(value) / logGamma_));
+    }
+
+    double QuantileSketch::value_(int32_t index) const
+    {
+        // middle of the bin in terms of relative error
+        return 2.0 * std::pow(gamma_, index) / (gamma_ + 1.0);
+    }
+
+    void QuantileSketch::Bins::add(int32_t index, uint64_t count)
+    {
+        if (counts.empty())
+        {
+            offset = index;
+            counts.push_back(count);
+            return;
+        }
+
+        if (index < offset)
+        {
+            // grow to the left
+            counts.insert(counts.begin(), static_cast<size_t>(offset - index), 0);
+            offset = index;
+        }
+        else if (static_cast<size_t>(index - offset) >= counts.size())
+        {
+            // grow to the right
+            counts.resize(static_cast<size_t>(index - offset) + 1, 0);
+        }
+        counts[static_cast<size_t>(index - offset)] += count;
+    }
+
+    void QuantileSketch::Bins::merge(const Bins& other)
+    {
+        if (other.counts.empty())
+        {
+            return;
+        }
+
+        // grow once to cover both edges of other bins, then add counters in a single tight loop
+        add(other.offset, 0);
+        add(other.offset + static_cast<int32_t>(other.counts.size()) - 1, 0);
+
+        const auto shift{static_cast<size_t>(other.offset - offset)};
+        for (size_t i{0}; i < other.counts.size(); ++i)
+        {
+            counts[shift + i] += other.counts[i];
+        }
+    }
+}
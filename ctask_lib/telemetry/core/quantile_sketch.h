@@ -0,0 +1,85 @@
+#ifndef TELEMETRY_QUANTILE_SKETCH_H
+#define TELEMETRY_QUANTILE_SKETCH_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ctask::telemetry::core
+{
+    /**
+     * @class QuantileSketch
+     * @brief Mergeable quantile sketch with relative accuracy guarantee (DDSketch flavour).
+     *
+     * Values are counted in logarithmically sized bins, bin i covers (gamma^(i-1), gamma^i],
+     * gamma = (1 + a) / (1 - a). Any returned quantile is within a relative error of a to the exact one.
+     * Two sketches are merged by simply adding bin counters, which is what makes
+     * per-time-bucket sketches so cheap to combine for an arbitrary range.
+     *
+     * Negative values are kept in a mirrored set of bins, zeros have their own counter.
+     * Bins are stored densely between min and max used index, values of a single path are close to
+     * each other, so the number of bins stays small (few hundreds at most for 1% accuracy).
+     */
+    class QuantileSketch
+    {
+    public:
+        /**
+         * @brief Default relative accuracy, 1%.
+         */
+        static constexpr double DEFAULT_RELATIVE_ACCURACY{0.01};
+
+        explicit QuantileSketch(double relativeAccuracy = DEFAULT_RELATIVE_ACCURACY);
+
+        /**
+         * @brief Adds a single value to the sketch.
+         */
+        void add(double value);
+
+        /**
+         * @brief Adds all values of another sketch.
+         *
+         * @throws If sketches have different accuracy.
+         */
+        void merge(const QuantileSketch& other);
+
+        /**
+         * @brief Returns approximated quantile.
+         *
+         * @param q Quantile in [0, 1] range, e.g. 0.99 for p99.
+         * @return Quantile value, 0 for an empty sketch.
+         *
+         * @throws If q is out of range.
+         */
+        double quantile(double q) const;
+
+        /**
+         * @brief Returns number of added values.
+         */
+        uint64_t count() const { return count_; }
+
+    private:
+        /**
+         * @struct Bins
+         * @brief Dense bin counters starting from the offset index.
+         */
+        struct Bins
+        {
+            int32_t offset{0};
+            std::vector<uint64_t> counts{};
+
+            void add(int32_t index, uint64_t count);
+            void merge(const Bins& other);
+        };
+
+        double gamma_;
+        double logGamma_;
+        uint64_t count_{0};
+        uint64_t zeroCount_{0};
+        Bins positive_{};
+        Bins negative_{};
+
+        int32_t index_(double value) const;
+        double value_(int32_t index) const;
+    };
+}
+
+#endif //TELEMETRY_QUANTILE_SKETCH_H
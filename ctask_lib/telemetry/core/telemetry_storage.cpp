@@ -1,75 +1,746 @@
 #include "telemetry_storage.h"
+#include "metrics/metrics_registry.h"
+#include "tracing/tracer.h"
+#include "utils/concurrency/compute_pool.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <mutex>
 #include <shared_mutex>
+#include <stdexcept>
 
 namespace ctask::telemetry::core
 {
-    void TelemetryStorage::storeEvent(const std::string& eventName, InteractionTimesEventModel event)
+    /**
+     * @struct StorageMetrics
+     * @brief Storage-wide metrics, registered on first use.
+     *
+     * Lock wait histograms count only contended acquisitions, see metrics::lockMeasured.
+     */
+    struct StorageMetrics
     {
-        EventEntriesSortedByTimestamp* tmp{nullptr};
+        metrics::Counter& eventsStored;
+        metrics::Gauge& distinctEvents;
+        metrics::Histogram& eventsReadWait;
+        metrics::Histogram& eventsWriteWait;
+        metrics::Histogram& entryReadWait;
+        metrics::Histogram& entryWriteWait;
+        metrics::Counter& runMerges;
+    };
+
+    static StorageMetrics& storageMetrics()
+    {
+        auto& registry{metrics::MetricsRegistry::instance()};
+        auto lockWait = [&registry](const char* lock)
+        {
+            return &registry.latencyHistogram("ctask_storage_lock_wait_seconds",
+                                              "Time spent waiting for contended storage locks", {{"lock", lock}});
+        };
+
+        static StorageMetrics instance{
+            registry.counter("ctask_storage_events_stored_total", "Stored events"),
+            registry.gauge("ctask_storage_distinct_events", "Distinct event names"),
+            *lockWait("events_read"),
+            *lockWait("events_write"),
+            *lockWait("entry_read"),
+            *lockWait("entry_write"),
+            registry.counter("ctask_storage_run_merges_total", "Sorted runs merged by storage compaction"),
+        };
+        return instance;
+    }
+
+    template <typename Mutex>
+    static std::shared_lock<Mutex> lockShared(Mutex& mutex, metrics::Histogram& waitTime)
+    {
+        tracing::ScopedSpan span{"storage_lock"};
+        std::shared_lock lock(mutex, std::defer_lock);
+        metrics::lockMeasured(lock, waitTime);
+        return lock;
+    }
+
+    template <typename Mutex>
+    static std::unique_lock<Mutex> lockUnique(Mutex& mutex, metrics::Histogram& waitTime)
+    {
+        tracing::ScopedSpan span{"storage_lock"};
+        std::unique_lock lock(mutex, std::defer_lock);
+        metrics::lockMeasured(lock, waitTime);
+        return lock;
+    }
+
+    // the same as lockShared, but a contended lock suspends the coroutine instead of blocking the thread
+    static asio::awaitable<std::shared_lock<utils::concurrency::AsyncSharedMutex>> asyncLockShared(
+        utils::concurrency::AsyncSharedMutex& mutex, metrics::Histogram& waitTime)
+    {
+        if (mutex.try_lock_shared())
+        {
+            co_return std::shared_lock{mutex, std::adopt_lock};
+        }
+
+        tracing::ScopedSpan span{"storage_lock"};
+        const auto start{std::chrono::steady_clock::now()};
+        auto lock{co_await mutex.asyncLockShared()};
+        waitTime.observe(std::chrono::steady_clock::now() - start);
+        co_return lock;
+    }
+
+    static asio::awaitable<std::unique_lock<utils::concurrency::AsyncSharedMutex>> asyncLockUnique(
+        utils::concurrency::AsyncSharedMutex& mutex, metrics::Histogram& waitTime)
+    {
+        if (mutex.try_lock())
+        {
+            co_return std::unique_lock{mutex, std::adopt_lock};
+        }
+
+        tracing::ScopedSpan span{"storage_lock"};
+        const auto start{std::chrono::steady_clock::now()};
+        auto lock{co_await mutex.asyncLock()};
+        waitTime.observe(std::chrono::steady_clock::now() - start);
+        co_return lock;
+    }
+
+    // aligns value up to the bucket start, values which can't be aligned without overflow are kept as is
+    static uint64_t alignUp(uint64_t value, uint64_t bucket)
+    {
+        const auto rest{value % bucket};
+        return rest == 0 ? value : (value > std::numeric_limits<uint64_t>::max() - bucket ? value : value - rest + bucket);
+    }
+
+    static uint64_t alignDown(uint64_t value, uint64_t bucket)
+    {
+        return value - value % bucket;
+    }
+
+    template <size_t N>
+    BasicTelemetryStorage<N>::BasicTelemetryStorage() :
+        merger_([this](std::stop_token stopToken) { mergerRoutine_(std::move(stopToken)); })
+    {
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::storeEvent(std::string_view eventName, Event event)
+    {
+        auto tmp{findOrCreateEntry_(eventName)};
+
+        // at this point nobody is able to modify eventEntry, store new data
+        auto lock{lockUnique(tmp->entryMutex, storageMetrics().entryWriteWait)};
+        storeEventData_(*tmp, std::move(event));
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::storeEvents(std::string_view eventName, std::span<const Event> events)
+    {
+        if (events.empty())
+        {
+            return;
+        }
+        auto tmp{findOrCreateEntry_(eventName)};
+
+        auto lock{lockUnique(tmp->entryMutex, storageMetrics().entryWriteWait)};
+        for (const auto& event : events)
+        {
+            storeEventData_(*tmp, event);
+        }
+    }
+
+    template <size_t N>
+    asio::awaitable<void> BasicTelemetryStorage<N>::asyncStoreEvent(std::string_view eventName, Event event)
+    {
+        auto tmp{co_await asyncFindOrCreateEntry_(eventName)};
+
+        auto lock{co_await asyncLockUnique(tmp->entryMutex, storageMetrics().entryWriteWait)};
+        storeEventData_(*tmp, std::move(event));
+    }
+
+    template <size_t N>
+    std::vector<InteractionTimes<N>> BasicTelemetryStorage<N>::getEventInteractions(
+        std::string_view eventName, uint64_t from,
+        uint64_t to)
+    {
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr)
+        {
+            return {};
+        }
+
+        // nobody cant modify entry during reading
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        return copyInteractions_(*tmp, from, to);
+    }
+
+    template <size_t N>
+    PathLengthTotal BasicTelemetryStorage<N>::getEventPathLengthTotal(std::string_view eventName, uint64_t from,
+                                                                      uint64_t to, utils::concurrency::ComputePool* pool,
+                                                                      size_t minParallelEvents)
+    {
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr || from > to)
+        {
+            return {};
+        }
+
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        // the range, not the whole event, decides, a narrow query of a huge event isn't worth splitting
+        if (pool == nullptr || pool->threads() < 2 || tmp->data.size() < minParallelEvents ||
+            tmp->data.count(from, to) < minParallelEvents)
+        {
+            return sumPathLengths_(*tmp, from, to);
+        }
+        return parallelSumPathLengths_(*tmp, from, to, *pool);
+    }
+
+    template <size_t N>
+    size_t BasicTelemetryStorage<N>::getEventEntries(std::string_view eventName, uint64_t from, uint64_t to,
+                                                     size_t limit, std::vector<Event>& result)
+    {
+        result.clear();
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr || from > to)
+        {
+            return 0;
+        }
+
+        // lock only for a single chunk, writers can slip in between chunks
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        return copyEntries_(*tmp, from, to, limit, result);
+    }
+
+    template <size_t N>
+    asio::awaitable<size_t> BasicTelemetryStorage<N>::asyncGetEventEntries(std::string_view eventName, uint64_t from,
+                                                                           uint64_t to, size_t limit,
+                                                                           std::vector<Event>& result)
+    {
+        result.clear();
+        auto tmp{co_await asyncFindEntry_(eventName)};
+        if (tmp == nullptr || from > to)
+        {
+            co_return 0;
+        }
+
+        auto lock{co_await asyncLockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        co_return copyEntries_(*tmp, from, to, limit, result);
+    }
+
+    template <size_t N>
+    typename BasicTelemetryStorage<N>::EventEntriesSortedByTimestamp* BasicTelemetryStorage<N>::findEntry_(
+        std::string_view eventName)
+    {
+        // entries are never removed and deque keeps references stable on emplace_back,
+        // so the pointer stays valid after the lock is released
+        auto lock{lockShared(mutex_, storageMetrics().eventsReadWait)};
+        const auto id{eventNames_.find(eventName)};
+        return id ? &eventEntries_[*id] : nullptr;
+    }
+
+    template <size_t N>
+    typename BasicTelemetryStorage<N>::EventEntriesSortedByTimestamp* BasicTelemetryStorage<N>::findOrCreateEntry_(
+        std::string_view eventName)
+    {
+        if (auto tmp{findEntry_(eventName)})
+        {
+            return tmp;
+        }
+
+        // brand new event comes, lock names and create entry
+        auto lock{lockUnique(mutex_, storageMetrics().eventsWriteWait)};
+        return createEntry_(eventName);
+    }
+
+    template <size_t N>
+    asio::awaitable<typename BasicTelemetryStorage<N>::EventEntriesSortedByTimestamp*>
+    BasicTelemetryStorage<N>::asyncFindEntry_(std::string_view eventName)
+    {
+        auto lock{co_await asyncLockShared(mutex_, storageMetrics().eventsReadWait)};
+        const auto id{eventNames_.find(eventName)};
+        co_return id ? &eventEntries_[*id] : nullptr;
+    }
+
+    template <size_t N>
+    asio::awaitable<typename BasicTelemetryStorage<N>::EventEntriesSortedByTimestamp*>
+    BasicTelemetryStorage<N>::asyncFindOrCreateEntry_(std::string_view eventName)
+    {
+        if (auto tmp{co_await asyncFindEntry_(eventName)})
+        {
+            co_return tmp;
+        }
+
+        auto lock{co_await asyncLockUnique(mutex_, storageMetrics().eventsWriteWait)};
+        co_return createEntry_(eventName);
+    }
+
+    template <size_t N>
+    typename BasicTelemetryStorage<N>::EventEntriesSortedByTimestamp* BasicTelemetryStorage<N>::createEntry_(
+        std::string_view eventName)
+    {
+        // somebody could intern the name while we were waiting for the lock,
+        // then the entry is already there and the id is just looked up
+        const auto id{eventNames_.intern(eventName)};
+        if (id == eventEntries_.size())
+        {
+            eventEntries_.emplace_back();
+            storageMetrics().distinctEvents.add(1);
+        }
+        return &eventEntries_[id];
+    }
+
+    template <size_t N>
+    QuantileSketch BasicTelemetryStorage<N>::getEventSketch(std::string_view eventName, uint64_t from, uint64_t to)
+    {
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr || from > to)
+        {
+            return {};
+        }
+
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        return buildSketch_(*tmp, from, to);
+    }
+
+    template <size_t N>
+    std::vector<PathLengthSeriesBucket> BasicTelemetryStorage<N>::getEventSeries(std::string_view eventName,
+                                                                                 uint64_t from, uint64_t to,
+                                                                                 uint64_t interval)
+    {
+        if (interval == 0)
+        {
+            throw std::invalid_argument("Series interval must be positive");
+        }
+
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr || from > to)
+        {
+            return {};
+        }
+
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        return buildSeries_(*tmp, from, to, interval);
+    }
+
+    template <size_t N>
+    uint64_t BasicTelemetryStorage<N>::getEventVersion(std::string_view eventName)
+    {
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr)
+        {
+            return 0;
+        }
+
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        return tmp->version;
+    }
+
+    template <size_t N>
+    bool BasicTelemetryStorage<N>::isRangeModifiedSince(std::string_view eventName, uint64_t version, uint64_t from,
+                                                        uint64_t to)
+    {
+        auto tmp{findEntry_(eventName)};
+        if (tmp == nullptr)
+        {
+            // nothing was ever stored
+            return false;
+        }
+
+        auto lock{lockShared(tmp->entryMutex, storageMetrics().entryReadWait)};
+        if (version > tmp->version)
+        {
+            // unknown version
+            return true;
+        }
+
+        if (tmp->version - version > RECENT_WRITES_LEN)
+        {
+            // some of the writes were already forgotten, fall back to the coarse rollups
+            return isRollupRangeModifiedSince_(*tmp, version, from, to);
+        }
+
+        for (auto v{version}; v < tmp->version; ++v)
+        {
+            const auto date{tmp->recentWrites[v % RECENT_WRITES_LEN]};
+            if (date >= from && date <= to)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::mergeRuns()
+    {
+        mergeAllRuns_(true);
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::mergeAllRuns_(bool sealActive)
+    {
+        for (size_t id{0};; ++id)
         {
-            std::shared_lock lock(mutex_);
+            EventEntriesSortedByTimestamp* entry{nullptr};
+            {
+                auto lock{lockShared(mutex_, storageMetrics().eventsReadWait)};
+                if (id >= eventEntries_.size())
+                {
+                    return;
+                }
+                entry = &eventEntries_[id];
+            }
+            mergeEntryRuns_(*entry, sealActive);
+        }
+    }
 
-            // at this point nobody is able to write in eventEntries_
-            // let's try to find proper entry
-            auto it{eventEntries_.find(eventName)};
-            if (it != eventEntries_.end())
+    template <size_t N>
+    void BasicTelemetryStorage<N>::mergeEntryRuns_(EventEntriesSortedByTimestamp& entry, bool sealActive)
+    {
+        bool seal{false};
+        uint64_t idleVersion{0};
+        {
+            // writers are held back only when there's something to seal,
+            // a buffer written since the previous tick is still hot and gets sealed by its writers once full
+            auto lock{lockShared(entry.entryMutex, storageMetrics().entryReadWait)};
+            idleVersion = entry.version;
+            seal = entry.data.buffered() != 0 && (sealActive || idleVersion == entry.mergerVersion);
+            if (!sealActive)
             {
-                // store entry pointer
-                tmp = &it->second;
+                entry.mergerVersion = idleVersion;
+            }
+        }
+        if (seal)
+        {
+            auto lock{lockUnique(entry.entryMutex, storageMetrics().entryWriteWait)};
+            // a writer could slip in between the locks, then the buffer isn't idle anymore
+            if (sealActive || entry.version == idleVersion)
+            {
+                entry.data.sealBuffer();
             }
         }
 
-        // if entry exists, lock it and store event data
-        if (tmp != nullptr)
+        for (;;)
         {
+            std::optional<typename BasicEventLsmTree<N>::Compaction> compaction{};
+            {
+                auto lock{lockShared(entry.entryMutex, storageMetrics().entryReadWait)};
+                compaction = entry.data.planCompaction();
+            }
+            if (!compaction)
             {
-                // at this point nobody is able to modify eventEntry, store new data
-                std::unique_lock lock(tmp->entryMutex);
-                tmp->data.emplace(std::move(event.date), std::move(event.values));
                 return;
             }
+
+            // runs are immutable, readers and writers go on while they're merged
+            auto merged{BasicEventLsmTree<N>::merge(compaction->inputs)};
+
+            auto lock{lockUnique(entry.entryMutex, storageMetrics().entryWriteWait)};
+            // a concurrent mergeRuns got there first, the plan is made again
+            if (entry.data.installCompaction(*compaction, std::move(merged)))
+            {
+                storageMetrics().runMerges.inc(compaction->inputs.size());
+            }
         }
+    }
 
-        // brand new event comes, lock map and store event
+    template <size_t N>
+    void BasicTelemetryStorage<N>::mergerRoutine_(std::stop_token stopToken)
+    {
+        for (;;)
         {
-            std::unique_lock lock(mutex_);
+            {
+                // only a stop request wakes it before the period is over
+                std::unique_lock lock{mergerMutex_};
+                mergerCv_.wait_for(lock, stopToken, MERGE_PERIOD, []() { return false; });
+            }
+            if (stopToken.stop_requested())
+            {
+                return;
+            }
+            mergeAllRuns_(false);
+        }
+    }
 
-            // this weird way to emplace new event, thanks to mutex;
-            auto [it, _]{eventEntries_.try_emplace(eventName)};
-            it->second.data.emplace(std::move(event.date), std::move(event.values));
+    template <size_t N>
+    std::optional<EventId> BasicTelemetryStorage<N>::findEventId(std::string_view eventName)
+    {
+        auto lock{lockShared(mutex_, storageMetrics().eventsReadWait)};
+        return eventNames_.find(eventName);
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::storeEventData_(EventEntriesSortedByTimestamp& entry, const Event& event)
+    {
+        entry.data.insert(event);
+        storageMetrics().eventsStored.inc();
+
+        entry.recentWrites[entry.version % RECENT_WRITES_LEN] = event.date;
+        ++entry.version;
+
+        const auto pathLength{calculatePathLength(event.values)};
+        for (auto* rollup : {&entry.hourRollups[alignDown(event.date, HOUR_ROLLUP_BUCKET)],
+                             &entry.dayRollups[alignDown(event.date, DAY_ROLLUP_BUCKET)]})
+        {
+            rollup->totalPathLength += pathLength;
+            rollup->sketch.add(static_cast<double>(pathLength));
+            rollup->version = entry.version;
         }
     }
 
-    std::vector<InteractionTimesCollection> TelemetryStorage::getEventInteractions(
-        const std::string& eventName, uint64_t from,
-        uint64_t to)
+    template <size_t N>
+    std::vector<InteractionTimes<N>> BasicTelemetryStorage<N>::copyInteractions_(
+        const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to)
     {
-        EventEntriesSortedByTimestamp* tmp{nullptr};
+        std::vector<Interactions> result{};
+        entry.data.forEachOrdered(from, to, [&result](const Event& event)
         {
-            std::shared_lock lock(mutex_);
-            auto it{eventEntries_.find(eventName)};
-            if (it == eventEntries_.end())
+            result.emplace_back(event.values);
+            return true;
+        });
+        return result;
+    }
+
+    template <size_t N>
+    PathLengthTotal BasicTelemetryStorage<N>::sumPathLengths_(const EventEntriesSortedByTimestamp& entry,
+                                                              uint64_t from, uint64_t to)
+    {
+        PathLengthTotal total{};
+        entry.data.forEach(from, to, [&total](const Event& event)
+        {
+            total.totalPathLength += calculatePathLength(event.values);
+            ++total.count;
+        });
+        return total;
+    }
+
+    template <size_t N>
+    PathLengthTotal BasicTelemetryStorage<N>::parallelSumPathLengths_(const EventEntriesSortedByTimestamp& entry,
+                                                                      uint64_t from, uint64_t to,
+                                                                      utils::concurrency::ComputePool& pool)
+    {
+        if (entry.data.empty())
+        {
+            return {};
+        }
+
+        // cut only the part which has events, an open range would leave most sub-ranges empty
+        const auto lo{std::max<uint64_t>(from, entry.data.minDate())};
+        const auto hi{std::min<uint64_t>(to, entry.data.maxDate())};
+        if (lo > hi)
+        {
+            return {};
+        }
+
+        const auto chunks{pool.threads() * PARALLEL_SCAN_CHUNKS_PER_THREAD};
+        const auto span{hi - lo};
+        const auto step{span / chunks + 1};
+
+        std::vector<PathLengthTotal> partials(chunks);
+        pool.parallelFor(chunks, [&](size_t i)
+        {
+            const auto offset{i * step};
+            if (offset > span)
             {
-                return {};
+                return;
             }
-            tmp = &it->second;
+            const auto chunkFrom{lo + offset};
+            const auto chunkTo{span - offset < step ? hi : chunkFrom + step - 1};
+            partials[i] = sumPathLengths_(entry, chunkFrom, chunkTo);
+        });
+
+        PathLengthTotal total{};
+        for (const auto& partial : partials)
+        {
+            total += partial;
         }
-        std::vector<InteractionTimesCollection> result{};
-        result.reserve(INTERACTION_TIMES_LEN);
+        return total;
+    }
 
+    template <size_t N>
+    size_t BasicTelemetryStorage<N>::copyEntries_(const EventEntriesSortedByTimestamp& entry, uint64_t from,
+                                                  uint64_t to, size_t limit, std::vector<Event>& result)
+    {
+        if (limit == 0)
+        {
+            return 0;
+        }
+        // a chunk never ends in the middle of a date, the next one starts after it
+        entry.data.forEachOrdered(from, to, [&result, limit](const Event& event)
         {
-            // nobody cant modify entry during reading
-            std::shared_lock lock(tmp->entryMutex);
-            auto lowerIt{tmp->data.lower_bound(from)};
-            auto upperIt{tmp->data.upper_bound(to)};
-            for (; lowerIt != upperIt; ++lowerIt)
+            if (result.size() >= limit && event.date != result.back().date)
             {
-                result.emplace_back(lowerIt->second);
+                return false;
             }
+            result.push_back(event);
+            return true;
+        });
+        return result.size();
+    }
+
+    template <size_t N>
+    QuantileSketch BasicTelemetryStorage<N>::buildSketch_(const EventEntriesSortedByTimestamp& entry, uint64_t from,
+                                                          uint64_t to)
+    {
+        QuantileSketch result{};
+
+        // split range into parts:
+        // [from, hourFrom) raw | [hourFrom, dayFrom) hours | [dayFrom, dayTo) days | [dayTo, hourTo) hours | [hourTo, to] raw
+        // exclusive end of the range; the very last second of uint64 range is left for raw scan, no big deal
+        const auto end{to == std::numeric_limits<uint64_t>::max() ? to : to + 1};
+        const auto hourFrom{alignUp(from, HOUR_ROLLUP_BUCKET)};
+        const auto hourTo{alignDown(end, HOUR_ROLLUP_BUCKET)};
+
+        if (hourFrom >= hourTo || hourFrom % HOUR_ROLLUP_BUCKET != 0)
+        {
+            // less than a whole aligned hour, just scan everything
+            addRawEventsToSketch_(entry, from, to, result);
+            return result;
         }
 
+        if (from < hourFrom)
+        {
+            addRawEventsToSketch_(entry, from, hourFrom - 1, result);
+        }
+
+        const auto dayFrom{alignUp(hourFrom, DAY_ROLLUP_BUCKET)};
+        const auto dayTo{alignDown(hourTo, DAY_ROLLUP_BUCKET)};
+        if (dayFrom < dayTo && dayFrom % DAY_ROLLUP_BUCKET == 0)
+        {
+            mergeBucketSketches_(entry.hourRollups, hourFrom, dayFrom, result);
+            mergeBucketSketches_(entry.dayRollups, dayFrom, dayTo, result);
+            mergeBucketSketches_(entry.hourRollups, dayTo, hourTo, result);
+        }
+        else
+        {
+            mergeBucketSketches_(entry.hourRollups, hourFrom, hourTo, result);
+        }
+
+        if (hourTo <= to)
+        {
+            addRawEventsToSketch_(entry, hourTo, to, result);
+        }
         return result;
     }
+
+    template <size_t N>
+    std::vector<PathLengthSeriesBucket> BasicTelemetryStorage<N>::buildSeries_(
+        const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to, uint64_t interval)
+    {
+        std::vector<PathLengthSeriesBucket> result{};
+
+        // parts of the range are walked in timestamp order,
+        // so every value either lands into the last bucket or opens the next one
+        auto accumulate = [&result, interval](EventDateType date, int64_t totalPathLength, uint64_t count)
+        {
+            const auto bucketStart{alignDown(date, interval)};
+            if (result.empty() || result.back().bucketStart != bucketStart)
+            {
+                result.push_back({bucketStart, 0, 0});
+            }
+            result.back().totalPathLength += totalPathLength;
+            result.back().count += count;
+        };
+
+        auto accumulateRaw = [&](uint64_t rawFrom, uint64_t rawTo)
+        {
+            entry.data.forEachOrdered(rawFrom, rawTo, [&accumulate](const Event& event)
+            {
+                accumulate(event.date, calculatePathLength(event.values), 1);
+                return true;
+            });
+        };
+
+        // every rollup lies within a single series bucket, as interval is a multiple of the rollup bucket
+        auto accumulateRollups = [&](const PathLengthRollups& rollups,
+                                     uint64_t rollupFrom, uint64_t rollupTo)
+        {
+            for (auto it{rollups.lower_bound(rollupFrom)}; it != rollups.end() && it->first < rollupTo; ++it)
+            {
+                accumulate(it->first, it->second.totalPathLength, it->second.sketch.count());
+            }
+        };
+
+        // the same split as for sketches, see getEventSketch
+        const auto end{to == std::numeric_limits<uint64_t>::max() ? to : to + 1};
+        const auto hourFrom{alignUp(from, HOUR_ROLLUP_BUCKET)};
+        const auto hourTo{alignDown(end, HOUR_ROLLUP_BUCKET)};
+
+        if (interval % HOUR_ROLLUP_BUCKET != 0 || hourFrom >= hourTo || hourFrom % HOUR_ROLLUP_BUCKET != 0)
+        {
+            // rollups can't be split into smaller buckets, or there is less than a whole aligned hour
+            accumulateRaw(from, to);
+            return result;
+        }
+
+        if (from < hourFrom)
+        {
+            accumulateRaw(from, hourFrom - 1);
+        }
+
+        const auto dayFrom{alignUp(hourFrom, DAY_ROLLUP_BUCKET)};
+        const auto dayTo{alignDown(hourTo, DAY_ROLLUP_BUCKET)};
+        if (interval % DAY_ROLLUP_BUCKET == 0 && dayFrom < dayTo && dayFrom % DAY_ROLLUP_BUCKET == 0)
+        {
+            accumulateRollups(entry.hourRollups, hourFrom, dayFrom);
+            accumulateRollups(entry.dayRollups, dayFrom, dayTo);
+            accumulateRollups(entry.hourRollups, dayTo, hourTo);
+        }
+        else
+        {
+            accumulateRollups(entry.hourRollups, hourFrom, hourTo);
+        }
+
+        if (hourTo <= to)
+        {
+            accumulateRaw(hourTo, to);
+        }
+        return result;
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::addRawEventsToSketch_(const EventEntriesSortedByTimestamp& entry, uint64_t from,
+                                                         uint64_t to, QuantileSketch& sketch)
+    {
+        entry.data.forEach(from, to, [&sketch](const Event& event)
+        {
+            sketch.add(static_cast<double>(calculatePathLength(event.values)));
+        });
+    }
+
+    template <size_t N>
+    bool BasicTelemetryStorage<N>::isRollupRangeModifiedSince_(const EventEntriesSortedByTimestamp& entry,
+                                                               uint64_t version, uint64_t from, uint64_t to)
+    {
+        // untouched days are skipped as a whole, only hours of the written ones are looked at,
+        // so heavy ingest of today costs a historical range a day walk plus a day of hours
+        const auto& hours{entry.hourRollups};
+        for (auto day{entry.dayRollups.lower_bound(alignDown(from, DAY_ROLLUP_BUCKET))};
+             day != entry.dayRollups.end() && day->first <= to; ++day)
+        {
+            if (day->second.version <= version)
+            {
+                continue;
+            }
+
+            const auto hoursFrom{std::max(day->first, alignDown(from, HOUR_ROLLUP_BUCKET))};
+            for (auto hour{hours.lower_bound(hoursFrom)};
+                 hour != hours.end() && hour->first <= to && hour->first - day->first < DAY_ROLLUP_BUCKET; ++hour)
+            {
+                if (hour->second.version > version)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <size_t N>
+    void BasicTelemetryStorage<N>::mergeBucketSketches_(const PathLengthRollups& rollups,
+                                                        uint64_t from, uint64_t to, QuantileSketch& sketch)
+    {
+        for (auto it{rollups.lower_bound(from)}; it != rollups.end() && it->first < to; ++it)
+        {
+            sketch.merge(it->second.sketch);
+        }
+    }
+
+#define CTASK_INSTANTIATE_TELEMETRY_STORAGE(len) template class BasicTelemetryStorage<len>;
+    CTASK_INTERACTION_TIMES_FAMILIES(CTASK_INSTANTIATE_TELEMETRY_STORAGE)
+#undef CTASK_INSTANTIATE_TELEMETRY_STORAGE
 }
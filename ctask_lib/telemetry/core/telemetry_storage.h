@@ -2,30 +2,71 @@
 #define TELEMETRY_STORAGE_H
 
 #include "models.h"
+#include "quantile_sketch.h"
+#include "event_name_table.h"
+#include "event_lsm_tree.h"
+#include "utils/concurrency/async_shared_mutex.h"
 
+#include <asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <optional>
 #include <shared_mutex>
-#include <unordered_map>
+#include <span>
+#include <string_view>
+#include <thread>
+
+namespace ctask::utils::concurrency
+{
+    class ComputePool;
+}
 
 namespace ctask::telemetry::core
 {
     /**
-     * @class TelemetryStorage
+     * @class BasicTelemetryStorage
      * @brief Thread-safe in-memory telemetry storage.
      *
      * Designed to store and retrieve telemetry interaction events efficiently.
-     * Uses std::unordered_map for quick event name lookup and
-     * std::map to keep event entries sorted by timestamp.
+     * Event names are interned into dense ids, entries live in a deque indexed by id,
+     * so a lookup is a single string_view hash without any allocation.
+     * Events of a name are kept LSM style (see BasicEventLsmTree): writers append to a buffer,
+     * a background merger seals buffers left idle for a whole MERGE_PERIOD and compacts sorted runs,
+     * active buffers seal themselves once full.
+     * Every event is kept, including events of a name sharing a timestamp.
+     *
+     * Calls made from coroutines on the io threads (ingest, export) have an awaitable twin (async*):
+     * a contended entry lock suspends the coroutine instead of parking the whole thread.
+     * Name strings passed to them must outlive the call. Queries run on the compute pool and use
+     * the blocking calls, an io thread must never use them (see AsyncSharedMutex).
+     *
+     * @tparam N Length of interaction times, instantiated for CTASK_INTERACTION_TIMES_FAMILIES,
+     * every reduction sums a vector of the length known at compile time.
      */
-    class TelemetryStorage
+    template <size_t N>
+    class BasicTelemetryStorage
     {
     public:
-        TelemetryStorage() = default;
-        ~TelemetryStorage() = default;
-        TelemetryStorage(const TelemetryStorage&) = delete;
-        TelemetryStorage& operator=(const TelemetryStorage&) = delete;
-        TelemetryStorage(TelemetryStorage&&) = delete;
-        TelemetryStorage& operator=(TelemetryStorage&&) = delete;
+        using Event = BasicInteractionTimesEventModel<N>;
+        using Interactions = InteractionTimes<N>;
+
+        /**
+         * @brief Creates an empty storage and starts its background merger.
+         */
+        BasicTelemetryStorage();
+
+        /**
+         * @brief Stops the background merger.
+         */
+        ~BasicTelemetryStorage() = default;
+        BasicTelemetryStorage(const BasicTelemetryStorage&) = delete;
+        BasicTelemetryStorage& operator=(const BasicTelemetryStorage&) = delete;
+        BasicTelemetryStorage(BasicTelemetryStorage&&) = delete;
+        BasicTelemetryStorage& operator=(BasicTelemetryStorage&&) = delete;
 
         /**
          * @brief Stores a telemetry event.
@@ -36,7 +77,23 @@ namespace ctask::telemetry::core
          * @param eventName The name of the event.
          * @param event The event data.
          */
-        void storeEvent(const std::string& eventName, InteractionTimesEventModel event);
+        void storeEvent(std::string_view eventName, Event event);
+
+        /**
+         * @brief Stores a batch of events of a single event name under one entry lock acquisition.
+         *
+         * The same as storeEvent for every event in order, events with the same date keep that order.
+         * Events sorted by date are the cheapest to insert.
+         *
+         * @param eventName The name of the event.
+         * @param events The events data.
+         */
+        void storeEvents(std::string_view eventName, std::span<const Event> events);
+
+        /**
+         * @brief Awaitable storeEvent, waits for the entry lock suspended.
+         */
+        asio::awaitable<void> asyncStoreEvent(std::string_view eventName, Event event);
 
         /**
          * @brief Retrieves telemetry events in a given time range.
@@ -49,28 +106,309 @@ namespace ctask::telemetry::core
          * @param to The end timestamp (inclusive).
          * @return Interactions collection.
          */
-        std::vector<InteractionTimesCollection> getEventInteractions(const std::string& eventName,
-                                                                     uint64_t from,
-                                                                     uint64_t to);
+        std::vector<Interactions> getEventInteractions(std::string_view eventName,
+                                                       uint64_t from,
+                                                       uint64_t to);
+
+        /**
+         * @brief Retrieves a limited portion of telemetry events in a given time range.
+         *
+         * Designed for walking big ranges chunk by chunk: entry lock is held only while
+         * a single chunk is copied, so writers are not blocked for the whole walk.
+         * To get the next chunk call it again with from = last returned date + 1.
+         * Events sharing the last date are never split between chunks, so a chunk may exceed the limit by them.
+         *
+         * @param eventName The name of the event.
+         * @param from The start timestamp (inclusive).
+         * @param to The end timestamp (inclusive).
+         * @param limit Max number of events to copy.
+         * @param result Output collection, cleared before filling, so its capacity can be reused between chunks.
+         * @return Number of copied events.
+         */
+        size_t getEventEntries(std::string_view eventName, uint64_t from, uint64_t to, size_t limit,
+                               std::vector<Event>& result);
+
+        /**
+         * @brief Awaitable getEventEntries, waits for the entry lock suspended, used by export streams.
+         */
+        asio::awaitable<size_t> asyncGetEventEntries(std::string_view eventName, uint64_t from, uint64_t to,
+                                                     size_t limit, std::vector<Event>& result);
+
+        /**
+         * @brief Sums path lengths in a given time range.
+         *
+         * Small ranges are walked serially. A range of minParallelEvents events and more is walked
+         * in parallel on the pool: the range is cut into sub-ranges of equal length, a few per pool thread,
+         * so idle threads steal the rest when events are spread unevenly, and partial totals are merged.
+         * Events of the range are counted with binary searches over the sorted runs, so a narrow query
+         * of a huge event stays serial. The entry is locked shared for the whole walk.
+         *
+         * There's no awaitable twin, the walk is heavy anyway and belongs to the compute pool, not the io threads.
+         *
+         * @param eventName The name of the event.
+         * @param from The start timestamp (inclusive).
+         * @param to The end timestamp (inclusive).
+         * @param pool Pool to walk big ranges on, nullptr walks serially.
+         * @param minParallelEvents Events of the range from which it's walked in parallel.
+         * @return Sum and count of path lengths, zeros if there are no events.
+         */
+        PathLengthTotal getEventPathLengthTotal(std::string_view eventName, uint64_t from, uint64_t to,
+                                                utils::concurrency::ComputePool* pool = nullptr,
+                                                size_t minParallelEvents = PARALLEL_SCAN_MIN_EVENTS);
+
+        /**
+         * @brief Builds quantile sketch of path lengths in a given time range.
+         *
+         * Path length is a sum of event's interaction times, the same value calculateMeanPathLength averages.
+         * Pre-aggregated hour and day sketches are merged for the aligned middle of the range
+         * and only the unaligned edges (less than an hour on each side) are scanned event by event,
+         * so the cost depends on the range length in days, not on the amount of events.
+         *
+         * @param eventName The name of the event.
+         * @param from The start timestamp (inclusive).
+         * @param to The end timestamp (inclusive).
+         * @return Sketch of the range, empty if there are no events.
+         */
+        QuantileSketch getEventSketch(std::string_view eventName, uint64_t from, uint64_t to);
+
+        /**
+         * @brief Aggregates path lengths into time buckets of a given interval.
+         *
+         * Buckets are aligned to multiples of the interval (since epoch), only non-empty ones are returned,
+         * sorted by bucket start. Computed in a single ordered pass under the entry lock; when the interval
+         * is a whole number of hours (days) the pre-aggregated hour (day) rollups are summed instead of
+         * raw events, so only the unaligned edges of the range are scanned event by event.
+         *
+         * @param eventName The name of the event.
+         * @param from The start timestamp (inclusive).
+         * @param to The end timestamp (inclusive).
+         * @param interval Bucket length in seconds.
+         * @return Non-empty buckets of the range.
+         * @throws std::invalid_argument If interval is zero.
+         */
+        std::vector<PathLengthSeriesBucket> getEventSeries(std::string_view eventName, uint64_t from, uint64_t to,
+                                                           uint64_t interval);
+
+        /**
+         * @brief Returns event version.
+         *
+         * Version is bumped by every stored event,
+         * so a result calculated at some version is known to be fresh while the version stays the same.
+         *
+         * @param eventName The name of the event.
+         * @return Event version, 0 for unknown event.
+         */
+        uint64_t getEventVersion(std::string_view eventName);
+
+        /**
+         * @brief Checks whether events within a time range were stored after the given version.
+         *
+         * Dates of the most recent writes are remembered per event, which lets results of historical
+         * ranges survive heavy ingest of fresh events. If the version is older than the remembered writes,
+         * the last-modified versions of day and hour rollups overlapping the range are checked instead,
+         * a written hour counts as modified as a whole.
+         *
+         * @param eventName The name of the event.
+         * @param version Event version returned by getEventVersion.
+         * @param from The start timestamp (inclusive).
+         * @param to The end timestamp (inclusive).
+         * @return True if the range might have been modified since the version.
+         */
+        bool isRangeModifiedSince(std::string_view eventName, uint64_t version, uint64_t from, uint64_t to);
+
+        /**
+         * @brief Seals write buffers and compacts runs of every event right away.
+         *
+         * The background merger does the same every MERGE_PERIOD, but seals idle buffers only.
+         * The runs are merged without the entry lock, only swapping them in takes it exclusively.
+         */
+        void mergeRuns();
+
+        /**
+         * @brief Returns id of the event name.
+         *
+         * Ids are dense and stable, other components can keep per-event data in arrays indexed by them.
+         *
+         * @param eventName The name of the event.
+         * @return Event id or std::nullopt if nothing was ever stored under the name.
+         */
+        std::optional<EventId> findEventId(std::string_view eventName);
+
+        // events of a range from which getEventPathLengthTotal walks in parallel by default.
+        // Not measured yet: BM_MeanLength_ParallelCutoff prints serial and parallel latency against range size,
+        // the cutoff is the smallest range where the parallel walk wins on the target host
+        static constexpr size_t PARALLEL_SCAN_MIN_EVENTS{64 * 1024};
+
+        // how often the background merger seals buffers and compacts runs
+        static constexpr std::chrono::milliseconds MERGE_PERIOD{100};
 
     private:
+        // sub-ranges per pool thread of a parallel walk
+        static constexpr size_t PARALLEL_SCAN_CHUNKS_PER_THREAD{4};
+
+        // amount of the most recent write dates remembered per event
+        static constexpr size_t RECENT_WRITES_LEN{256};
+
+        // time buckets of pre-aggregated rollups, in seconds
+        static constexpr EventDateType HOUR_ROLLUP_BUCKET{3600};
+        static constexpr EventDateType DAY_ROLLUP_BUCKET{24 * HOUR_ROLLUP_BUCKET};
+
+        /**
+         * @struct PathLengthRollup
+         * @brief Pre-aggregated path lengths of a single time bucket, events count is kept by the sketch.
+         *
+         * Version is the event version right after the last write into the bucket.
+         */
+        struct PathLengthRollup
+        {
+            int64_t totalPathLength{0};
+            QuantileSketch sketch{};
+            uint64_t version{0};
+        };
+
+        using PathLengthRollups = std::map<EventDateType, PathLengthRollup>;
+
         /**
          * @struct EventEntriesSortedByTimestamp
          * @brief Internal structure for storing event data sorted by timestamp.
          *
-         * Uses std::map to maintain timestamp ordering for fast range queries.
-         * Read/write access is controlled with std::shared_mutex to allow
-         * concurrent reads and serialized writes.
+         * Uses BasicEventLsmTree: appends on write, contiguous sorted runs on read.
+         * Read/write access is controlled with AsyncSharedMutex to allow
+         * concurrent reads and serialized writes, both for plain threads and coroutines.
+         *
+         * Path length rollups are kept per hour and per day bucket (keyed by bucket start),
+         * updated along with data. Every stored event bumps version, its date is put
+         * into recentWrites ring at version % RECENT_WRITES_LEN and the new version is put into its rollups.
          */
         struct EventEntriesSortedByTimestamp
         {
-            std::map<EventDateType, InteractionTimesCollection> data;
-            std::shared_mutex entryMutex;
+            BasicEventLsmTree<N> data{};
+            PathLengthRollups hourRollups{};
+            PathLengthRollups dayRollups{};
+            uint64_t version{0};
+            std::array<EventDateType, RECENT_WRITES_LEN> recentWrites{};
+            // version seen by the previous merger tick, touched by the merger only
+            uint64_t mergerVersion{0};
+            utils::concurrency::AsyncSharedMutex entryMutex;
         };
 
-        std::shared_mutex mutex_;
-        std::unordered_map<EventName, EventEntriesSortedByTimestamp> eventEntries_;
+        // guards both the names and the entries, entry of an id is created along with the id;
+        // coroutines look entries up with the awaitable lock, so an io thread never blocks on it either
+        utils::concurrency::AsyncSharedMutex mutex_;
+        EventNameTable eventNames_;
+        std::deque<EventEntriesSortedByTimestamp> eventEntries_;
+
+        std::mutex mergerMutex_;
+        std::condition_variable_any mergerCv_;
+
+        // the last member, the merger must stop before the entries go away
+        std::jthread merger_;
+
+        /**
+         * @brief Finds event entry by name.
+         *
+         * @param eventName The name of the event.
+         * @return Pointer to the entry or nullptr if event is unknown.
+         */
+        EventEntriesSortedByTimestamp* findEntry_(std::string_view eventName);
+
+        /**
+         * @brief Finds event entry by name, creates it for a brand-new event.
+         *
+         * @param eventName The name of the event.
+         * @return Pointer to the entry.
+         */
+        EventEntriesSortedByTimestamp* findOrCreateEntry_(std::string_view eventName);
+
+        /**
+         * @brief Awaitable findEntry_, waits for the names lock suspended.
+         */
+        asio::awaitable<EventEntriesSortedByTimestamp*> asyncFindEntry_(std::string_view eventName);
+
+        /**
+         * @brief Awaitable findOrCreateEntry_, waits for the names lock suspended.
+         */
+        asio::awaitable<EventEntriesSortedByTimestamp*> asyncFindOrCreateEntry_(std::string_view eventName);
+
+        /**
+         * @brief Interns the name and creates its entry if it's brand-new, names must be locked exclusively.
+         */
+        EventEntriesSortedByTimestamp* createEntry_(std::string_view eventName);
+
+        /**
+         * @brief Seals buffers and compacts runs of every entry.
+         *
+         * @param sealActive Seal buffers written since the previous tick as well.
+         */
+        void mergeAllRuns_(bool sealActive);
+
+        /**
+         * @brief Seals the buffer and compacts runs of a single entry, see mergeAllRuns_.
+         */
+        static void mergeEntryRuns_(EventEntriesSortedByTimestamp& entry, bool sealActive);
+
+        void mergerRoutine_(std::stop_token stopToken);
+
+        /**
+         * @brief Stores event data into the entry, entry must be locked for writing.
+         */
+        static void storeEventData_(EventEntriesSortedByTimestamp& entry, const Event& event);
+
+        /**
+         * @brief Copies interaction times within [from, to] range, entry must be locked.
+         */
+        static std::vector<Interactions> copyInteractions_(const EventEntriesSortedByTimestamp& entry,
+                                                           uint64_t from, uint64_t to);
+
+        /**
+         * @brief Appends up to limit events within [from, to] range to the result, entry must be locked.
+         */
+        static size_t copyEntries_(const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to,
+                                   size_t limit, std::vector<Event>& result);
+
+        /**
+         * @brief Sums path lengths within [from, to] range in a single pass, entry must be locked.
+         */
+        static PathLengthTotal sumPathLengths_(const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to);
+
+        /**
+         * @brief Sums path lengths within [from, to] range, see getEventPathLengthTotal, entry must be locked.
+         */
+        static PathLengthTotal parallelSumPathLengths_(const EventEntriesSortedByTimestamp& entry,
+                                                       uint64_t from, uint64_t to,
+                                                       utils::concurrency::ComputePool& pool);
+
+        /**
+         * @brief Builds quantile sketch of [from, to] range, see getEventSketch, entry must be locked.
+         */
+        static QuantileSketch buildSketch_(const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to);
+
+        /**
+         * @brief Aggregates path lengths of [from, to] range, see getEventSeries, entry must be locked.
+         */
+        static std::vector<PathLengthSeriesBucket> buildSeries_(const EventEntriesSortedByTimestamp& entry,
+                                                                uint64_t from, uint64_t to, uint64_t interval);
+
+        /**
+         * @brief Adds path lengths of raw events within [from, to] range to the sketch, entry must be locked.
+         */
+        static void addRawEventsToSketch_(const EventEntriesSortedByTimestamp& entry, uint64_t from, uint64_t to,
+                                          QuantileSketch& sketch);
+
+        /**
+         * @brief Checks rollups for writes into [from, to] range after the version, entry must be locked.
+         */
+        static bool isRollupRangeModifiedSince_(const EventEntriesSortedByTimestamp& entry, uint64_t version,
+                                                uint64_t from, uint64_t to);
+
+        /**
+         * @brief Merges pre-aggregated sketches of buckets starting within [from, to) range, entry must be locked.
+         */
+        static void mergeBucketSketches_(const PathLengthRollups& rollups,
+                                         uint64_t from, uint64_t to, QuantileSketch& sketch);
     };
+
+    using TelemetryStorage = BasicTelemetryStorage<INTERACTION_TIMES_LEN>;
 }
 
 #endif //TELEMETRY_STORAGE_H
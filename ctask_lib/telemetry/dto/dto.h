@@ -49,6 +49,100 @@ namespace ctask::telemetry::dto
         if (j.contains("endTimestamp"))
             dto.endTimestamp = j.at("endTimestamp").get<uint64_t>();
     }
+
+    /**
+     * @brief DTO for a single query of the mean interaction length batch.
+     *
+     * Same as MeanLengthQueryDto, but the event name comes within the query itself.
+     */
+    struct MeanLengthBatchQueryDto
+    {
+        std::string event;
+        MeanLengthQueryDto query;
+    };
+
+    inline void from_json(const nlohmann::json& j, dto::MeanLengthBatchQueryDto& dto)
+    {
+        j.at("event").get_to(dto.event);
+        j.get_to(dto.query);
+    }
+
+    /**
+     * @brief DTO for querying path length percentiles.
+     *
+     * Represents query parameters as received in an HTTP request.
+     * Includes an optional time range, a unit of measurement and optional percentiles list.
+     */
+    struct PercentilesQueryDto
+    {
+        std::string resultUnit; // "seconds" or "milliseconds"
+        std::optional<uint64_t> startTimestamp;
+        std::optional<uint64_t> endTimestamp;
+        std::vector<double> percentiles{50.0, 95.0, 99.0};
+    };
+
+    inline void from_json(const nlohmann::json& j, dto::PercentilesQueryDto& dto)
+    {
+        j.at("resultUnit").get_to(dto.resultUnit);
+        if (j.contains("startTimestamp"))
+            dto.startTimestamp = j.at("startTimestamp").get<uint64_t>();
+
+        if (j.contains("endTimestamp"))
+            dto.endTimestamp = j.at("endTimestamp").get<uint64_t>();
+
+        if (j.contains("percentiles"))
+            j.at("percentiles").get_to(dto.percentiles);
+    }
+
+    /**
+     * @brief DTO for querying mean interaction length per time bucket.
+     *
+     * Represents query parameters as received in an HTTP request.
+     * Includes an optional time range, a unit of measurement and bucket interval in seconds.
+     */
+    struct SeriesQueryDto
+    {
+        std::string resultUnit; // "seconds" or "milliseconds"
+        std::optional<uint64_t> startTimestamp;
+        std::optional<uint64_t> endTimestamp;
+        uint64_t interval{};
+    };
+
+    inline void from_json(const nlohmann::json& j, dto::SeriesQueryDto& dto)
+    {
+        j.at("resultUnit").get_to(dto.resultUnit);
+        j.at("interval").get_to(dto.interval);
+        if (j.contains("startTimestamp"))
+            dto.startTimestamp = j.at("startTimestamp").get<uint64_t>();
+
+        if (j.contains("endTimestamp"))
+            dto.endTimestamp = j.at("endTimestamp").get<uint64_t>();
+    }
+
+    /**
+     * @brief DTO for raw events export.
+     *
+     * Represents export parameters as received in an HTTP request.
+     * Includes an optional time range and an optional output format.
+     */
+    struct ExportQueryDto
+    {
+        std::string format{"ndjson"}; // "ndjson" or "binary"
+        std::optional<uint64_t> startTimestamp;
+        std::optional<uint64_t> endTimestamp;
+    };
+
+    inline void from_json(const nlohmann::json& j, dto::ExportQueryDto& dto)
+    {
+        if (j.contains("format"))
+            dto.format = j.at("format").get<std::string>();
+
+        if (j.contains("startTimestamp"))
+            dto.startTimestamp = j.at("startTimestamp").get<uint64_t>();
+
+        if (j.contains("endTimestamp"))
+            dto.endTimestamp = j.at("endTimestamp").get<uint64_t>();
+    }
 }
 
 #endif //TELEMETRY_DTO_H
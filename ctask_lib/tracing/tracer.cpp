@@ -0,0 +1,128 @@
+#include "tracer.h"
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace ctask::tracing
+{
+    // request id of the sampled request being handled by the thread right now
+    thread_local uint64_t activeRequestId{0};
+
+    Tracer& Tracer::instance()
+    {
+        // never destroyed, spans may be recorded by detached threads during shutdown
+        static auto* tracer{new Tracer()};
+        return *tracer;
+    }
+
+    Tracer::Tracer() : ring_(DEFAULT_CAPACITY)
+    {
+    }
+
+    void Tracer::configure(uint32_t sampleEvery, size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Trace capacity must be positive");
+        }
+
+        std::lock_guard lock(mutex_);
+        sampleEvery_.store(sampleEvery, std::memory_order_relaxed);
+        ring_.assign(capacity, Span{});
+        next_ = 0;
+        full_ = false;
+    }
+
+    uint64_t Tracer::sample() noexcept
+    {
+        const auto every{sampleEvery_.load(std::memory_order_relaxed)};
+        if (every == 0)
+        {
+            return 0;
+        }
+
+        thread_local uint32_t counter{0};
+        if (++counter < every)
+        {
+            return 0;
+        }
+        counter = 0;
+        return nextRequestId_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Tracer::record(const Span& span)
+    {
+        std::lock_guard lock(mutex_);
+        ring_[next_] = span;
+        if (++next_ == ring_.size())
+        {
+            next_ = 0;
+            full_ = true;
+        }
+    }
+
+    std::vector<Span> Tracer::spans()
+    {
+        std::lock_guard lock(mutex_);
+        std::vector<Span> result{};
+        if (full_)
+        {
+            result.insert(result.end(), ring_.begin() + static_cast<ptrdiff_t>(next_), ring_.end());
+        }
+        result.insert(result.end(), ring_.begin(), ring_.begin() + static_cast<ptrdiff_t>(next_));
+        return result;
+    }
+
+    std::string Tracer::dumpChromeTrace()
+    {
+        using namespace std::chrono;
+
+        // complete ("X") events, timestamps in microseconds, every request is a separate track (tid)
+        std::string result{R"({"displayTimeUnit":"ns","traceEvents":[)"};
+        bool first{true};
+        for (const auto& [name, requestId, start, duration] : spans())
+        {
+            result += std::format(
+                R"({}{{"name":"{}","cat":"request","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                first ? "" : ",",
+                name,
+                requestId,
+                duration_cast<nanoseconds>(start.time_since_epoch()).count() / 1000.0,
+                duration_cast<nanoseconds>(duration).count() / 1000.0
+            );
+            first = false;
+        }
+        result += "]}";
+        return result;
+    }
+
+    void Tracer::dumpChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw std::runtime_error(std::format("Can't open trace file : {}", path));
+        }
+        file << dumpChromeTrace();
+        if (!file)
+        {
+            throw std::runtime_error(std::format("Can't write trace file : {}", path));
+        }
+    }
+
+    ActiveRequestScope::ActiveRequestScope(uint64_t requestId) noexcept : previous_(activeRequestId)
+    {
+        activeRequestId = requestId;
+    }
+
+    ActiveRequestScope::~ActiveRequestScope()
+    {
+        activeRequestId = previous_;
+    }
+
+    uint64_t ActiveRequestScope::current() noexcept
+    {
+        return activeRequestId;
+    }
+}
@@ -0,0 +1,232 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ctask::tracing
+{
+    using TraceClock = std::chrono::steady_clock;
+
+    /**
+     * @struct Span
+     * @brief A single finished stage of a sampled request.
+     */
+    struct Span
+    {
+        const char* name{nullptr}; // static string, e.g. "parse"
+        uint64_t requestId{0};
+        TraceClock::time_point start{};
+        TraceClock::duration duration{};
+    };
+
+    /**
+     * @class Tracer
+     * @brief Global sampled span collector.
+     *
+     * Only every N-th request (per thread) is traced, spans of traced requests go to a fixed size ring buffer,
+     * the oldest spans are overwritten. Not sampled requests cost a thread-local counter increment.
+     * Ring buffer is guarded by a plain mutex: it is touched by sampled requests only,
+     * a handful of times per request, which is far too rare to contend.
+     *
+     * Collected spans are dumped as Chrome trace-event JSON (chrome://tracing, Perfetto),
+     * every request is drawn as its own track.
+     */
+    class Tracer
+    {
+    public:
+        static constexpr uint32_t DEFAULT_SAMPLE_EVERY{100};
+        static constexpr size_t DEFAULT_CAPACITY{65536};
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+        Tracer(Tracer&&) = delete;
+        Tracer& operator=(Tracer&&) = delete;
+
+        /**
+         * @brief Global tracer entry point
+         *
+         * @returns Tracer instance
+         */
+        static Tracer& instance();
+
+        /**
+         * @brief Sets sampling rate and ring buffer capacity, collected spans are dropped.
+         *
+         * @param sampleEvery Trace every N-th request, 0 turns tracing off.
+         * @param capacity Max amount of kept spans.
+         *
+         * @throws std::invalid_argument If capacity is zero.
+         */
+        void configure(uint32_t sampleEvery, size_t capacity);
+
+        /**
+         * @brief Decides whether the next request is traced.
+         *
+         * @return Request id for a sampled request, 0 otherwise.
+         */
+        uint64_t sample() noexcept;
+
+        /**
+         * @brief Puts the span into the ring buffer.
+         */
+        void record(const Span& span);
+
+        /**
+         * @brief Returns collected spans, oldest first.
+         */
+        std::vector<Span> spans();
+
+        /**
+         * @brief Renders collected spans as Chrome trace-event JSON.
+         */
+        std::string dumpChromeTrace();
+
+        /**
+         * @brief Writes Chrome trace-event JSON into the file.
+         *
+         * @throws std::runtime_error If the file can't be written.
+         */
+        void dumpChromeTrace(const std::string& path);
+
+    private:
+        Tracer();
+        ~Tracer() = default;
+
+        std::atomic<uint32_t> sampleEvery_{DEFAULT_SAMPLE_EVERY};
+        std::atomic<uint64_t> nextRequestId_{1};
+
+        std::mutex mutex_;
+        std::vector<Span> ring_;
+        size_t next_{0};
+        bool full_{false};
+    };
+
+    /**
+     * @class RequestTrace
+     * @brief Stages of a single request, recorded one after another.
+     *
+     * Every mark() closes the stage started by the previous mark (or construction).
+     * Works across co_await: time points are explicit, nothing is bound to the current thread.
+     * For not sampled requests every method is a no-op, the clock is never touched.
+     */
+    class RequestTrace
+    {
+    public:
+        RequestTrace() : requestId_(Tracer::instance().sample())
+        {
+            if (requestId_ != 0)
+            {
+                start_ = last_ = TraceClock::now();
+            }
+        }
+
+        ~RequestTrace() = default;
+        RequestTrace(const RequestTrace&) = delete;
+        RequestTrace& operator=(const RequestTrace&) = delete;
+        RequestTrace(RequestTrace&&) = delete;
+        RequestTrace& operator=(RequestTrace&&) = delete;
+
+        uint64_t requestId() const noexcept { return requestId_; }
+
+        /**
+         * @brief Records stage which lasted since the previous mark.
+         */
+        void mark(const char* stage)
+        {
+            if (requestId_ == 0)
+            {
+                return;
+            }
+
+            const auto now{TraceClock::now()};
+            Tracer::instance().record({stage, requestId_, last_, now - last_});
+            last_ = now;
+        }
+
+        /**
+         * @brief Records the whole request span, from construction till now.
+         */
+        void finish(const char* name = "request")
+        {
+            if (requestId_ == 0)
+            {
+                return;
+            }
+
+            Tracer::instance().record({name, requestId_, start_, TraceClock::now() - start_});
+        }
+
+    private:
+        uint64_t requestId_;
+        TraceClock::time_point start_{};
+        TraceClock::time_point last_{};
+    };
+
+    /**
+     * @class ActiveRequestScope
+     * @brief Makes the request current for the calling thread, so nested ScopedSpan can find it.
+     *
+     * Must not live across co_await, the coroutine may resume on another thread.
+     */
+    class ActiveRequestScope
+    {
+    public:
+        explicit ActiveRequestScope(uint64_t requestId) noexcept;
+        ~ActiveRequestScope();
+        ActiveRequestScope(const ActiveRequestScope&) = delete;
+        ActiveRequestScope& operator=(const ActiveRequestScope&) = delete;
+        ActiveRequestScope(ActiveRequestScope&&) = delete;
+        ActiveRequestScope& operator=(ActiveRequestScope&&) = delete;
+
+        /**
+         * @brief Returns request id of the calling thread, 0 if there is no sampled request.
+         */
+        static uint64_t current() noexcept;
+
+    private:
+        uint64_t previous_;
+    };
+
+    /**
+     * @class ScopedSpan
+     * @brief Records the scope as a span of the thread's current request, if any.
+     *
+     * Meant for code deep down the call stack (router, storage), which knows nothing about requests.
+     */
+    class ScopedSpan
+    {
+    public:
+        explicit ScopedSpan(const char* name) noexcept : name_(name), requestId_(ActiveRequestScope::current())
+        {
+            if (requestId_ != 0)
+            {
+                start_ = TraceClock::now();
+            }
+        }
+
+        ~ScopedSpan()
+        {
+            if (requestId_ != 0)
+            {
+                Tracer::instance().record({name_, requestId_, start_, TraceClock::now() - start_});
+            }
+        }
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+        ScopedSpan(ScopedSpan&&) = delete;
+        ScopedSpan& operator=(ScopedSpan&&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t requestId_;
+        TraceClock::time_point start_{};
+    };
+}
+
+#endif //TRACER_H
@@ -0,0 +1,22 @@
+#include "tracing_routes.h"
+#include "tracer.h"
+#include "network/http/router/router_builder.h"
+#include "utils/types/constants.h"
+
+namespace ctask::tracing
+{
+    using namespace ctask::utils::types;
+    using namespace ctask::utils::constants;
+
+    void TracingRoutes::registerRoutes(Router::RouterBuilder& builder)
+    {
+        builder.registerGet("/debug/trace", [](const HttpRequest&)
+        {
+            return HttpResponse{
+                HttpStatusCode::HTTP_STATUS_OK,
+                Tracer::instance().dumpChromeTrace(),
+                {{CONTENT_TYPE_HEADER, JSON_CONTENT_TYPE}}
+            };
+        });
+    }
+}
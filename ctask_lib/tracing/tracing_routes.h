@@ -0,0 +1,41 @@
+#ifndef TRACING_ROUTES_H
+#define TRACING_ROUTES_H
+
+namespace ctask::network::http::router
+{
+    class RouterBuilder;
+}
+
+namespace ctask::tracing
+{
+    namespace Router = network::http::router;
+
+    /**
+     * @class TracingRoutes
+     * @brief Static utility class for registering tracing admin HTTP routes.
+     *
+     * GET /debug/trace returns collected spans as Chrome trace-event JSON,
+     * save it and open with chrome://tracing or https://ui.perfetto.dev
+     *
+     * This class is non-instantiable and non-copyable.
+     */
+    class TracingRoutes
+    {
+    public:
+        TracingRoutes() = delete;
+        TracingRoutes(const TracingRoutes&) = delete;
+        TracingRoutes(TracingRoutes&&) = delete;
+        TracingRoutes& operator=(const TracingRoutes&) = delete;
+        TracingRoutes& operator=(TracingRoutes&&) = delete;
+        ~TracingRoutes() = delete;
+
+        /**
+         * @brief Registers tracing routes.
+         *
+         * @param builder Router builder instance for route registration.
+         */
+        static void registerRoutes(Router::RouterBuilder& builder);
+    };
+}
+
+#endif //TRACING_ROUTES_H
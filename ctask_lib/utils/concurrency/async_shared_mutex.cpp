@@ -0,0 +1,186 @@
+#include "async_shared_mutex.h"
+
+#include <condition_variable>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ctask::utils::concurrency
+{
+    namespace
+    {
+        // set on the threads which run executors, see NonBlockingThreadScope
+        thread_local bool nonBlockingThread{false};
+    }
+
+    AsyncSharedMutex::NonBlockingThreadScope::NonBlockingThreadScope() : previous_(nonBlockingThread)
+    {
+        nonBlockingThread = true;
+    }
+
+    AsyncSharedMutex::NonBlockingThreadScope::~NonBlockingThreadScope()
+    {
+        nonBlockingThread = previous_;
+    }
+
+    auto AsyncSharedMutex::asyncWait_(bool exclusive)
+    {
+        return asio::async_initiate<decltype(asio::use_awaitable), void()>(
+            [this, exclusive](auto handler)
+            {
+                // std::function needs a copyable target, the handler is move-only
+                auto shared{std::make_shared<decltype(handler)>(std::move(handler))};
+                acquireOrEnqueue_(exclusive, [shared]() { asio::post(std::move(*shared)); });
+            }, asio::use_awaitable);
+    }
+
+    asio::awaitable<std::unique_lock<AsyncSharedMutex>> AsyncSharedMutex::asyncLock()
+    {
+        if (!try_lock())
+        {
+            co_await asyncWait_(true);
+        }
+        co_return std::unique_lock{*this, std::adopt_lock};
+    }
+
+    asio::awaitable<std::shared_lock<AsyncSharedMutex>> AsyncSharedMutex::asyncLockShared()
+    {
+        if (!try_lock_shared())
+        {
+            co_await asyncWait_(false);
+        }
+        co_return std::shared_lock{*this, std::adopt_lock};
+    }
+
+    void AsyncSharedMutex::lock()
+    {
+        if (!try_lock())
+        {
+            blockingAcquire_(true);
+        }
+    }
+
+    bool AsyncSharedMutex::try_lock()
+    {
+        std::lock_guard lock{mutex_};
+        return tryAcquire_(true);
+    }
+
+    void AsyncSharedMutex::unlock()
+    {
+        std::unique_lock lock{mutex_};
+        writer_ = false;
+        release_(lock);
+    }
+
+    void AsyncSharedMutex::lock_shared()
+    {
+        if (!try_lock_shared())
+        {
+            blockingAcquire_(false);
+        }
+    }
+
+    bool AsyncSharedMutex::try_lock_shared()
+    {
+        std::lock_guard lock{mutex_};
+        return tryAcquire_(false);
+    }
+
+    void AsyncSharedMutex::unlock_shared()
+    {
+        std::unique_lock lock{mutex_};
+        --readers_;
+        release_(lock);
+    }
+
+    bool AsyncSharedMutex::tryAcquire_(bool exclusive) noexcept
+    {
+        if (!waiters_.empty() || writer_)
+        {
+            return false;
+        }
+
+        if (exclusive)
+        {
+            if (readers_ != 0)
+            {
+                return false;
+            }
+            writer_ = true;
+            return true;
+        }
+
+        ++readers_;
+        return true;
+    }
+
+    void AsyncSharedMutex::acquireOrEnqueue_(bool exclusive, std::function<void()> resume)
+    {
+        {
+            std::lock_guard lock{mutex_};
+            if (!tryAcquire_(exclusive))
+            {
+                waiters_.push_back({exclusive, std::move(resume)});
+                return;
+            }
+        }
+
+        // the lock was released meanwhile
+        resume();
+    }
+
+    void AsyncSharedMutex::blockingAcquire_(bool exclusive)
+    {
+        // the lock may be handed over to a coroutine first, which resumes only through a free executor thread,
+        // checked in every build, a blocked io thread would hang the server instead of failing the request
+        if (nonBlockingThread)
+        {
+            throw std::logic_error("Blocking wait for AsyncSharedMutex on an executor thread");
+        }
+
+        std::mutex grantedMutex;
+        std::condition_variable grantedCv;
+        bool granted{false};
+
+        acquireOrEnqueue_(exclusive, [&]()
+        {
+            // notified under the mutex, the waiter can't return and destroy the condition variable before
+            std::lock_guard lock{grantedMutex};
+            granted = true;
+            grantedCv.notify_one();
+        });
+
+        std::unique_lock lock{grantedMutex};
+        grantedCv.wait(lock, [&granted]() { return granted; });
+    }
+
+    void AsyncSharedMutex::release_(std::unique_lock<std::mutex>& lock)
+    {
+        std::vector<std::function<void()>> granted{};
+        while (!waiters_.empty() && !writer_)
+        {
+            auto& waiter{waiters_.front()};
+            if (waiter.exclusive)
+            {
+                if (readers_ != 0)
+                {
+                    break;
+                }
+                writer_ = true;
+            }
+            else
+            {
+                ++readers_;
+            }
+            granted.push_back(std::move(waiter.resume));
+            waiters_.pop_front();
+        }
+        lock.unlock();
+
+        for (auto& resume : granted)
+        {
+            resume();
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef ASYNC_SHARED_MUTEX_H
+#define ASYNC_SHARED_MUTEX_H
+
+#include <asio.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+
+namespace ctask::utils::concurrency
+{
+    /**
+     * @class AsyncSharedMutex
+     * @brief Reader/writer lock which coroutines wait for without blocking their thread.
+     *
+     * A coroutine which can't take the lock right away is queued and suspended, the io thread goes on
+     * serving other connections. Unlock hands the lock over to the queued waiters directly and posts them
+     * to their own executors, so a waiter resumes already owning the lock, on the thread it came from.
+     *
+     * Waiters are served in arrival order, consecutive readers are admitted together. Newcomers queue up
+     * behind waiters even if the lock is free for them, so a stream of readers can't starve a writer.
+     *
+     * Plain threads can use it as a regular SharedMutex (std::shared_lock, std::unique_lock),
+     * they are queued along with coroutines and block until the lock is handed over to them.
+     * Blocking lock()/lock_shared() must never be called on a thread running an executor: a coroutine
+     * queued in front could only resume (and unlock) through that very thread, which is blocked.
+     * Such threads are marked with NonBlockingThreadScope and a blocking wait there throws std::logic_error,
+     * an uncontended lock() is still fine as it doesn't wait.
+     *
+     * The state is guarded by a std::mutex held for a few instructions, never while the lock is owned.
+     */
+    class AsyncSharedMutex
+    {
+    public:
+        /**
+         * @class NonBlockingThreadScope
+         * @brief Marks the current thread as an executor thread, which must not wait for the lock blocked.
+         */
+        class NonBlockingThreadScope
+        {
+        public:
+            NonBlockingThreadScope();
+            ~NonBlockingThreadScope();
+            NonBlockingThreadScope(const NonBlockingThreadScope&) = delete;
+            NonBlockingThreadScope& operator=(const NonBlockingThreadScope&) = delete;
+
+        private:
+            bool previous_;
+        };
+
+        AsyncSharedMutex() = default;
+        ~AsyncSharedMutex() = default;
+        AsyncSharedMutex(const AsyncSharedMutex&) = delete;
+        AsyncSharedMutex& operator=(const AsyncSharedMutex&) = delete;
+        AsyncSharedMutex(AsyncSharedMutex&&) = delete;
+        AsyncSharedMutex& operator=(AsyncSharedMutex&&) = delete;
+
+        /**
+         * @brief Takes the lock exclusively, suspends the coroutine while it's taken by others.
+         *
+         * @return Lock owning the mutex.
+         */
+        asio::awaitable<std::unique_lock<AsyncSharedMutex>> asyncLock();
+
+        /**
+         * @brief Takes the lock shared, suspends the coroutine while it's taken exclusively or a writer waits.
+         *
+         * @return Lock owning the mutex.
+         */
+        asio::awaitable<std::shared_lock<AsyncSharedMutex>> asyncLockShared();
+
+        // SharedMutex requirements, blocking versions for plain threads,
+        // lock and lock_shared throw std::logic_error if they'd wait within NonBlockingThreadScope
+        void lock();
+        bool try_lock();
+        void unlock();
+        void lock_shared();
+        bool try_lock_shared();
+        void unlock_shared();
+
+    private:
+        /**
+         * @struct Waiter
+         * @brief Queued acquisition, resume is called once the lock is handed over, outside of mutex_.
+         */
+        struct Waiter
+        {
+            bool exclusive{false};
+            std::function<void()> resume{};
+        };
+
+        /**
+         * @brief Suspends the coroutine until the lock is handed over, it resumes on its own executor.
+         */
+        auto asyncWait_(bool exclusive);
+
+        /**
+         * @brief Takes the lock if nobody owns or waits for it conflicting, mutex_ must be locked.
+         */
+        bool tryAcquire_(bool exclusive) noexcept;
+
+        /**
+         * @brief Takes the lock or queues the waiter, resume is called in both cases.
+         */
+        void acquireOrEnqueue_(bool exclusive, std::function<void()> resume);
+
+        /**
+         * @brief Blocks the calling thread until the lock is handed over.
+         *
+         * @throws std::logic_error Within NonBlockingThreadScope, nothing is queued then.
+         */
+        void blockingAcquire_(bool exclusive);
+
+        /**
+         * @brief Hands the free lock over to the waiters in front of the queue and wakes them.
+         */
+        void release_(std::unique_lock<std::mutex>& lock);
+
+        std::mutex mutex_;
+        size_t readers_{0};
+        bool writer_{false};
+        std::deque<Waiter> waiters_;
+    };
+}
+
+#endif //ASYNC_SHARED_MUTEX_H
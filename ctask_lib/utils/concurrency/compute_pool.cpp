@@ -0,0 +1,116 @@
+#include "compute_pool.h"
+
+#include <algorithm>
+
+namespace ctask::utils::concurrency
+{
+    namespace
+    {
+        // lets a worker find its own deque when it submits nested work
+        thread_local const ComputePool* currentPool{nullptr};
+        thread_local size_t currentWorker{0};
+    }
+
+    ComputePool::ComputePool(size_t threads)
+    {
+        threads = std::max<size_t>(threads, 1);
+        workers_.reserve(threads);
+        for (size_t i{0}; i < threads; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+
+        threads_.reserve(threads);
+        for (size_t i{0}; i < threads; ++i)
+        {
+            threads_.emplace_back([this, i](std::stop_token stopToken) { workerRoutine_(i, std::move(stopToken)); });
+        }
+    }
+
+    ComputePool::~ComputePool()
+    {
+        for (auto& thread : threads_)
+        {
+            thread.request_stop();
+        }
+        {
+            std::lock_guard lock{sleepMutex_};
+        }
+        sleepCv_.notify_all();
+        threads_.clear();
+    }
+
+    void ComputePool::push_(std::unique_ptr<TaskBase> task)
+    {
+        const auto target{
+            currentPool == this ? currentWorker : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()
+        };
+
+        // counted before it's queued, so a worker never takes it while it's not counted yet
+        pending_.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard lock{workers_[target]->mutex};
+            workers_[target]->tasks.push_back(std::move(task));
+        }
+
+        // taking the sleep mutex orders the increment with a worker checking it before going to sleep
+        {
+            std::lock_guard lock{sleepMutex_};
+        }
+        sleepCv_.notify_one();
+    }
+
+    std::unique_ptr<ComputePool::TaskBase> ComputePool::pop_(size_t self)
+    {
+        {
+            auto& own{*workers_[self]};
+            std::lock_guard lock{own.mutex};
+            if (!own.tasks.empty())
+            {
+                auto task{std::move(own.tasks.back())};
+                own.tasks.pop_back();
+                return task;
+            }
+        }
+
+        // steal the oldest task, start from the neighbour, so thieves spread over victims
+        for (size_t shift{1}; shift < workers_.size(); ++shift)
+        {
+            auto& victim{*workers_[(self + shift) % workers_.size()]};
+            std::lock_guard lock{victim.mutex};
+            if (!victim.tasks.empty())
+            {
+                auto task{std::move(victim.tasks.front())};
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void ComputePool::workerRoutine_(size_t self, std::stop_token stopToken)
+    {
+        currentPool = this;
+        currentWorker = self;
+
+        for (;;)
+        {
+            if (auto task{pop_(self)})
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                task->run();
+                continue;
+            }
+
+            std::unique_lock lock{sleepMutex_};
+            sleepCv_.wait(lock, stopToken, [this]() { return pending_.load(std::memory_order_acquire) != 0; });
+
+            // queued tasks are finished before the pool goes away
+            if (stopToken.stop_requested() && pending_.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+}
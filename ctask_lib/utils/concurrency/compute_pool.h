@@ -0,0 +1,181 @@
+#ifndef COMPUTE_POOL_H
+#define COMPUTE_POOL_H
+
+#include "parallel_for.h"
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ctask::utils::concurrency
+{
+    /**
+     * @class ComputePool
+     * @brief Work-stealing thread pool for CPU heavy work, kept away from the io threads.
+     *
+     * Every worker owns a deque of tasks: it takes its own tasks from the back (the freshest ones,
+     * still hot in cache), idle workers steal from the front of the others. Tasks submitted by a worker
+     * go to its own deque, so nested work (parallelFor inside a task) stays local unless somebody is idle.
+     * Tasks from other threads are spread round-robin. Deques are guarded by their own tiny mutexes,
+     * a worker and a thief meet on a single deque at most.
+     *
+     * Coroutines offload work with co_await run(fn): fn runs on the pool and the coroutine resumes
+     * on its own executor, so the io thread is free while fn runs.
+     */
+    class ComputePool
+    {
+    public:
+        /**
+         * @param threads Amount of worker threads, at least one is started.
+         */
+        explicit ComputePool(size_t threads);
+
+        /**
+         * @brief Finishes the queued tasks and stops the workers.
+         */
+        ~ComputePool();
+        ComputePool(const ComputePool&) = delete;
+        ComputePool& operator=(const ComputePool&) = delete;
+        ComputePool(ComputePool&&) = delete;
+        ComputePool& operator=(ComputePool&&) = delete;
+
+        /**
+         * @brief Queues fn() to be run by a worker, fn must not throw.
+         */
+        template <typename Fn>
+        void submit(Fn&& fn)
+        {
+            push_(std::make_unique<Task<std::decay_t<Fn>>>(std::forward<Fn>(fn)));
+        }
+
+        /**
+         * @brief Runs fn() on the pool, the awaiting coroutine resumes on its own executor with the result.
+         *
+         * @return What fn returns.
+         * @throws What fn throws.
+         */
+        template <typename Fn>
+        auto run(Fn fn) -> asio::awaitable<std::invoke_result_t<Fn&>>;
+
+        /**
+         * @brief parallelFor over the pool threads, the caller takes part in the work.
+         */
+        template <typename Fn>
+        void parallelFor(size_t count, Fn&& fn)
+        {
+            parallelForWith([this](auto helper) { submit(std::move(helper)); }, count, threads_.size(),
+                            std::forward<Fn>(fn));
+        }
+
+        size_t threads() const noexcept { return threads_.size(); }
+
+        /**
+         * @brief Amount of tasks taken from other workers' deques.
+         */
+        uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+    private:
+        struct TaskBase
+        {
+            virtual ~TaskBase() = default;
+            virtual void run() = 0;
+        };
+
+        // move-only type erasure, asio completion handlers can't be copied into std::function
+        template <typename Fn>
+        struct Task final : TaskBase
+        {
+            explicit Task(Fn fn) : fn(std::move(fn))
+            {
+            }
+
+            void run() override { fn(); }
+
+            Fn fn;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<std::unique_ptr<TaskBase>> tasks;
+        };
+
+        void push_(std::unique_ptr<TaskBase> task);
+        std::unique_ptr<TaskBase> pop_(size_t self);
+        void workerRoutine_(size_t self, std::stop_token stopToken);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::atomic<size_t> nextWorker_{0};
+        std::atomic<size_t> pending_{0};
+        std::atomic<uint64_t> steals_{0};
+
+        std::mutex sleepMutex_;
+        std::condition_variable_any sleepCv_;
+
+        // the last member, workers must stop before the deques go away
+        std::vector<std::jthread> threads_;
+    };
+
+    template <typename Fn>
+    auto ComputePool::run(Fn fn) -> asio::awaitable<std::invoke_result_t<Fn&>>
+    {
+        using Result = std::invoke_result_t<Fn&>;
+
+        if constexpr (std::is_void_v<Result>)
+        {
+            co_await asio::async_initiate<decltype(asio::use_awaitable), void(std::exception_ptr)>(
+                [this, &fn](auto handler)
+                {
+                    submit([fn = std::move(fn), handler = std::move(handler)]() mutable
+                    {
+                        std::exception_ptr error{};
+                        try
+                        {
+                            fn();
+                        }
+                        catch (...)
+                        {
+                            error = std::current_exception();
+                        }
+                        auto executor{asio::get_associated_executor(handler)};
+                        asio::post(executor, [handler = std::move(handler), error]() mutable { handler(error); });
+                    });
+                }, asio::use_awaitable);
+        }
+        else
+        {
+            co_return co_await asio::async_initiate<decltype(asio::use_awaitable), void(std::exception_ptr, Result)>(
+                [this, &fn](auto handler)
+                {
+                    submit([fn = std::move(fn), handler = std::move(handler)]() mutable
+                    {
+                        std::exception_ptr error{};
+                        Result result{};
+                        try
+                        {
+                            result = fn();
+                        }
+                        catch (...)
+                        {
+                            error = std::current_exception();
+                        }
+                        auto executor{asio::get_associated_executor(handler)};
+                        asio::post(executor, [handler = std::move(handler), error, result = std::move(result)]() mutable
+                        {
+                            handler(error, std::move(result));
+                        });
+                    });
+                }, asio::use_awaitable);
+        }
+    }
+}
+
+#endif //COMPUTE_POOL_H
@@ -0,0 +1,113 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <memory>
+#include <exception>
+
+namespace ctask::utils::concurrency
+{
+    /**
+     * @brief Runs fn(i) for every i in [0, count), spreading the work over the executor's threads.
+     *
+     * Helpers are posted to the executor and grab indices from a shared counter, the caller
+     * grabs indices too. So if every executor thread is busy (or the caller is one of them),
+     * the caller simply does all the work itself — nobody ever waits for work that hasn't started,
+     * which means no deadlock when called from the io threads themselves.
+     * The caller only waits for indices that are being processed right now by other threads.
+     *
+     * Helpers that start after everything is done just leave, fn is never touched after return.
+     *
+     * @param executor Executor to post helpers to.
+     * @param count Number of work items.
+     * @param maxHelpers Max number of helpers to post, the caller is not counted.
+     * @param fn Work item function, called with the item index.
+     *
+     * @throws First exception thrown by fn, once all started items are finished.
+     */
+    template <typename Post, typename Fn>
+    void parallelForWith(Post&& post, size_t count, size_t maxHelpers, Fn&& fn);
+
+    template <typename Executor, typename Fn>
+    void parallelFor(const Executor& executor, size_t count, size_t maxHelpers, Fn&& fn)
+    {
+        parallelForWith([&executor](auto helper) { asio::post(executor, std::move(helper)); },
+                        count, maxHelpers, std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief The same as parallelFor, helpers are handed to post(helper) instead of an asio executor.
+     *
+     * Lets thread pools of other kinds run the helpers, e.g. ComputePool.
+     */
+    template <typename Post, typename Fn>
+    void parallelForWith(Post&& post, size_t count, size_t maxHelpers, Fn&& fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        struct SharedState
+        {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> finished{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr error{};
+            size_t count{0};
+            std::remove_reference_t<Fn>* fn{nullptr};
+        };
+
+        auto state{std::make_shared<SharedState>()};
+        state->count = count;
+        state->fn = &fn;
+
+        auto work = [](SharedState& s)
+        {
+            for (size_t i{s.next.fetch_add(1, std::memory_order_relaxed)}; i < s.count;
+                 i = s.next.fetch_add(1, std::memory_order_relaxed))
+            {
+                try
+                {
+                    (*s.fn)(i);
+                }
+                catch (...)
+                {
+                    if (!s.failed.exchange(true))
+                    {
+                        s.error = std::current_exception();
+                    }
+                }
+
+                if (s.finished.fetch_add(1, std::memory_order_acq_rel) + 1 == s.count)
+                {
+                    s.finished.notify_one();
+                }
+            }
+        };
+
+        const auto helpers{std::min(count - 1, maxHelpers)};
+        for (size_t i{0}; i < helpers; ++i)
+        {
+            post([state, work]() { work(*state); });
+        }
+
+        work(*state);
+
+        // wait for items grabbed by helpers
+        for (auto finished{state->finished.load(std::memory_order_acquire)}; finished != count;
+             finished = state->finished.load(std::memory_order_acquire))
+        {
+            state->finished.wait(finished, std::memory_order_acquire);
+        }
+
+        if (state->error)
+        {
+            std::rethrow_exception(state->error);
+        }
+    }
+}
+
+#endif //PARALLEL_FOR_H
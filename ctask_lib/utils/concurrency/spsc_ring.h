@@ -0,0 +1,107 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ctask::utils::concurrency
+{
+    /**
+     * @class SpscRing
+     * @brief Bounded lock-free queue of a single producer and a single consumer.
+     *
+     * Positions only grow, the producer publishes the tail with a release store and the consumer
+     * the head, so neither side ever writes what the other one writes. Both sides keep a cached copy
+     * of the other side's position and reread it only when the ring looks full (empty),
+     * a push or pop usually touches a single shared cache line.
+     *
+     * @tparam T Movable, default constructible item.
+     */
+    template <typename T>
+    class SpscRing
+    {
+    public:
+        /**
+         * @param capacity Amount of items, rounded up to a power of two.
+         *
+         * @throws std::invalid_argument If capacity is zero.
+         */
+        explicit SpscRing(size_t capacity) :
+            mask_(capacity == 0 ? 0 : std::bit_ceil(capacity) - 1)
+        {
+            if (capacity == 0)
+            {
+                throw std::invalid_argument("Ring capacity must be greater than zero");
+            }
+            items_ = std::make_unique<T[]>(mask_ + 1);
+        }
+
+        ~SpscRing() = default;
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+        SpscRing(SpscRing&&) = delete;
+        SpscRing& operator=(SpscRing&&) = delete;
+
+        /**
+         * @brief Moves the item into the ring, producer side.
+         *
+         * @return false if the ring is full, the item is left untouched then.
+         */
+        bool tryPush(T& item) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const auto tail{tail_.load(std::memory_order_relaxed)};
+            if (tail - cachedHead_ > mask_)
+            {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ > mask_)
+                {
+                    return false;
+                }
+            }
+            items_[tail & mask_] = std::move(item);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Moves the oldest item out, consumer side.
+         *
+         * @return false if the ring is empty.
+         */
+        bool tryPop(T& item) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const auto head{head_.load(std::memory_order_relaxed)};
+            if (head == cachedTail_)
+            {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_)
+                {
+                    return false;
+                }
+            }
+            item = std::move(items_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+    private:
+        const size_t mask_;
+        std::unique_ptr<T[]> items_;
+
+        // producer's line : its position and what it knows about the consumer
+        alignas(64) std::atomic<size_t> tail_{0};
+        size_t cachedHead_{0};
+
+        // consumer's line
+        alignas(64) std::atomic<size_t> head_{0};
+        size_t cachedTail_{0};
+    };
+}
+
+#endif //SPSC_RING_H
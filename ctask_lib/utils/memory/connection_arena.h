@@ -0,0 +1,62 @@
+#ifndef CONNECTION_ARENA_H
+#define CONNECTION_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace ctask::utils::memory
+{
+    /**
+     * @class ConnectionArena
+     * @brief Per-connection bump allocator for objects living no longer than a single request.
+     *
+     * Allocations are carved out of the inline buffer, so a connection which lives in a coroutine
+     * frame gets its scratch memory together with the frame. Nothing is freed one by one,
+     * reset() drops everything at once when the request is done. If a request needs more than
+     * the buffer, the rest comes from the upstream resource and is given back on reset().
+     *
+     * Not thread-safe, a connection is served by one coroutine at a time anyway.
+     *
+     * @tparam BufferLen Size of the inline buffer, big enough for a typical response.
+     */
+    template <size_t BufferLen>
+    class ConnectionArena
+    {
+    public:
+        /**
+         * @param upstream Where memory comes from once the inline buffer is exhausted.
+         */
+        explicit ConnectionArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+            resource_(buffer_.data(), buffer_.size(), upstream)
+        {
+        }
+
+        ~ConnectionArena() = default;
+        ConnectionArena(const ConnectionArena&) = delete;
+        ConnectionArena& operator=(const ConnectionArena&) = delete;
+        ConnectionArena(ConnectionArena&&) = delete;
+        ConnectionArena& operator=(ConnectionArena&&) = delete;
+
+        std::pmr::memory_resource* resource() noexcept
+        {
+            return &resource_;
+        }
+
+        /**
+         * @brief Forgets every allocation, the next one starts from the beginning of the buffer.
+         *
+         * Everything allocated from the arena must be already destroyed.
+         */
+        void reset() noexcept
+        {
+            resource_.release();
+        }
+
+    private:
+        alignas(std::max_align_t) std::array<std::byte, BufferLen> buffer_;
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+}
+
+#endif //CONNECTION_ARENA_H
@@ -73,6 +73,36 @@ namespace ctask::utils::misc
         return (it != methodMap.end()) ? it->second : HttpMethod::UNKNOWN_METHOD;
     }
 
+    /**
+     * @brief Checks whether a comma separated header value (e.g. Connection) contains the token, ignoring case.
+     */
+    static bool hasHeaderToken(std::string_view value, std::string_view token)
+    {
+        while (!value.empty())
+        {
+            const auto comma{value.find(',')};
+            auto item{value.substr(0, comma)};
+            while (!item.empty() && (item.front() == ' ' || item.front() == '\t'))
+            {
+                item.remove_prefix(1);
+            }
+            while (!item.empty() && (item.back() == ' ' || item.back() == '\t'))
+            {
+                item.remove_suffix(1);
+            }
+            if (CaseInsensitiveEqual{}(item, token))
+            {
+                return true;
+            }
+            if (comma == std::string_view::npos)
+            {
+                break;
+            }
+            value.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+
     /**
      * @brief Returns a human-friendly name for the given HTTP status code.
      */
@@ -84,6 +114,7 @@ namespace ctask::utils::misc
             {HttpStatusCode::HTTP_STATUS_NOT_FOUND, "NOT_FOUND"},
             {HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR, "INTERNAL_SERVER_ERROR"},
             {HttpStatusCode::HTTP_STATUS_NOT_IMPLEMENTED, "NOT_IMPLEMENTED"},
+            {HttpStatusCode::HTTP_STATUS_SERVICE_UNAVAILABLE, "SERVICE_UNAVAILABLE"},
         };
         const auto it{codesNames.find(code)};
         return (it != codesNames.end()) ? it->second : "UNKNOWN_CODE_NAME";
@@ -100,6 +131,7 @@ namespace ctask::utils::misc
             {HttpStatusCode::HTTP_STATUS_NOT_FOUND, "404"},
             {HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR, "500"},
             {HttpStatusCode::HTTP_STATUS_NOT_IMPLEMENTED, "501"},
+            {HttpStatusCode::HTTP_STATUS_SERVICE_UNAVAILABLE, "503"},
         };
         const auto it{codesMap.find(code)};
         return (it != codesMap.end()) ? it->second : "UNKNOWN_CODE";
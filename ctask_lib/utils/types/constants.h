@@ -6,12 +6,18 @@
 namespace ctask::utils::constants
 {
     constexpr const char* JSON_CONTENT_TYPE{"application/json"};
+    constexpr const char* PROMETHEUS_CONTENT_TYPE{"text/plain; version=0.0.4; charset=utf-8"};
 
     constexpr const char* CONTENT_LENGTH_HEADER{"Content-Length"};
     constexpr const char* CONTENT_TYPE_HEADER{"Content-Type"};
+    constexpr const char* TRANSFER_ENCODING_HEADER{"Transfer-Encoding"};
+    constexpr const char* CHUNKED_TRANSFER_ENCODING{"chunked"};
 
     constexpr const char* CONNECTION_HEADER{"Connection"};
     constexpr const char* KEEP_ALIVE_CONNECTION{"Keep-Alive"};
+    constexpr const char* KEEP_ALIVE_HEADER{"Keep-Alive"};
+    constexpr const char* CLOSE_CONNECTION{"close"};
+    constexpr const char* RETRY_AFTER_HEADER{"Retry-After"};
 }
 
 #endif //CONSTANTS_H
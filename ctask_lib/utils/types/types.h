@@ -1,13 +1,34 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <asio.hpp>
+
 #include <string>
+#include <string_view>
+#include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <memory_resource>
+#include <optional>
 #include <unordered_map>
 
 namespace ctask::utils::types
 {
+    /**
+    * @struct AdmissionLimits
+    * @brief Overload protection limits of the HTTP server, 0 means unlimited.
+    *
+    * Connections over maxConnections get 503 right after accept.
+    * Requests over maxInFlightRequests, or over maxQueueDepth requests waiting for a free io thread,
+    * get 503 without being parsed, the connection stays open.
+    */
+    struct AdmissionLimits
+    {
+        size_t maxConnections{0};
+        size_t maxInFlightRequests{0};
+        size_t maxQueueDepth{0};
+    };
+
     /**
     * @struct HttpServerArgs
     * @brief Arguments required to configure and run the HTTP server.
@@ -15,6 +36,7 @@ namespace ctask::utils::types
     * Just the basics — nothing fancy.
     * Address to bind, port to listen on, keep-alive period
     * and number of threads to handle requests.
+    * A persistent connection is closed after keepAliveMaxRequests requests, 0 means never.
     */
     struct HttpServerArgs
     {
@@ -22,17 +44,88 @@ namespace ctask::utils::types
         uint16_t port;
         size_t threads;
         uint16_t keepAliveSec;
+        size_t keepAliveMaxRequests{0};
+        AdmissionLimits admission{};
     };
 
     /**
     * @struct LoggerArgs
     * @brief Arguments required to logger.
     *
-    * Just the level :)
+    * Level, what to do when a thread's log ring is full ("block", "overrun_oldest", "discard_new"),
+    * records per thread ring and an optional rotating log file (empty path keeps console only).
     */
     struct LoggerArgs
     {
         std::string level;
+        std::string overflowPolicy{"block"};
+        size_t ringCapacity{4096};
+        std::string filePath{};
+        size_t fileMaxSize{64 * 1024 * 1024};
+        size_t fileMaxFiles{3};
+    };
+
+    /**
+    * @struct CacheArgs
+    * @brief Arguments of query results cache.
+    *
+    * Max amount of cached meanLength results, 0 turns the cache off.
+    */
+    struct CacheArgs
+    {
+        size_t meanLengthCapacity;
+    };
+
+    /**
+    * @struct TracingArgs
+    * @brief Arguments of request tracing.
+    *
+    * Every N-th request is traced (0 turns tracing off), last spans are kept in memory
+    * and written to the dump file on SIGUSR1.
+    */
+    struct TracingArgs
+    {
+        uint32_t sampleEvery;
+        size_t capacity;
+        std::string dumpPath;
+    };
+
+    /**
+    * @struct ComputeArgs
+    * @brief Arguments of the compute pool, which runs heavy queries off the io threads.
+    *
+    * Amount of worker threads, 0 means one per core.
+    */
+    struct ComputeArgs
+    {
+        size_t threads{0};
+    };
+
+    /**
+    * @struct IngestArgs
+    * @brief Arguments of the ingest pipeline.
+    *
+    * Whether POST handlers queue events for writer threads instead of storing them themselves,
+    * when the client gets the answer ("enqueued" or "applied"), amount of writer threads
+    * and events queued per io thread.
+    */
+    struct IngestArgs
+    {
+        bool pipeline{false};
+        std::string ack{"enqueued"};
+        size_t writers{1};
+        size_t queueCapacity{8192};
+    };
+
+    /**
+    * @struct TelemetryArgs
+    * @brief Arguments of the telemetry storage.
+    *
+    * Length of interaction times the service accepts, one of the compiled families.
+    */
+    struct TelemetryArgs
+    {
+        size_t interactionTimesLen{10};
     };
 
     /**
@@ -45,6 +138,11 @@ namespace ctask::utils::types
     {
         HttpServerArgs serverArgs{};
         LoggerArgs loggerArgs{};
+        CacheArgs cacheArgs{};
+        TracingArgs tracingArgs{};
+        ComputeArgs computeArgs{};
+        IngestArgs ingestArgs{};
+        TelemetryArgs telemetryArgs{};
     };
 
     // Some of these structures might seem excessive, but I added them to keep
@@ -74,21 +172,87 @@ namespace ctask::utils::types
     using ParameterName = std::string;
     using ParameterValue = std::string;
 
+    /**
+     * @struct StringHash
+     * @brief Transparent string hash.
+     *
+     * Together with std::equal_to<> lets unordered containers keyed by std::string
+     * be searched by std::string_view or a literal, without building a temporary key string.
+     */
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const noexcept
+        {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    /**
+     * @struct CaseInsensitiveHash
+     * @brief Transparent hash ignoring ASCII case, HTTP header names are case-insensitive.
+     */
+    struct CaseInsensitiveHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const noexcept
+        {
+            // FNV-1a over lowered characters
+            size_t hash{14695981039346656037ull};
+            for (const auto c : value)
+            {
+                hash ^= static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    };
+
+    /**
+     * @struct CaseInsensitiveEqual
+     * @brief Transparent equality ignoring ASCII case, goes together with CaseInsensitiveHash.
+     */
+    struct CaseInsensitiveEqual
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const noexcept
+        {
+            auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+            return lhs.size() == rhs.size() &&
+                std::equal(lhs.begin(), lhs.end(), rhs.begin(), [&lower](char l, char r) { return lower(l) == lower(r); });
+        }
+    };
+
+    /**
+     * @brief Request containers, allocator-aware, so the whole request can live in a per-connection arena.
+     *
+     * Header names keep the case they came with, but are found by any case.
+     */
+    using HttpHeaders = std::pmr::unordered_map<std::pmr::string, std::pmr::string,
+                                                CaseInsensitiveHash, CaseInsensitiveEqual>;
+    using HttpParameters = std::pmr::unordered_map<std::pmr::string, std::pmr::string, StringHash, std::equal_to<>>;
+
     /**
      * @struct HttpRequest
      * @brief Represents an HTTP request.
      *
      * This structure holds all necessary information about an HTTP request,
      * including the method, path, version, headers, and body.
+     *
+     * All members take memory from the same resource (the default one unless the parser was given another),
+     * a request is short-lived, so anything which has to outlive it must be copied out.
      */
     struct HttpRequest
     {
         HttpMethod method{HttpMethod::UNKNOWN_METHOD};
-        std::string path{};
-        std::string version{};
-        std::unordered_map<HttpHeaderField, HttpHeaderValue> headers{};
-        std::unordered_map<ParameterName, ParameterValue> parameters{};
-        std::string body{};
+        std::pmr::string path{};
+        std::pmr::string version{};
+        HttpHeaders headers{};
+        HttpParameters parameters{};
+        std::pmr::string body{};
     };
 
     /**
@@ -102,20 +266,52 @@ namespace ctask::utils::types
         HTTP_STATUS_NOT_FOUND = 404,
         HTTP_STATUS_INTERNAL_SERVER_ERROR = 500,
         HTTP_STATUS_NOT_IMPLEMENTED = 501,
+        HTTP_STATUS_SERVICE_UNAVAILABLE = 503,
     };
 
+    /**
+     * @brief Lambda alias for producing a response body piece by piece.
+     *
+     * Works like a generator: each call fills the passed chunk with the next portion of the body
+     * and returns true, false means the body is exhausted. The chunk string is owned by the caller
+     * and reused between calls, so a producer can just assign/append into it without fresh allocations.
+     *
+     * The producer is awaited on the io thread of the connection, so it must never block it:
+     * storage is read through its awaitable API, heavy work is offloaded to the compute pool.
+     */
+    using HttpBodyStreamFn = std::function<asio::awaitable<bool>(std::string& chunk)>;
+
     /**
      * @struct HttpResponse
      * @brief Final HTTP response to be sent to the client.
      *
      * Will be serialized into raw HTTP format and written to the socket.
      * Minimal on purpose — just status and body and headers for now.
+     *
+     * If bodyStream is set, message is ignored and the body is pulled from the stream
+     * chunk by chunk and sent with chunked transfer encoding, so big results never
+     * have to be built in memory as a whole.
      */
     struct HttpResponse
     {
         HttpStatusCode code{HttpStatusCode::HTTP_STATUS_OK};
         std::string message{};
         std::unordered_map<HttpHeaderField, HttpHeaderValue> headers{};
+        HttpBodyStreamFn bodyStream{};
+    };
+
+    /**
+     * @struct HttpKeepAlive
+     * @brief Connection persistence decided by the server for a single response.
+     *
+     * Written as "Connection: keep-alive" together with "Keep-Alive: timeout=..., max=..."
+     * or as "Connection: close".
+     */
+    struct HttpKeepAlive
+    {
+        bool persistent{false};
+        uint16_t timeoutSec{0};
+        size_t maxRequests{0}; // requests the connection is still going to serve, 0 - no limit
     };
 
     /**
@@ -123,11 +319,14 @@ namespace ctask::utils::types
      * @brief Represents the final HTTP response metadata to be serialized and sent to the client.
      *
      * Contains the core payload and associated metadata like protocol version.
+     * Connection headers are written only if keep-alive is set or the body is streamed over HTTP/1.0,
+     * such a body ends with the connection and always goes with "Connection: close".
      */
     struct HttpResponseMeta
     {
         HttpResponse payload{};
         std::string protocolVersion{};
+        std::optional<HttpKeepAlive> keepAlive{};
     };
 
     /**
@@ -0,0 +1,209 @@
+#include "hdr_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace ctask::load_generator
+{
+    // amount of reported percentiles between the current one and 100%, halved again and again
+    constexpr uint32_t TICKS_PER_HALF_DISTANCE{5};
+
+    HdrHistogram::HdrHistogram(uint64_t highestTrackableValue, uint32_t significantDigits)
+    {
+        if (significantDigits < 1 || significantDigits > 5)
+        {
+            throw std::invalid_argument("Significant digits must be in 1..5");
+        }
+        if (highestTrackableValue < 2)
+        {
+            throw std::invalid_argument("Highest trackable value must be at least 2");
+        }
+
+        // sub-bucket must resolve a unit in the largest value having the requested digits
+        const auto largestSingleUnitValue{2 * static_cast<uint64_t>(std::pow(10, significantDigits))};
+        const auto subBucketCountMagnitude{static_cast<uint32_t>(std::ceil(std::log2(largestSingleUnitValue)))};
+        subBucketHalfCountMagnitude_ = subBucketCountMagnitude - 1;
+        subBucketCount_ = uint64_t{1} << subBucketCountMagnitude;
+        subBucketHalfCount_ = subBucketCount_ / 2;
+        subBucketMask_ = subBucketCount_ - 1;
+        highestTrackableValue_ = highestTrackableValue;
+
+        // every next bucket covers twice the range of the previous one
+        bucketCount_ = 1;
+        for (auto smallestUntrackable{subBucketCount_}; smallestUntrackable <= highestTrackableValue;
+             smallestUntrackable <<= 1)
+        {
+            ++bucketCount_;
+            if (smallestUntrackable > UINT64_MAX / 2)
+            {
+                break;
+            }
+        }
+        counts_.resize((bucketCount_ + 1) * subBucketHalfCount_, 0);
+    }
+
+    void HdrHistogram::record(uint64_t value) noexcept
+    {
+        value = std::min(value, highestTrackableValue_);
+        ++counts_[countsIndex_(value)];
+        ++totalCount_;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void HdrHistogram::merge(const HdrHistogram& other)
+    {
+        if (other.subBucketCount_ != subBucketCount_ || other.counts_.size() != counts_.size())
+        {
+            throw std::invalid_argument("Can't merge histograms of different layouts");
+        }
+
+        for (size_t i{0}; i < counts_.size(); ++i)
+        {
+            counts_[i] += other.counts_[i];
+        }
+        totalCount_ += other.totalCount_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    double HdrHistogram::mean() const noexcept
+    {
+        if (totalCount_ == 0)
+        {
+            return 0.0;
+        }
+
+        double total{0.0};
+        for (size_t i{0}; i < counts_.size(); ++i)
+        {
+            if (counts_[i] != 0)
+            {
+                total += static_cast<double>(counts_[i]) * medianEquivalentValue_(valueFromIndex_(i));
+            }
+        }
+        return total / totalCount_;
+    }
+
+    double HdrHistogram::stdDeviation() const noexcept
+    {
+        if (totalCount_ == 0)
+        {
+            return 0.0;
+        }
+
+        const auto average{mean()};
+        double deviations{0.0};
+        for (size_t i{0}; i < counts_.size(); ++i)
+        {
+            if (counts_[i] != 0)
+            {
+                const auto deviation{medianEquivalentValue_(valueFromIndex_(i)) - average};
+                deviations += deviation * deviation * counts_[i];
+            }
+        }
+        return std::sqrt(deviations / totalCount_);
+    }
+
+    uint64_t HdrHistogram::valueAtPercentile(double percentile) const noexcept
+    {
+        if (totalCount_ == 0)
+        {
+            return 0;
+        }
+
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        const auto countAtPercentile{
+            std::max<uint64_t>(static_cast<uint64_t>(percentile / 100.0 * totalCount_ + 0.5), 1)
+        };
+
+        uint64_t cumulative{0};
+        for (size_t i{0}; i < counts_.size(); ++i)
+        {
+            cumulative += counts_[i];
+            if (cumulative >= countAtPercentile)
+            {
+                return std::min(highestEquivalentValue_(valueFromIndex_(i)), max_);
+            }
+        }
+        return max_;
+    }
+
+    void HdrHistogram::printPercentiles(std::ostream& out, double valueScale) const
+    {
+        out << std::format("{:>12} {:>14} {:>10} {:>14}\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+
+        double percentile{0.0};
+        uint64_t cumulative{0};
+        for (size_t i{0}; i < counts_.size() && cumulative < totalCount_; ++i)
+        {
+            if (counts_[i] == 0)
+            {
+                continue;
+            }
+
+            cumulative += counts_[i];
+            const auto value{highestEquivalentValue_(valueFromIndex_(i)) / valueScale};
+            while (cumulative < totalCount_ && 100.0 * cumulative / totalCount_ >= percentile)
+            {
+                const auto fraction{percentile / 100.0};
+                out << std::format("{:12.3f} {:2.12f} {:10} {:14.2f}\n", value, fraction, cumulative,
+                                   1.0 / (1.0 - fraction));
+
+                const auto halfDistance{std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - percentile))) + 1)};
+                percentile += 100.0 / (halfDistance * TICKS_PER_HALF_DISTANCE);
+            }
+        }
+        out << std::format("{:12.3f} {:2.12f} {:10}\n", max_ / valueScale, 1.0, totalCount_);
+
+        out << std::format("#[Mean    = {:12.3f}, StdDeviation   = {:12.3f}]\n",
+                           mean() / valueScale, stdDeviation() / valueScale);
+        out << std::format("#[Max     = {:12.3f}, Total count    = {:12}]\n", max_ / valueScale, totalCount_);
+        out << std::format("#[Buckets = {:12}, SubBuckets     = {:12}]\n", bucketCount_, subBucketCount_);
+    }
+
+    uint32_t HdrHistogram::bucketIndex_(uint64_t value) const noexcept
+    {
+        // position of the highest bit above the first (linear) bucket
+        const auto pow2Ceiling{64 - std::countl_zero(value | subBucketMask_)};
+        return static_cast<uint32_t>(pow2Ceiling) - (subBucketHalfCountMagnitude_ + 1);
+    }
+
+    size_t HdrHistogram::countsIndex_(uint64_t value) const noexcept
+    {
+        const auto bucket{bucketIndex_(value)};
+        const auto subBucket{value >> bucket};
+
+        // buckets except the first one share their lower half with the previous bucket, skip it
+        return ((static_cast<size_t>(bucket) + 1) << subBucketHalfCountMagnitude_) + (subBucket - subBucketHalfCount_);
+    }
+
+    uint64_t HdrHistogram::valueFromIndex_(size_t index) const noexcept
+    {
+        auto bucket{static_cast<int64_t>(index >> subBucketHalfCountMagnitude_) - 1};
+        auto subBucket{(index & (subBucketHalfCount_ - 1)) + subBucketHalfCount_};
+        if (bucket < 0)
+        {
+            subBucket -= subBucketHalfCount_;
+            bucket = 0;
+        }
+        return subBucket << bucket;
+    }
+
+    uint64_t HdrHistogram::highestEquivalentValue_(uint64_t value) const noexcept
+    {
+        const auto bucket{bucketIndex_(value)};
+        const auto lowest{(value >> bucket) << bucket};
+        return lowest + (uint64_t{1} << bucket) - 1;
+    }
+
+    uint64_t HdrHistogram::medianEquivalentValue_(uint64_t value) const noexcept
+    {
+        const auto bucket{bucketIndex_(value)};
+        const auto lowest{(value >> bucket) << bucket};
+        return lowest + ((uint64_t{1} << bucket) >> 1);
+    }
+}
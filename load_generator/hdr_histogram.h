@@ -0,0 +1,88 @@
+#ifndef LOAD_GENERATOR_HDR_HISTOGRAM_H
+#define LOAD_GENERATOR_HDR_HISTOGRAM_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ctask::load_generator
+{
+    /**
+     * @class HdrHistogram
+     * @brief High dynamic range histogram of integer values (latencies in microseconds).
+     *
+     * Same layout as the reference HdrHistogram: values are split into power of two buckets,
+     * every bucket into linear sub-buckets, so any recorded value is kept with the requested
+     * amount of significant decimal digits, from 1 up to highestTrackableValue.
+     * Recording is a couple of shifts and an increment, percentiles walk the counts.
+     *
+     * Not thread-safe, every worker thread owns its histogram, they are merged at the end.
+     */
+    class HdrHistogram
+    {
+    public:
+        /**
+         * @param highestTrackableValue Values above it are clamped to it.
+         * @param significantDigits Value precision, 1..5.
+         *
+         * @throws std::invalid_argument If arguments are out of range.
+         */
+        HdrHistogram(uint64_t highestTrackableValue, uint32_t significantDigits);
+        ~HdrHistogram() = default;
+        HdrHistogram(const HdrHistogram&) = default;
+        HdrHistogram& operator=(const HdrHistogram&) = default;
+        HdrHistogram(HdrHistogram&&) = default;
+        HdrHistogram& operator=(HdrHistogram&&) = default;
+
+        void record(uint64_t value) noexcept;
+
+        /**
+         * @brief Adds counts of another histogram.
+         *
+         * @throws std::invalid_argument If histograms have different layouts.
+         */
+        void merge(const HdrHistogram& other);
+
+        uint64_t totalCount() const noexcept { return totalCount_; }
+        uint64_t min() const noexcept { return totalCount_ == 0 ? 0 : min_; }
+        uint64_t max() const noexcept { return max_; }
+        double mean() const noexcept;
+        double stdDeviation() const noexcept;
+
+        /**
+         * @brief Returns the value below which the given percent of values fall, 0 for an empty histogram.
+         *
+         * @param percentile 0..100
+         */
+        uint64_t valueAtPercentile(double percentile) const noexcept;
+
+        /**
+         * @brief Writes percentile distribution in HdrHistogram text format (.hgrm),
+         * readable by the HdrHistogram plotter.
+         *
+         * @param valueScale Values are divided by it, e.g. 1000 to print microseconds as milliseconds.
+         */
+        void printPercentiles(std::ostream& out, double valueScale) const;
+
+    private:
+        uint32_t subBucketHalfCountMagnitude_;
+        uint64_t subBucketCount_;
+        uint64_t subBucketHalfCount_;
+        uint64_t subBucketMask_;
+        uint64_t highestTrackableValue_;
+        uint32_t bucketCount_;
+
+        std::vector<uint64_t> counts_;
+        uint64_t totalCount_{0};
+        uint64_t min_{UINT64_MAX};
+        uint64_t max_{0};
+
+        uint32_t bucketIndex_(uint64_t value) const noexcept;
+        size_t countsIndex_(uint64_t value) const noexcept;
+        uint64_t valueFromIndex_(size_t index) const noexcept;
+        uint64_t highestEquivalentValue_(uint64_t value) const noexcept;
+        uint64_t medianEquivalentValue_(uint64_t value) const noexcept;
+    };
+}
+
+#endif //LOAD_GENERATOR_HDR_HISTOGRAM_H
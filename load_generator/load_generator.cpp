@@ -0,0 +1,294 @@
+#include "load_generator.h"
+
+#include <algorithm>
+#include <deque>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ctask::load_generator
+{
+    using namespace asio;
+    using namespace asio::ip;
+    using Clock = std::chrono::steady_clock;
+
+    // connections are spawned before threads start, all of them begin at the same moment a bit later
+    constexpr auto START_DELAY{std::chrono::milliseconds(100)};
+
+    // pause before the next connection attempt, so a dead server is not hammered in a busy loop
+    constexpr auto RECONNECT_DELAY{std::chrono::milliseconds(10)};
+
+    constexpr size_t READ_BUFFER_LEN{16 * 1024};
+
+    /**
+     * @struct LoadGenerator::Worker
+     * @brief Single-threaded event loop and stats of its connections.
+     */
+    struct LoadGenerator::Worker
+    {
+        io_context ctx{1};
+        LoadReport report{};
+    };
+
+    LoadGenerator::LoadGenerator(LoadArgs args) : args_(std::move(args))
+    {
+        if (args_.threads == 0 || args_.connections == 0)
+        {
+            throw std::invalid_argument("Threads and connections must be positive");
+        }
+        if (args_.pipelineDepth == 0)
+        {
+            throw std::invalid_argument("Pipeline depth must be positive");
+        }
+        if (!args_.keepAlive && args_.pipelineDepth > 1)
+        {
+            throw std::invalid_argument("Pipelining requires keep-alive connections");
+        }
+        if (args_.duration.count() <= 0 || args_.timeout.count() <= 0)
+        {
+            throw std::invalid_argument("Duration and timeout must be positive");
+        }
+        if (args_.mix.postRatio < 0.0 || args_.mix.postRatio > 1.0)
+        {
+            throw std::invalid_argument("POST ratio must be in 0..1");
+        }
+        if (args_.mix.eventCardinality == 0 || args_.mix.timestampRange == 0)
+        {
+            throw std::invalid_argument("Event cardinality and timestamp range must be positive");
+        }
+
+        endpoint_ = tcp::endpoint{make_address(args_.address), args_.port};
+    }
+
+    LoadReport LoadGenerator::run()
+    {
+        const auto threadCount{std::min(args_.threads, args_.connections)};
+        std::vector<std::unique_ptr<Worker>> workers{};
+        workers.reserve(threadCount);
+        for (uint32_t i{0}; i < threadCount; ++i)
+        {
+            workers.emplace_back(std::make_unique<Worker>());
+        }
+
+        const auto start{Clock::now() + START_DELAY};
+        for (uint32_t connection{0}; connection < args_.connections; ++connection)
+        {
+            auto& worker{*workers[connection % threadCount]};
+            co_spawn(worker.ctx, connection_(worker, connection, start), detached);
+        }
+
+        {
+            std::vector<std::jthread> threads{};
+            threads.reserve(threadCount);
+            for (auto& worker : workers)
+            {
+                threads.emplace_back([&worker]() { worker->ctx.run(); });
+            }
+        }
+
+        LoadReport report{};
+        report.elapsed = Clock::now() - start;
+        for (const auto& worker : workers)
+        {
+            const auto& part{worker->report};
+            report.requests += part.requests;
+            report.postRequests += part.postRequests;
+            report.getRequests += part.getRequests;
+            report.errorResponses += part.errorResponses;
+            report.timeouts += part.timeouts;
+            report.socketErrors += part.socketErrors;
+            report.sentBytes += part.sentBytes;
+            report.receivedBytes += part.receivedBytes;
+            report.latency.merge(part.latency);
+            report.serviceTime.merge(part.serviceTime);
+        }
+        return report;
+    }
+
+    awaitable<void> LoadGenerator::connection_(Worker& worker, uint32_t index, Clock::time_point start)
+    {
+        struct InFlight
+        {
+            Clock::time_point intended; // when the request had to be sent according to the schedule
+            Clock::time_point sent;
+            bool isPost;
+        };
+
+        auto& report{worker.report};
+        RequestFactory factory{
+            args_.mix, std::format("{}:{}", args_.address, args_.port), args_.keepAlive, index, args_.connections
+        };
+
+        // every connection sends its share of the rate, first requests of connections are spread over the interval
+        const bool openLoop{args_.rate > 0};
+        const auto interval{
+            openLoop
+                ? std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(static_cast<double>(args_.connections) / args_.rate))
+                : Clock::duration{0}
+        };
+        const auto deadline{start + args_.duration};
+        auto nextSend{start + interval * index / args_.connections};
+
+        std::deque<InFlight> inFlight{};
+        std::string received{};
+        std::array<char, READ_BUFFER_LEN> readBuffer{};
+        tcp::socket socket{worker.ctx};
+        steady_timer timer{worker.ctx};
+        error_code ec;
+
+        auto dropConnection = [&]()
+        {
+            error_code ignored;
+            socket.close(ignored);
+            inFlight.clear();
+            received.clear();
+        };
+
+        timer.expires_at(start);
+        co_await timer.async_wait(redirect_error(use_awaitable, ec));
+
+        while (Clock::now() < deadline)
+        {
+            if (!socket.is_open())
+            {
+                co_await socket.async_connect(endpoint_, redirect_error(use_awaitable, ec));
+                if (ec)
+                {
+                    ++report.socketErrors;
+                    dropConnection();
+                    timer.expires_after(RECONNECT_DELAY);
+                    co_await timer.async_wait(redirect_error(use_awaitable, ec));
+                    continue;
+                }
+                socket.set_option(tcp::no_delay{true}, ec);
+            }
+
+            // everything which is due goes out in a single write
+            std::string batch{};
+            while (inFlight.size() < args_.pipelineDepth)
+            {
+                const auto now{Clock::now()};
+                if (now >= deadline || (openLoop && nextSend > now))
+                {
+                    break;
+                }
+
+                auto request{factory.next()};
+                batch += request.raw;
+                inFlight.push_back({openLoop ? nextSend : now, now, request.isPost});
+                nextSend += interval;
+            }
+
+            if (!batch.empty())
+            {
+                co_await async_write(socket, buffer(batch), redirect_error(use_awaitable, ec));
+                if (ec)
+                {
+                    ++report.socketErrors;
+                    dropConnection();
+                    continue;
+                }
+                report.sentBytes += batch.size();
+            }
+
+            if (inFlight.empty())
+            {
+                // open loop between scheduled sends
+                timer.expires_at(std::min(nextSend, deadline));
+                co_await timer.async_wait(redirect_error(use_awaitable, ec));
+                continue;
+            }
+
+            // wait for responses, but not longer than the request timeout, and in open loop
+            // not past the next scheduled send if the pipeline has room for it
+            auto readDeadline{std::min(inFlight.front().sent + args_.timeout, deadline)};
+            if (openLoop && inFlight.size() < args_.pipelineDepth)
+            {
+                readDeadline = std::min(readDeadline, nextSend);
+            }
+
+            // the flag keeps a late timer from cancelling some next operation of the socket
+            auto reading{std::make_shared<bool>(true)};
+            timer.expires_at(readDeadline);
+            timer.async_wait([&socket, reading](const error_code& er)
+            {
+                if (!er && *reading)
+                {
+                    socket.cancel();
+                }
+            });
+            const auto size{
+                co_await socket.async_read_some(buffer(readBuffer), redirect_error(use_awaitable, ec))
+            };
+            *reading = false;
+            timer.cancel();
+
+            if (ec == error::operation_aborted)
+            {
+                if (Clock::now() >= inFlight.front().sent + args_.timeout)
+                {
+                    report.timeouts += inFlight.size();
+                    dropConnection();
+                }
+                continue;
+            }
+            if (ec)
+            {
+                ++report.socketErrors;
+                dropConnection();
+                continue;
+            }
+
+            received.append(readBuffer.data(), size);
+            report.receivedBytes += size;
+
+            bool broken{false};
+            try
+            {
+                while (!inFlight.empty())
+                {
+                    const auto response{parseResponse(received)};
+                    if (!response)
+                    {
+                        break;
+                    }
+
+                    const auto now{Clock::now()};
+                    const auto& request{inFlight.front()};
+                    report.latency.record(
+                        std::chrono::duration_cast<std::chrono::microseconds>(now - request.intended).count());
+                    report.serviceTime.record(
+                        std::chrono::duration_cast<std::chrono::microseconds>(now - request.sent).count());
+                    ++report.requests;
+                    ++(request.isPost ? report.postRequests : report.getRequests);
+                    if (response->status < 200 || response->status >= 300)
+                    {
+                        ++report.errorResponses;
+                    }
+
+                    received.erase(0, response->size);
+                    inFlight.pop_front();
+                }
+            }
+            catch (const std::exception&)
+            {
+                broken = true;
+            }
+
+            if (broken)
+            {
+                ++report.socketErrors;
+                dropConnection();
+            }
+            else if (!args_.keepAlive && inFlight.empty())
+            {
+                dropConnection();
+            }
+        }
+
+        dropConnection();
+    }
+}
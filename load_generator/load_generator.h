@@ -0,0 +1,102 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "hdr_histogram.h"
+#include "request_factory.h"
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ctask::load_generator
+{
+    // latencies over a minute are clamped, the server is as good as dead by then anyway
+    constexpr uint64_t MAX_TRACKED_LATENCY_US{60'000'000};
+    constexpr uint32_t LATENCY_SIGNIFICANT_DIGITS{3};
+
+    /**
+     * @struct LoadArgs
+     * @brief Shape of the generated load.
+     */
+    struct LoadArgs
+    {
+        std::string address;
+        uint16_t port;
+        uint32_t threads;
+        uint32_t connections;
+        std::chrono::seconds duration;
+        uint64_t rate;           // total requests per second, 0 is closed loop (as fast as possible)
+        uint32_t pipelineDepth;  // max amount of requests in flight on a single connection
+        bool keepAlive;          // reconnect for every request otherwise
+        std::chrono::milliseconds timeout;
+        RequestMix mix;
+    };
+
+    /**
+     * @struct LoadReport
+     * @brief Results of a single run, latencies are in microseconds.
+     *
+     * In open loop mode latency is measured from the time the request was supposed to be sent,
+     * so time spent waiting behind a stalled server is not hidden (coordinated omission correction),
+     * serviceTime is measured from the time the request was actually written.
+     * In closed loop mode they are equal.
+     */
+    struct LoadReport
+    {
+        uint64_t requests{0};
+        uint64_t postRequests{0};
+        uint64_t getRequests{0};
+        uint64_t errorResponses{0}; // non 2xx
+        uint64_t timeouts{0};
+        uint64_t socketErrors{0}; // failed connects, reads, writes and garbage responses
+        uint64_t sentBytes{0};
+        uint64_t receivedBytes{0};
+        std::chrono::steady_clock::duration elapsed{};
+        HdrHistogram latency{MAX_TRACKED_LATENCY_US, LATENCY_SIGNIFICANT_DIGITS};
+        HdrHistogram serviceTime{MAX_TRACKED_LATENCY_US, LATENCY_SIGNIFICANT_DIGITS};
+    };
+
+    /**
+     * @class LoadGenerator
+     * @brief HTTP load generator for the telemetry API.
+     *
+     * Every thread runs its own io_context with its own share of connections and its own stats,
+     * so threads never touch each other until the run is over and results are merged.
+     *
+     * Closed loop: every connection keeps pipelineDepth requests in flight, next request goes out
+     * as soon as a response comes back.
+     * Open loop: the rate is split evenly between connections, every connection sends on a fixed
+     * schedule no matter how slow responses are (up to pipelineDepth in flight).
+     */
+    class LoadGenerator
+    {
+    public:
+        /**
+         * @throws std::invalid_argument If arguments make no sense.
+         */
+        explicit LoadGenerator(LoadArgs args);
+        ~LoadGenerator() = default;
+        LoadGenerator(const LoadGenerator&) = delete;
+        LoadGenerator& operator=(const LoadGenerator&) = delete;
+        LoadGenerator(LoadGenerator&&) = delete;
+        LoadGenerator& operator=(LoadGenerator&&) = delete;
+
+        /**
+         * @brief Generates the load for the configured duration, blocks until done.
+         */
+        LoadReport run();
+
+    private:
+        struct Worker;
+
+        LoadArgs args_;
+        asio::ip::tcp::endpoint endpoint_;
+
+        asio::awaitable<void> connection_(Worker& worker, uint32_t index,
+                                          std::chrono::steady_clock::time_point start);
+    };
+}
+
+#endif //LOAD_GENERATOR_H
@@ -0,0 +1,127 @@
+#include "load_generator.h"
+
+#include <cxxopts.hpp>
+
+#include <format>
+#include <fstream>
+#include <iostream>
+
+using namespace ctask::load_generator;
+
+struct GeneratorOptions
+{
+    LoadArgs load;
+    std::string hdrOutput; // empty if not needed
+};
+
+static GeneratorOptions parseArgs(int argc, char** argv)
+{
+    cxxopts::Options options("load_generator", "HTTP load generator for the ctask telemetry API");
+    options.add_options()
+        ("a,address", "server address", cxxopts::value<std::string>()->default_value("127.0.0.1"))
+        ("p,port", "server port", cxxopts::value<uint16_t>()->default_value("8080"))
+        ("t,threads", "generator threads", cxxopts::value<uint32_t>()->default_value("2"))
+        ("c,connections", "open connections", cxxopts::value<uint32_t>()->default_value("16"))
+        ("d,duration", "test duration, seconds", cxxopts::value<uint32_t>()->default_value("10"))
+        ("r,rate", "total requests per second, open loop; 0 is closed loop", cxxopts::value<uint64_t>()->default_value("0"))
+        ("pipeline", "max requests in flight per connection", cxxopts::value<uint32_t>()->default_value("1"))
+        ("keep-alive", "reuse connections", cxxopts::value<bool>()->default_value("true"))
+        ("timeout", "request timeout, milliseconds", cxxopts::value<uint32_t>()->default_value("2000"))
+        ("post-ratio", "share of POST requests, the rest are meanLength queries", cxxopts::value<double>()->default_value("0.9"))
+        ("events", "amount of distinct event names", cxxopts::value<uint32_t>()->default_value("100"))
+        ("timestamps", "dates of stored events : sequential, uniform, recent", cxxopts::value<std::string>()->default_value("sequential"))
+        ("timestamp-range", "dates are within [0, range)", cxxopts::value<uint64_t>()->default_value("10000000"))
+        ("hdr-output", "file for the latency percentile distribution (.hgrm)", cxxopts::value<std::string>())
+        ("h,help", "print usage");
+
+    auto result = options.parse(argc, argv);
+    if (result.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        std::exit(0);
+    }
+
+    LoadArgs load{
+        result["address"].as<std::string>(),
+        result["port"].as<uint16_t>(),
+        result["threads"].as<uint32_t>(),
+        result["connections"].as<uint32_t>(),
+        std::chrono::seconds(result["duration"].as<uint32_t>()),
+        result["rate"].as<uint64_t>(),
+        result["pipeline"].as<uint32_t>(),
+        result["keep-alive"].as<bool>(),
+        std::chrono::milliseconds(result["timeout"].as<uint32_t>()),
+        {
+            result["post-ratio"].as<double>(),
+            result["events"].as<uint32_t>(),
+            timestampDistributionFromString(result["timestamps"].as<std::string>()),
+            result["timestamp-range"].as<uint64_t>(),
+        }
+    };
+    return {std::move(load), result.count("hdr-output") ? result["hdr-output"].as<std::string>() : ""};
+}
+
+static void printLatency(const char* title, const HdrHistogram& histogram)
+{
+    // recorded in microseconds, printed in milliseconds
+    std::cout << std::format("{} (ms) : mean {:.3f}, max {:.3f}\n", title, histogram.mean() / 1000.0,
+                             histogram.max() / 1000.0);
+    for (const auto percentile : {50.0, 90.0, 99.0, 99.9, 99.99})
+    {
+        std::cout << std::format("  p{:<6} {:10.3f}\n", percentile, histogram.valueAtPercentile(percentile) / 1000.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        auto [args, hdrOutput]{parseArgs(argc, argv)};
+        std::cout << std::format("Running {}s test @ {}:{}, {}, {} threads, {} connections, pipeline {}, keep-alive {}\n",
+                                 args.duration.count(), args.address, args.port,
+                                 args.rate > 0 ? std::format("open loop at {} req/s", args.rate) : "closed loop",
+                                 args.threads, args.connections, args.pipelineDepth, args.keepAlive ? "on" : "off");
+
+        // opened before the run, so a typo in the path doesn't waste the whole test
+        std::ofstream hdrFile{};
+        if (!hdrOutput.empty())
+        {
+            hdrFile.open(hdrOutput, std::ios::trunc);
+            if (!hdrFile.is_open())
+            {
+                throw std::runtime_error(std::format("Can't open HDR output file : {}", hdrOutput));
+            }
+        }
+
+        const bool openLoop{args.rate > 0};
+        LoadGenerator generator{std::move(args)};
+        const auto report{generator.run()};
+
+        const auto seconds{std::chrono::duration<double>(report.elapsed).count()};
+        std::cout << std::format("Requests : {} ({} POST, {} GET) in {:.2f}s, {:.1f} req/s\n",
+                                 report.requests, report.postRequests, report.getRequests, seconds,
+                                 report.requests / seconds);
+        std::cout << std::format("Errors : {} non-2xx, {} timeouts, {} socket errors\n",
+                                 report.errorResponses, report.timeouts, report.socketErrors);
+        std::cout << std::format("Transfer : {:.2f} MB sent, {:.2f} MB received\n",
+                                 report.sentBytes / 1e6, report.receivedBytes / 1e6);
+
+        printLatency(openLoop ? "Latency, from the scheduled send time" : "Latency", report.latency);
+        if (openLoop)
+        {
+            printLatency("Service time, from the actual send time", report.serviceTime);
+        }
+
+        if (hdrFile.is_open())
+        {
+            report.latency.printPercentiles(hdrFile, 1000.0);
+            std::cout << std::format("Latency distribution : {}\n", hdrOutput);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Load generator error : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include "request_factory.h"
+
+#include "telemetry/core/misc.h"
+#include "utils/types/constants.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+
+namespace ctask::load_generator
+{
+    using namespace ctask::utils::constants;
+
+    // GET queries look at a tenth of the whole range
+    constexpr uint64_t QUERY_WINDOW_DIVISOR{10};
+
+    // headers of our responses are tiny, anything bigger is garbage
+    constexpr size_t MAX_RESPONSE_HEADERS_LEN{64 * 1024};
+
+    TimestampDistribution timestampDistributionFromString(std::string_view name)
+    {
+        if (name == "sequential")
+        {
+            return TimestampDistribution::SEQUENTIAL;
+        }
+        if (name == "uniform")
+        {
+            return TimestampDistribution::UNIFORM;
+        }
+        if (name == "recent")
+        {
+            return TimestampDistribution::RECENT;
+        }
+        throw std::invalid_argument(std::format("Unknown timestamp distribution : {}", name));
+    }
+
+    RequestFactory::RequestFactory(RequestMix mix, std::string host, bool keepAlive, uint32_t index,
+                                   uint32_t connections) :
+        mix_(mix),
+        host_(std::move(host)),
+        keepAlive_(keepAlive),
+        nextSequentialDate_(index),
+        sequentialStep_(std::max<uint32_t>(connections, 1)),
+        random_(index + 1),
+        isPost_(std::clamp(mix.postRatio, 0.0, 1.0)),
+        eventIndex_(0, std::max<uint32_t>(mix.eventCardinality, 1) - 1),
+        uniformDate_(0, std::max<uint64_t>(mix.timestampRange, 1) - 1),
+        // the mean offset from the end of the range is a hundredth of the range
+        recentDateOffset_(100.0 / static_cast<double>(std::max<uint64_t>(mix.timestampRange, 1))),
+        interactionTime_(1, 100)
+    {
+    }
+
+    GeneratedRequest RequestFactory::next()
+    {
+        const auto path{std::format("/paths/event_{}", eventIndex_(random_))};
+        if (isPost_(random_))
+        {
+            std::string values{};
+            for (uint8_t i{0}; i < telemetry::core::INTERACTION_TIMES_LEN; ++i)
+            {
+                values += std::format("{}{}", i == 0 ? "" : ",", interactionTime_(random_));
+            }
+            return {build_("POST", path, std::format(R"({{"values":[{}],"date":{}}})", values, nextDate_())), true};
+        }
+
+        const auto window{std::max<uint64_t>(mix_.timestampRange / QUERY_WINDOW_DIVISOR, 1)};
+        const auto from{uniformDate_(random_)};
+        return {
+            build_("GET", path + "/meanLength",
+                   std::format(R"({{"resultUnit":"milliseconds","startTimestamp":{},"endTimestamp":{}}})",
+                               from, from + window)),
+            false
+        };
+    }
+
+    uint64_t RequestFactory::nextDate_()
+    {
+        switch (mix_.timestamps)
+        {
+        case TimestampDistribution::SEQUENTIAL:
+            {
+                // connections interleave, so dates never repeat
+                const auto date{nextSequentialDate_};
+                nextSequentialDate_ += sequentialStep_;
+                return date;
+            }
+        case TimestampDistribution::UNIFORM:
+            return uniformDate_(random_);
+        case TimestampDistribution::RECENT:
+            {
+                const auto offset{static_cast<uint64_t>(recentDateOffset_(random_))};
+                const auto range{std::max<uint64_t>(mix_.timestampRange, 1)};
+                return range - 1 - std::min(offset, range - 1);
+            }
+        }
+        return 0;
+    }
+
+    std::string RequestFactory::build_(std::string_view method, const std::string& path,
+                                       const std::string& body) const
+    {
+        return std::format("{} {} HTTP/1.1\r\n"
+                           "Host: {}\r\n"
+                           "{}: {}\r\n"
+                           "{}: {}\r\n"
+                           "{}: {}\r\n"
+                           "\r\n"
+                           "{}",
+                           method, path,
+                           host_,
+                           CONTENT_TYPE_HEADER, JSON_CONTENT_TYPE,
+                           CONTENT_LENGTH_HEADER, body.size(),
+                           CONNECTION_HEADER, keepAlive_ ? KEEP_ALIVE_CONNECTION : CLOSE_CONNECTION,
+                           body);
+    }
+
+    static bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs)
+    {
+        return std::ranges::equal(lhs, rhs, [](char l, char r)
+        {
+            return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+        });
+    }
+
+    static std::string_view trim(std::string_view value)
+    {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+        {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+        {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+
+    template <typename T>
+    static T parseNumber(std::string_view value, int base, std::string_view what)
+    {
+        T result{};
+        const auto [end, ec]{std::from_chars(value.data(), value.data() + value.size(), result, base)};
+        if (ec != std::errc{} || end != value.data() + value.size())
+        {
+            throw std::runtime_error(std::format("Invalid {} : {}", what, value));
+        }
+        return result;
+    }
+
+    // returns size of chunked body starting at the beginning of the buffer, std::nullopt if incomplete
+    static std::optional<size_t> chunkedBodySize(std::string_view body)
+    {
+        size_t position{0};
+        for (;;)
+        {
+            const auto lineEnd{body.find("\r\n", position)};
+            if (lineEnd == std::string_view::npos)
+            {
+                return std::nullopt;
+            }
+
+            // chunk extensions are not used by our server, but cost nothing to skip
+            auto sizeLine{body.substr(position, lineEnd - position)};
+            sizeLine = trim(sizeLine.substr(0, sizeLine.find(';')));
+            const auto chunkSize{parseNumber<size_t>(sizeLine, 16, "chunk size")};
+
+            // data and its CRLF, the last chunk has no data, just the final CRLF (no trailers)
+            position = lineEnd + 2 + chunkSize + 2;
+            if (position > body.size())
+            {
+                return std::nullopt;
+            }
+            if (chunkSize == 0)
+            {
+                return position;
+            }
+        }
+    }
+
+    std::optional<ParsedResponse> parseResponse(std::string_view buffer)
+    {
+        const auto headersEnd{buffer.find("\r\n\r\n")};
+        if (headersEnd == std::string_view::npos)
+        {
+            if (buffer.size() > MAX_RESPONSE_HEADERS_LEN)
+            {
+                throw std::runtime_error("Response headers are too long");
+            }
+            return std::nullopt;
+        }
+
+        // "HTTP/1.1 200 OK"
+        const auto statusLineEnd{buffer.find("\r\n")};
+        const auto statusLine{buffer.substr(0, statusLineEnd)};
+        if (!statusLine.starts_with("HTTP/1.") || statusLine.size() < 12)
+        {
+            throw std::runtime_error(std::format("Invalid status line : {}", statusLine));
+        }
+
+        ParsedResponse response{parseNumber<uint32_t>(statusLine.substr(9, 3), 10, "status"), 0};
+
+        size_t contentLength{0};
+        bool chunked{false};
+        size_t lineStart{statusLineEnd + 2};
+        while (lineStart < headersEnd)
+        {
+            const auto lineEnd{buffer.find("\r\n", lineStart)};
+            const auto line{buffer.substr(lineStart, lineEnd - lineStart)};
+            lineStart = lineEnd + 2;
+
+            const auto colon{line.find(':')};
+            if (colon == std::string_view::npos)
+            {
+                continue;
+            }
+
+            const auto name{trim(line.substr(0, colon))};
+            const auto value{trim(line.substr(colon + 1))};
+            if (equalsIgnoreCase(name, CONTENT_LENGTH_HEADER))
+            {
+                contentLength = parseNumber<size_t>(value, 10, "content length");
+            }
+            else if (equalsIgnoreCase(name, TRANSFER_ENCODING_HEADER))
+            {
+                chunked = equalsIgnoreCase(value, CHUNKED_TRANSFER_ENCODING);
+            }
+        }
+
+        const auto bodyStart{headersEnd + 4};
+        if (chunked)
+        {
+            const auto bodySize{chunkedBodySize(buffer.substr(bodyStart))};
+            if (!bodySize)
+            {
+                return std::nullopt;
+            }
+            response.size = bodyStart + *bodySize;
+            return response;
+        }
+
+        if (buffer.size() < bodyStart + contentLength)
+        {
+            return std::nullopt;
+        }
+        response.size = bodyStart + contentLength;
+        return response;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef LOAD_GENERATOR_REQUEST_FACTORY_H
+#define LOAD_GENERATOR_REQUEST_FACTORY_H
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace ctask::load_generator
+{
+    /**
+     * @enum TimestampDistribution
+     * @brief How dates of stored events are picked.
+     */
+    enum class TimestampDistribution
+    {
+        SEQUENTIAL, // increasing, distinct between connections, the append-only case
+        UNIFORM,    // anywhere in the range, lots of out of order inserts
+        RECENT,     // mostly close to the end of the range, a few late arrivals
+    };
+
+    /**
+     * @brief Parses "sequential", "uniform" or "recent".
+     *
+     * @throws std::invalid_argument On unknown name.
+     */
+    TimestampDistribution timestampDistributionFromString(std::string_view name);
+
+    /**
+     * @struct RequestMix
+     * @brief What requests look like.
+     */
+    struct RequestMix
+    {
+        double postRatio;           // share of POST /paths/{event}, the rest is GET /paths/{event}/meanLength
+        uint32_t eventCardinality;  // amount of distinct event names
+        TimestampDistribution timestamps;
+        uint64_t timestampRange;    // dates are within [0, timestampRange)
+    };
+
+    /**
+     * @struct GeneratedRequest
+     * @brief Raw request ready to be written into the socket.
+     */
+    struct GeneratedRequest
+    {
+        std::string raw;
+        bool isPost{false};
+    };
+
+    /**
+     * @class RequestFactory
+     * @brief Builds random requests of the mix, one factory per connection.
+     *
+     * Factories of different connections are seeded differently, so the load is the same from run to run,
+     * but connections don't repeat each other.
+     */
+    class RequestFactory
+    {
+    public:
+        /**
+         * @param mix Request mix.
+         * @param host Value of the Host header.
+         * @param keepAlive Asks server to keep the connection open.
+         * @param index Connection index, used as a seed and to split sequential dates between connections.
+         * @param connections Total amount of connections.
+         */
+        RequestFactory(RequestMix mix, std::string host, bool keepAlive, uint32_t index, uint32_t connections);
+        ~RequestFactory() = default;
+        RequestFactory(const RequestFactory&) = delete;
+        RequestFactory& operator=(const RequestFactory&) = delete;
+        RequestFactory(RequestFactory&&) = delete;
+        RequestFactory& operator=(RequestFactory&&) = delete;
+
+        GeneratedRequest next();
+
+    private:
+        RequestMix mix_;
+        std::string host_;
+        bool keepAlive_;
+        uint64_t nextSequentialDate_;
+        uint64_t sequentialStep_;
+
+        std::mt19937_64 random_;
+        std::bernoulli_distribution isPost_;
+        std::uniform_int_distribution<uint32_t> eventIndex_;
+        std::uniform_int_distribution<uint64_t> uniformDate_;
+        std::exponential_distribution<double> recentDateOffset_;
+        std::uniform_int_distribution<uint32_t> interactionTime_;
+
+        uint64_t nextDate_();
+        std::string build_(std::string_view method, const std::string& path, const std::string& body) const;
+    };
+
+    /**
+     * @struct ParsedResponse
+     * @brief Status and total size of a complete response at the beginning of the buffer.
+     */
+    struct ParsedResponse
+    {
+        uint32_t status{0};
+        size_t size{0};
+    };
+
+    /**
+     * @brief Looks for a complete response at the beginning of the buffer.
+     *
+     * Knows just enough HTTP/1.1 to split responses of our server:
+     * Content-Length and chunked bodies.
+     *
+     * @return Parsed response or std::nullopt if more bytes are needed.
+     *
+     * @throws std::runtime_error If the buffer doesn't start with a valid response.
+     */
+    std::optional<ParsedResponse> parseResponse(std::string_view buffer);
+}
+
+#endif //LOAD_GENERATOR_REQUEST_FACTORY_H
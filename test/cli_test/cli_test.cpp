@@ -78,4 +78,22 @@ TEST(CliParserTest, ParseValidInputParameter_ValidConfig)
     ASSERT_EQ(result.serverArgs.threads, 0);
     ASSERT_EQ(result.serverArgs.keepAliveSec, 5);
     ASSERT_EQ(result.loggerArgs.level, "debug");
+
+    // optional section, default is used
+    ASSERT_EQ(result.cacheArgs.meanLengthCapacity, 10000);
+    ASSERT_EQ(result.tracingArgs.sampleEvery, 100);
+    ASSERT_EQ(result.tracingArgs.dumpPath, "ctask_trace.json");
+    ASSERT_EQ(result.serverArgs.keepAliveMaxRequests, 0);
+    ASSERT_EQ(result.serverArgs.admission.maxConnections, 0);
+    ASSERT_EQ(result.serverArgs.admission.maxInFlightRequests, 0);
+    ASSERT_EQ(result.serverArgs.admission.maxQueueDepth, 0);
+    ASSERT_EQ(result.computeArgs.threads, 0);
+    ASSERT_FALSE(result.ingestArgs.pipeline);
+    ASSERT_EQ(result.ingestArgs.ack, "enqueued");
+    ASSERT_EQ(result.ingestArgs.writers, 1);
+    ASSERT_EQ(result.ingestArgs.queueCapacity, 8192);
+    ASSERT_EQ(result.telemetryArgs.interactionTimesLen, 10);
+    ASSERT_EQ(result.loggerArgs.overflowPolicy, "block");
+    ASSERT_EQ(result.loggerArgs.ringCapacity, 4096);
+    ASSERT_TRUE(result.loggerArgs.filePath.empty());
 }
@@ -13,6 +13,7 @@
 
 #include "network/http/router/router_builder.h"
 #include "telemetry/api/routes.h"
+#include "utils/concurrency/compute_pool.h"
 
 #include <random>
 
@@ -23,6 +24,7 @@ using namespace ctask::service;
 using namespace ctask::telemetry::api;
 using namespace ctask::network::http::router;
 using namespace ctask::telemetry;
+using namespace ctask::utils::concurrency;
 
 using namespace nlohmann;
 using namespace testing;
@@ -47,7 +49,8 @@ TEST(WholeApp, RunApp)
 
     RouterBuilder routBuilder;
     TelemetryRoutes::registerRoutes(routBuilder,
-                                    std::make_shared<core::TelemetryStorage>());
+                                    std::make_shared<core::TelemetryStorage>(),
+                                    std::make_shared<ComputePool>(2));
     auto server{
         HttpServer::сreateService(serverCtx,
                                   args,
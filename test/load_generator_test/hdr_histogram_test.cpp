@@ -0,0 +1,95 @@
+#include "hdr_histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <sstream>
+
+using namespace ctask::load_generator;
+using namespace testing;
+
+TEST(HdrHistogramTest, Create_InvalidArgs_ThrowsException)
+{
+    EXPECT_THROW(HdrHistogram(1000, 0), std::invalid_argument);
+    EXPECT_THROW(HdrHistogram(1000, 6), std::invalid_argument);
+    EXPECT_THROW(HdrHistogram(1, 3), std::invalid_argument);
+}
+
+TEST(HdrHistogramTest, Empty_ReturnsZeros)
+{
+    HdrHistogram histogram{1'000'000, 3};
+    EXPECT_EQ(histogram.totalCount(), 0);
+    EXPECT_EQ(histogram.min(), 0);
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.valueAtPercentile(99.0), 0);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST(HdrHistogramTest, ValueAtPercentile_KeepsSignificantDigits)
+{
+    HdrHistogram histogram{60'000'000, 3};
+    std::vector<uint64_t> values{};
+    std::mt19937_64 random{42};
+    std::lognormal_distribution<double> latency{7.0, 1.5};
+    for (int i{0}; i < 100'000; ++i)
+    {
+        values.push_back(static_cast<uint64_t>(latency(random)) + 1);
+        histogram.record(values.back());
+    }
+    std::ranges::sort(values);
+
+    ASSERT_EQ(histogram.totalCount(), values.size());
+    EXPECT_EQ(histogram.min(), values.front());
+    EXPECT_EQ(histogram.max(), values.back());
+    for (const auto percentile : {1.0, 50.0, 90.0, 99.0, 99.9})
+    {
+        const auto expected{static_cast<double>(values[static_cast<size_t>(percentile / 100.0 * values.size()) - 1])};
+        EXPECT_NEAR(histogram.valueAtPercentile(percentile), expected, expected * 0.001 + 1) << percentile;
+    }
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), values.back());
+}
+
+TEST(HdrHistogramTest, Record_ValueOverHighest_IsClamped)
+{
+    HdrHistogram histogram{10'000, 3};
+    histogram.record(1'000'000);
+    EXPECT_EQ(histogram.max(), 10'000);
+    EXPECT_NEAR(histogram.valueAtPercentile(50.0), 10'000, 10);
+}
+
+TEST(HdrHistogramTest, Merge_SumsCounts)
+{
+    HdrHistogram first{1'000'000, 3};
+    HdrHistogram second{1'000'000, 3};
+    for (uint64_t value{1}; value <= 1000; ++value)
+    {
+        (value % 2 == 0 ? first : second).record(value);
+    }
+
+    first.merge(second);
+    EXPECT_EQ(first.totalCount(), 1000);
+    EXPECT_EQ(first.min(), 1);
+    EXPECT_EQ(first.max(), 1000);
+    EXPECT_EQ(first.valueAtPercentile(50.0), 500);
+    EXPECT_NEAR(first.mean(), 500.5, 0.5);
+
+    HdrHistogram other{1'000'000, 2};
+    EXPECT_THROW(first.merge(other), std::invalid_argument);
+}
+
+TEST(HdrHistogramTest, PrintPercentiles_WritesHgrmFormat)
+{
+    HdrHistogram histogram{1'000'000, 3};
+    for (uint64_t value{1}; value <= 100; ++value)
+    {
+        histogram.record(value * 1000);
+    }
+
+    std::stringstream out;
+    histogram.printPercentiles(out, 1000.0);
+    const auto text{out.str()};
+
+    EXPECT_TRUE(text.starts_with("       Value     Percentile TotalCount 1/(1-Percentile)"));
+    EXPECT_NE(text.find("     100.000 1.000000000000        100\n"), std::string::npos);
+    EXPECT_NE(text.find("#[Max     =      100.000, Total count    =          100]"), std::string::npos);
+}
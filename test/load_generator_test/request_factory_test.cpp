@@ -0,0 +1,108 @@
+#include "request_factory.h"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using namespace ctask::load_generator;
+using namespace testing;
+
+static nlohmann::json bodyOf(const std::string& request)
+{
+    return nlohmann::json::parse(request.substr(request.find("\r\n\r\n") + 4));
+}
+
+TEST(RequestFactoryTest, TimestampDistributionFromString_Unknown_ThrowsException)
+{
+    EXPECT_EQ(timestampDistributionFromString("recent"), TimestampDistribution::RECENT);
+    EXPECT_THROW(timestampDistributionFromString("gauss"), std::invalid_argument);
+}
+
+TEST(RequestFactoryTest, Next_FollowsMix)
+{
+    RequestFactory factory{{0.75, 3, TimestampDistribution::UNIFORM, 1000}, "127.0.0.1:8080", true, 0, 1};
+
+    size_t posts{0};
+    std::set<std::string> paths{};
+    for (int i{0}; i < 4000; ++i)
+    {
+        const auto request{factory.next()};
+        const auto path{request.raw.substr(0, request.raw.find(" HTTP/1.1"))};
+        EXPECT_NE(request.raw.find("Connection: Keep-Alive\r\n"), std::string::npos);
+
+        const auto body = bodyOf(request.raw);
+        if (request.isPost)
+        {
+            ++posts;
+            EXPECT_TRUE(path.starts_with("POST /paths/event_"));
+            EXPECT_EQ(body["values"].size(), 10);
+            EXPECT_LT(body["date"].get<uint64_t>(), 1000);
+        }
+        else
+        {
+            EXPECT_TRUE(path.starts_with("GET /paths/event_") && path.ends_with("/meanLength"));
+            EXPECT_EQ(body["resultUnit"], "milliseconds");
+        }
+        paths.insert(path);
+    }
+
+    EXPECT_NEAR(posts, 3000, 150);
+    EXPECT_EQ(paths.size(), 6); // 3 events, POST and GET
+}
+
+TEST(RequestFactoryTest, Next_SequentialDates_DistinctBetweenConnections)
+{
+    std::set<uint64_t> dates{};
+    for (uint32_t connection{0}; connection < 3; ++connection)
+    {
+        RequestFactory factory{
+            {1.0, 1, TimestampDistribution::SEQUENTIAL, 1000}, "127.0.0.1:8080", false, connection, 3
+        };
+        uint64_t previous{0};
+        for (int i{0}; i < 10; ++i)
+        {
+            const auto request{factory.next()};
+            EXPECT_NE(request.raw.find("Connection: close\r\n"), std::string::npos);
+
+            const auto date{bodyOf(request.raw)["date"].get<uint64_t>()};
+            EXPECT_TRUE(i == 0 || date > previous);
+            EXPECT_TRUE(dates.insert(date).second);
+            previous = date;
+        }
+    }
+    EXPECT_EQ(dates.size(), 30);
+}
+
+TEST(RequestFactoryTest, ParseResponse_ContentLength_SplitsPipelinedResponses)
+{
+    const std::string first{"HTTP/1.1 200 OK\r\ncontent-length: 2\r\n\r\n{}"};
+    const std::string second{"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"};
+
+    const auto response{parseResponse(first + second)};
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 200);
+    EXPECT_EQ(response->size, first.size());
+
+    const auto next{parseResponse(second)};
+    ASSERT_TRUE(next.has_value());
+    EXPECT_EQ(next->status, 404);
+    EXPECT_EQ(next->size, second.size());
+
+    EXPECT_FALSE(parseResponse(first.substr(0, first.size() - 1)).has_value());
+    EXPECT_FALSE(parseResponse("HTTP/1.1 200 OK\r\nContent-Le").has_value());
+}
+
+TEST(RequestFactoryTest, ParseResponse_Chunked_WaitsForLastChunk)
+{
+    const std::string response{"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\na\r\n0123456789\r\n0\r\n\r\n"};
+
+    const auto parsed{parseResponse(response + "HTTP/1.1")};
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->size, response.size());
+    EXPECT_FALSE(parseResponse(response.substr(0, response.size() - 2)).has_value());
+}
+
+TEST(RequestFactoryTest, ParseResponse_Garbage_ThrowsException)
+{
+    EXPECT_THROW(parseResponse("garbage\r\n\r\n"), std::runtime_error);
+    EXPECT_THROW(parseResponse("HTTP/1.1 2x0 OK\r\n\r\n"), std::runtime_error);
+}
@@ -0,0 +1,144 @@
+#include "logging/ring_buffer_sink.h"
+
+#include <spdlog/logger.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ctask::logging;
+
+namespace
+{
+    // keeps raw payloads, written by the drain thread and read after flush
+    class CollectingSink final : public spdlog::sinks::base_sink<std::mutex>
+    {
+    public:
+        std::vector<std::string> payloads()
+        {
+            std::lock_guard lock{mutex_};
+            return payloads_;
+        }
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            payloads_.emplace_back(msg.payload.data(), msg.payload.size());
+        }
+
+        void flush_() override
+        {
+        }
+
+    private:
+        std::vector<std::string> payloads_;
+    };
+
+    // the drain thread sleeps long enough for a test to fill the ring, flush() wakes it
+    constexpr std::chrono::milliseconds IDLE_DRAIN{std::chrono::hours(1)};
+
+    struct SinkFixture
+    {
+        std::shared_ptr<RingBufferSink> ringSink;
+        std::shared_ptr<CollectingSink> collectingSink{std::make_shared<CollectingSink>()};
+        std::shared_ptr<spdlog::logger> logger;
+
+        SinkFixture(size_t capacity, LogOverflowPolicy policy) :
+            ringSink(std::make_shared<RingBufferSink>(capacity, policy, IDLE_DRAIN)),
+            logger(std::make_shared<spdlog::logger>("ring_test", ringSink))
+        {
+            ringSink->addSink(collectingSink);
+            logger->set_level(spdlog::level::trace);
+        }
+    };
+}
+
+TEST(RingBufferSinkTest, Log_DiscardNewOnFullRing_OldestKeptAndDroppedCounted)
+{
+    SinkFixture fixture{4, LogOverflowPolicy::DISCARD_NEW};
+    for (int i{0}; i < 10; ++i)
+    {
+        fixture.logger->info("message {}", i);
+    }
+    fixture.logger->flush();
+
+    const std::vector<std::string> expected{"message 0", "message 1", "message 2", "message 3"};
+    EXPECT_EQ(fixture.collectingSink->payloads(), expected);
+    EXPECT_EQ(fixture.ringSink->stats().dropped, 6);
+    EXPECT_EQ(fixture.ringSink->stats().overrun, 0);
+}
+
+TEST(RingBufferSinkTest, Log_OverrunOldestOnFullRing_NewestKeptAndOverrunCounted)
+{
+    SinkFixture fixture{4, LogOverflowPolicy::OVERRUN_OLDEST};
+    for (int i{0}; i < 10; ++i)
+    {
+        fixture.logger->info("message {}", i);
+    }
+    fixture.logger->flush();
+
+    const std::vector<std::string> expected{"message 6", "message 7", "message 8", "message 9"};
+    EXPECT_EQ(fixture.collectingSink->payloads(), expected);
+    EXPECT_EQ(fixture.ringSink->stats().overrun, 6);
+    EXPECT_EQ(fixture.ringSink->stats().dropped, 0);
+}
+
+TEST(RingBufferSinkTest, Log_BlockOnFullRing_NothingLost)
+{
+    SinkFixture fixture{4, LogOverflowPolicy::BLOCK};
+    for (int i{0}; i < 100; ++i)
+    {
+        fixture.logger->info("message {}", i);
+    }
+    fixture.logger->flush();
+
+    const auto payloads{fixture.collectingSink->payloads()};
+    ASSERT_EQ(payloads.size(), 100);
+    EXPECT_EQ(payloads.front(), "message 0");
+    EXPECT_EQ(payloads.back(), "message 99");
+    EXPECT_EQ(fixture.ringSink->stats().dropped, 0);
+    EXPECT_EQ(fixture.ringSink->stats().overrun, 0);
+}
+
+TEST(RingBufferSinkTest, Log_ManyThreads_EveryThreadDrained)
+{
+    SinkFixture fixture{1024, LogOverflowPolicy::BLOCK};
+    {
+        std::vector<std::jthread> threads;
+        for (int t{0}; t < 4; ++t)
+        {
+            threads.emplace_back([&fixture, t]()
+            {
+                for (int i{0}; i < 250; ++i)
+                {
+                    fixture.logger->info("thread {} message {}", t, i);
+                }
+            });
+        }
+    }
+    fixture.logger->flush();
+
+    EXPECT_EQ(fixture.collectingSink->payloads().size(), 1000);
+}
+
+TEST(RingBufferSinkTest, Log_LongMessage_TruncatedAndCounted)
+{
+    SinkFixture fixture{4, LogOverflowPolicy::BLOCK};
+    fixture.logger->info(std::string(LOG_RECORD_PAYLOAD_LEN * 2, 'x'));
+    fixture.logger->flush();
+
+    const auto payloads{fixture.collectingSink->payloads()};
+    ASSERT_EQ(payloads.size(), 1);
+    EXPECT_EQ(payloads.front(), std::string(LOG_RECORD_PAYLOAD_LEN, 'x'));
+    EXPECT_EQ(fixture.ringSink->stats().truncated, 1);
+}
+
+TEST(RingBufferSinkTest, LogOverflowPolicyFromString_UnknownName_ThrowsException)
+{
+    EXPECT_EQ(logOverflowPolicyFromString("overrun_oldest"), LogOverflowPolicy::OVERRUN_OLDEST);
+    EXPECT_THROW(logOverflowPolicyFromString("lose_everything"), std::invalid_argument);
+}
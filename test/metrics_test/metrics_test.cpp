@@ -0,0 +1,132 @@
+#include "metrics/metrics.h"
+#include "metrics/metrics_registry.h"
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+
+using namespace ctask::metrics;
+using namespace testing;
+
+TEST(MetricsTest, Counter_IncrementedFromSeveralThreads_SumsAllSlots)
+{
+    Counter counter;
+    std::vector<std::jthread> threads;
+    for (int t{0}; t < 32; ++t)
+    {
+        threads.emplace_back([&counter]
+        {
+            for (int i{0}; i < 1000; ++i)
+            {
+                counter.inc();
+            }
+            counter.inc(10);
+        });
+    }
+    threads.clear();
+
+    EXPECT_EQ(counter.value(), 32 * 1010);
+}
+
+TEST(MetricsTest, CreateHistogram_InvalidBounds_ThrowsException)
+{
+    EXPECT_THROW(Histogram({}), std::invalid_argument);
+    EXPECT_THROW(Histogram({1, 1}), std::invalid_argument);
+    EXPECT_THROW(Histogram(std::vector<uint64_t>(Histogram::MAX_BOUNDS + 1, 1)), std::invalid_argument);
+}
+
+TEST(MetricsTest, Histogram_Observe_CountsIntoInclusiveBuckets)
+{
+    Histogram histogram{{10, 100}};
+    for (uint64_t value : {0, 10, 11, 100, 101, 1000})
+    {
+        histogram.observe(value);
+    }
+
+    auto snapshot{histogram.snapshot()};
+    EXPECT_EQ(snapshot.counts, (std::vector<uint64_t>{2, 2, 2}));
+    EXPECT_EQ(snapshot.count, 6);
+    EXPECT_EQ(snapshot.sum, 1222);
+}
+
+TEST(MetricsTest, Registry_SameNameAndLabels_ReturnsSameMetric)
+{
+    auto& registry{MetricsRegistry::instance()};
+    auto& first{registry.counter("test_same_total", "help", {{"route", "/a"}})};
+    auto& second{registry.counter("test_same_total", "help", {{"route", "/a"}})};
+    auto& other{registry.counter("test_same_total", "help", {{"route", "/b"}})};
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+    EXPECT_THROW(registry.gauge("test_same_total", "help"), std::invalid_argument);
+}
+
+TEST(MetricsTest, Registry_Scrape_RendersPrometheusText)
+{
+    auto& registry{MetricsRegistry::instance()};
+    registry.counter("test_scrape_total", "Scrape counter", {{"route", "/paths/{event}"}}).inc(3);
+    registry.gauge("test_scrape_gauge", "Scrape gauge").set(-2);
+    auto& histogram{registry.histogram("test_scrape_seconds", "Scrape histogram", {{"quote", "a\"b"}}, {1000, 2000}, 1e3)};
+    histogram.observe(500);
+    histogram.observe(1500);
+    histogram.observe(5000);
+
+    auto text{registry.scrape()};
+    for (const auto* expected : {
+             "# HELP test_scrape_total Scrape counter\n# TYPE test_scrape_total counter\n",
+             "test_scrape_total{route=\"/paths/{event}\"} 3\n",
+             "# TYPE test_scrape_gauge gauge\ntest_scrape_gauge -2\n",
+             "# TYPE test_scrape_seconds histogram\n",
+             "test_scrape_seconds_bucket{quote=\"a\\\"b\",le=\"1\"} 1\n",
+             "test_scrape_seconds_bucket{quote=\"a\\\"b\",le=\"2\"} 2\n",
+             "test_scrape_seconds_bucket{quote=\"a\\\"b\",le=\"+Inf\"} 3\n",
+             "test_scrape_seconds_sum{quote=\"a\\\"b\"} 7\n",
+             "test_scrape_seconds_count{quote=\"a\\\"b\"} 3\n",
+         })
+    {
+        EXPECT_NE(text.find(expected), std::string::npos) << expected << "\n" << text;
+    }
+}
+
+TEST(MetricsTest, Registry_Collector_SampledOnScrapeUntilRemoved)
+{
+    auto& registry{MetricsRegistry::instance()};
+    auto& gauge{registry.gauge("test_collected_gauge", "Collected gauge")};
+
+    int64_t sampled{7};
+    const auto id{registry.addCollector([&gauge, &sampled]() { gauge.set(sampled); })};
+    EXPECT_NE(registry.scrape().find("test_collected_gauge 7\n"), std::string::npos);
+
+    registry.removeCollector(id);
+    sampled = 9;
+    EXPECT_NE(registry.scrape().find("test_collected_gauge 7\n"), std::string::npos);
+}
+
+TEST(MetricsTest, LockMeasured_OnlyContendedLockIsObserved)
+{
+    Histogram waitTime{latencyBoundsNs()};
+    std::mutex mutex;
+    {
+        std::unique_lock lock(mutex, std::defer_lock);
+        lockMeasured(lock, waitTime);
+        EXPECT_TRUE(lock.owns_lock());
+    }
+    EXPECT_EQ(waitTime.snapshot().count, 0);
+
+    std::unique_lock holder(mutex);
+    std::jthread waiter{
+        [&]
+        {
+            std::unique_lock lock(mutex, std::defer_lock);
+            lockMeasured(lock, waitTime);
+        }
+    };
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    holder.unlock();
+    waiter.join();
+
+    auto snapshot{waitTime.snapshot()};
+    EXPECT_EQ(snapshot.count, 1);
+    EXPECT_GE(snapshot.sum, 1'000'000);
+}
@@ -12,6 +12,8 @@ namespace ctask::network::http::router
     public:
         MOCK_METHOD(void, addGet, (Types::HttpPath path, Types::HttpHandlerFn handler), (override));
         MOCK_METHOD(void, addPost, (Types::HttpPath path, Types::HttpHandlerFn handler), (override));
+        MOCK_METHOD(void, addGet, (Types::HttpPath path, HttpAsyncHandlerFn handler), (override));
+        MOCK_METHOD(void, addPost, (Types::HttpPath path, HttpAsyncHandlerFn handler), (override));
         MOCK_METHOD(Types::HttpResponse, route, (Types::HttpRequest& request), (noexcept, override));
     };
 }
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <memory_resource>
+
 using namespace ctask::network::http::parser;
 using namespace testing;
 
@@ -55,3 +58,39 @@ TEST(JsonHttpParserTest, ParseRequest_ValidHttpRequestString)
         ASSERT_NO_THROW(parser.parseRequest(request));
     }
 }
+
+TEST(JsonHttpParserTest, ParseRequest_WithMemoryResource_RequestMemoryComesFromResource)
+{
+    auto parser{JsonHttpParser{}};
+    const std::string raw{
+        "POST /paths/a_rather_long_event_name HTTP/1.1\r\nHost: 123.4.5.6:7890\r\n"
+        "Content-Type: application/json\r\nContent-Length: 27\r\n\r\n{\"message\":\"Hello, world!\"}"
+    };
+
+    std::array<std::byte, 4096> buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    auto request{parser.parseRequest(raw, &arena)};
+
+    EXPECT_EQ(request.path, "/paths/a_rather_long_event_name");
+    EXPECT_EQ(request.body, R"({"message":"Hello, world!"})");
+    EXPECT_EQ(request.headers.at("Content-Type"), "application/json");
+    EXPECT_EQ(request.path.get_allocator().resource(), &arena);
+    EXPECT_EQ(request.headers.get_allocator().resource(), &arena);
+    EXPECT_EQ(request.headers.begin()->second.get_allocator().resource(), &arena);
+}
+
+TEST(JsonHttpParserTest, ParseRequest_LowerCaseHeaders_FoundByAnyCase)
+{
+    auto parser{JsonHttpParser{}};
+    const std::string raw{
+        "POST /paths/signup HTTP/1.1\r\nhost: 123.4.5.6:7890\r\n"
+        "content-type: application/json\r\nCONTENT-LENGTH: 27\r\nconnection: close\r\n\r\n"
+        "{\"message\":\"Hello, world!\"}"
+    };
+
+    auto request{parser.parseRequest(raw)};
+    EXPECT_EQ(request.body, R"({"message":"Hello, world!"})");
+    EXPECT_EQ(request.headers.at("Content-Type"), "application/json");
+    EXPECT_EQ(request.headers.find("Connection")->second, "close");
+    EXPECT_EQ(request.headers.find("Connection")->first, "connection");
+}
@@ -3,6 +3,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <memory_resource>
+
 using namespace ctask::network::http::response_serializer;
 using namespace ctask::utils::types;
 using namespace testing;
@@ -72,3 +75,82 @@ TEST(JsonHttpResponseSerializerTest, GenerateResponse_WithEmptyPayload)
     auto serialized{generator.serialize(meta)};
     EXPECT_TRUE(contains(serialized, "{}"));
 }
+
+TEST(JsonHttpResponseSerializerTest, GenerateResponse_WithBodyStream_ChunkedHeaders)
+{
+    HttpResponse response{HttpStatusCode::HTTP_STATUS_OK, "ignored", {{"Content-Type", "application/x-ndjson"}}};
+    response.bodyStream = [](std::string&) -> asio::awaitable<bool> { co_return false; };
+    HttpResponseMeta meta{response, "1.1"};
+    JsonHttpResponseSerializer generator;
+
+    auto serialized{generator.serialize(meta)};
+    EXPECT_TRUE(contains(serialized, "HTTP/1.1 200 OK"));
+    EXPECT_TRUE(contains(serialized, "Content-Type: application/x-ndjson"));
+    EXPECT_TRUE(contains(serialized, "Transfer-Encoding: chunked"));
+    EXPECT_FALSE(contains(serialized, "Content-Length"));
+    EXPECT_FALSE(contains(serialized, "application/json"));
+    EXPECT_FALSE(contains(serialized, "ignored"));
+}
+
+TEST(JsonHttpResponseSerializerTest, GenerateResponse_WithBodyStream_Http_1_0_NoChunkedHeader)
+{
+    HttpResponse response{HttpStatusCode::HTTP_STATUS_OK};
+    response.bodyStream = [](std::string&) -> asio::awaitable<bool> { co_return false; };
+    HttpResponseMeta meta{response, "1.0"};
+    JsonHttpResponseSerializer generator;
+
+    auto serialized{generator.serialize(meta)};
+    EXPECT_FALSE(contains(serialized, "Transfer-Encoding"));
+    EXPECT_FALSE(contains(serialized, "Content-Length"));
+    EXPECT_TRUE(contains(serialized, "Connection: close\r\n"));
+
+    // the body ends with the connection, it can't be kept alive
+    meta.keepAlive = HttpKeepAlive{true, 5, 0};
+    serialized = generator.serialize(meta);
+    EXPECT_TRUE(contains(serialized, "Connection: close\r\n"));
+    EXPECT_FALSE(contains(serialized, "Keep-Alive"));
+}
+
+TEST(JsonHttpResponseSerializerTest, SerializeChunk)
+{
+    JsonHttpResponseSerializer generator;
+    EXPECT_EQ(generator.serializeChunk("Hello, world!"), "d\r\nHello, world!\r\n");
+    EXPECT_EQ(generator.serializeChunk(std::string(255, 'x')), "ff\r\n" + std::string(255, 'x') + "\r\n");
+    EXPECT_EQ(generator.serializeChunk({}), "0\r\n\r\n");
+}
+
+TEST(JsonHttpResponseSerializerTest, GenerateResponse_IntoPmrString_AppendsSameResponse)
+{
+    HttpResponse response{HttpStatusCode::HTTP_STATUS_OK, R"({"mean":42})", {{"CustomHeader", "CustomValue"}}};
+    HttpResponseMeta meta{response, "1.1"};
+    JsonHttpResponseSerializer generator;
+
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::string serialized{"prefix", &arena};
+    generator.serialize(meta, serialized);
+
+    EXPECT_EQ(std::string_view{serialized}, "prefix" + generator.serialize(meta));
+}
+
+TEST(JsonHttpResponseSerializerTest, GenerateResponse_WithPersistentConnection_KeepAliveHeaders)
+{
+    HttpResponse response{HttpStatusCode::HTTP_STATUS_OK, R"({"mean":42})", {{"connection", "close"}}};
+    HttpResponseMeta meta{response, "1.1", HttpKeepAlive{true, 5, 99}};
+    JsonHttpResponseSerializer generator;
+
+    auto serialized{generator.serialize(meta)};
+    EXPECT_TRUE(contains(serialized, "Connection: Keep-Alive\r\n"));
+    EXPECT_TRUE(contains(serialized, "Keep-Alive: timeout=5, max=99\r\n"));
+    EXPECT_FALSE(contains(serialized, "close"));
+}
+
+TEST(JsonHttpResponseSerializerTest, GenerateResponse_WithClosedConnection_CloseHeader)
+{
+    HttpResponseMeta meta{{HttpStatusCode::HTTP_STATUS_OK}, "1.1", HttpKeepAlive{}};
+    JsonHttpResponseSerializer generator;
+
+    auto serialized{generator.serialize(meta)};
+    EXPECT_TRUE(contains(serialized, "Connection: close\r\n"));
+    EXPECT_FALSE(contains(serialized, "Keep-Alive"));
+}
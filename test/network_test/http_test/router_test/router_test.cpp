@@ -82,12 +82,12 @@ TEST(RouterTest, Routing_ThrownExceptionByHandler_ReturnsInternalServerErrorStat
         EXPECT_NO_THROW(router.addGet(path, throwHandler));
 
         {
-            HttpRequest postReq{HttpMethod::POST_METHOD, path};
+            HttpRequest postReq{HttpMethod::POST_METHOD, std::pmr::string{path}};
             auto response{router.route(postReq)};
             ASSERT_EQ(response.code, HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR);
         }
         {
-            HttpRequest getReq{HttpMethod::GET_METHOD, path};
+            HttpRequest getReq{HttpMethod::GET_METHOD, std::pmr::string{path}};
             auto response{router.route(getReq)};
             ASSERT_EQ(response.code, HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR);
         }
@@ -104,7 +104,7 @@ TEST(RouterTest, Routing_HandleUnsupportedMethod_ReturnsNotImplemented)
     for (const auto& path : pathes)
     {
         HttpRouter router;
-        HttpRequest request{HttpMethod::UNKNOWN_METHOD, path};
+        HttpRequest request{HttpMethod::UNKNOWN_METHOD, std::pmr::string{path}};
         EXPECT_NO_THROW(router.addPost(path, [&](const HttpRequest& req) { return HttpResponse{}; }));
         EXPECT_NO_THROW(router.addGet(path, [&](const HttpRequest& req) { return HttpResponse{}; }));
         auto response{router.route(request)};
@@ -117,20 +117,20 @@ TEST(RouterTest, Route_ParseParameterizedRequest)
     std::string parameterizedGetPath{"/path/{get_event}/get/Hello/{get_time}/{get_date}"};
     std::string parameterizedPostPath{"/path/{post_event}/P0St_something/{post_time}/{post_date}"};
 
-    std::unordered_map<ParameterName, ParameterValue> expectedGetParams{
+    HttpParameters expectedGetParams{
         {"get_event", "GET_EVENT_PARAM"},
         {"get_time", "GET_TIME_PARAM"},
         {"get_date", "GET_DATE_PARAM"},
     };
 
-    std::unordered_map<ParameterName, ParameterValue> expectedPostParams{
+    HttpParameters expectedPostParams{
         {"post_event", "POST_EVENT_PARAM"},
         {"post_time", "POST_TIME_PARAM"},
         {"post_date", "POST_DATE_PARAM"},
     };
 
-    std::unordered_map<ParameterName, ParameterValue> actualGetParams{};
-    std::unordered_map<ParameterName, ParameterValue> actualPostParams{};
+    HttpParameters actualGetParams{};
+    HttpParameters actualPostParams{};
 
     HttpRouter router;
     auto getHandler{
@@ -196,8 +196,91 @@ TEST(RouterTest, CreateRouter_RegisterPostHandlers)
 
     for (auto& postSuite : postRouteSuites)
     {
-        HttpRequest req{HttpMethod::POST_METHOD, postSuite.path};
+        HttpRequest req{HttpMethod::POST_METHOD, std::pmr::string{postSuite.path}};
         router.route(req);
         EXPECT_EQ(postSuite.actualCalls, postSuite.expectedCalls);
     }
 }
+
+TEST(RouterTest, Route_SeveralParameterizedPaths_MatchesStaticSegments)
+{
+    HttpRouter router;
+
+    std::vector<RouterTestSuite> getRouteSuites{
+        {"/paths/{event}/meanLength", 0, 1},
+        {"/paths/{event}/export", 0, 1},
+        {"/paths/{event}", 0, 1},
+    };
+
+    for (auto& getSuite : getRouteSuites)
+    {
+        router.addGet(getSuite.path, [&](const HttpRequest& req)
+        {
+            ++getSuite.actualCalls;
+            EXPECT_EQ(req.parameters.at("event"), "home");
+            return HttpResponse{};
+        });
+    }
+
+    for (const auto& path : {"/paths/home/meanLength", "/paths/home/export", "/paths/home"})
+    {
+        HttpRequest req{HttpMethod::GET_METHOD, path};
+        EXPECT_EQ(router.route(req).code, HttpStatusCode::HTTP_STATUS_OK);
+    }
+
+    for (const auto& getSuite : getRouteSuites)
+    {
+        EXPECT_EQ(getSuite.actualCalls, getSuite.expectedCalls);
+    }
+
+    for (const auto& path : {"/paths/home/unknown", "/paths/home/export/more", "/paths", "/other/home/export"})
+    {
+        HttpRequest req{HttpMethod::GET_METHOD, path};
+        EXPECT_EQ(router.route(req).code, HttpStatusCode::HTTP_STATUS_NOT_FOUND);
+    }
+}
+
+TEST(RouterTest, AsyncRoute_AwaitableHandler_ResumesWithResponse)
+{
+    HttpRouter router;
+    router.addGet("/async/{event}", [](const HttpRequest& req) -> asio::awaitable<HttpResponse>
+    {
+        co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, std::string{req.parameters.at("event")}};
+    });
+    router.addPost("/sync", [](const HttpRequest& req) { return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, "sync"}; });
+
+    asio::io_context ctx{};
+    std::vector<HttpResponse> responses{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        HttpRequest asyncRequest{HttpMethod::GET_METHOD, "/async/home"};
+        responses.push_back(co_await router.asyncRoute(asyncRequest, 0));
+        HttpRequest syncRequest{HttpMethod::POST_METHOD, "/sync"};
+        responses.push_back(co_await router.asyncRoute(syncRequest, 0));
+    }, asio::detached);
+    ctx.run();
+
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(responses[0].message, "home");
+    EXPECT_EQ(responses[1].message, "sync");
+}
+
+TEST(RouterTest, Route_AwaitableHandlerThrows_ReturnsInternalServerErrorStatus)
+{
+    HttpRouter router;
+    router.addGet("/ok", [](const HttpRequest&) -> asio::awaitable<HttpResponse>
+    {
+        co_return HttpResponse{HttpStatusCode::HTTP_STATUS_OK, "ok"};
+    });
+    router.addGet("/throw", [](const HttpRequest&) -> asio::awaitable<HttpResponse>
+    {
+        throw std::runtime_error("Exploded");
+        co_return HttpResponse{};
+    });
+
+    // the blocking route() drives awaitable handlers too
+    HttpRequest ok{HttpMethod::GET_METHOD, "/ok"};
+    EXPECT_EQ(router.route(ok).message, "ok");
+    HttpRequest thrown{HttpMethod::GET_METHOD, "/throw"};
+    EXPECT_EQ(router.route(thrown).code, HttpStatusCode::HTTP_STATUS_INTERNAL_SERVER_ERROR);
+}
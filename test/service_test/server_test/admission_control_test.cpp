@@ -0,0 +1,59 @@
+#include "service/http_server/admission_control.h"
+
+#include <gtest/gtest.h>
+
+using namespace ctask::service;
+using namespace ctask::utils::types;
+
+TEST(AdmissionControlTest, TryAdmit_NoLimits_AlwaysAdmitted)
+{
+    AdmissionControl admission{{}, 2};
+    for (int i{0}; i < 1000; ++i)
+    {
+        ASSERT_TRUE(admission.tryAdmitConnection());
+        ASSERT_TRUE(admission.tryAdmitRequest());
+    }
+    EXPECT_EQ(admission.connections(), 1000);
+    EXPECT_EQ(admission.inFlightRequests(), 1000);
+    EXPECT_EQ(admission.queueDepth(), 998);
+}
+
+TEST(AdmissionControlTest, TryAdmitConnection_OverLimit_RejectedUntilReleased)
+{
+    AdmissionControl admission{{2, 0, 0}, 4};
+    EXPECT_TRUE(admission.tryAdmitConnection());
+    EXPECT_TRUE(admission.tryAdmitConnection());
+    EXPECT_FALSE(admission.tryAdmitConnection());
+    EXPECT_EQ(admission.connections(), 2);
+
+    admission.releaseConnection();
+    EXPECT_TRUE(admission.tryAdmitConnection());
+}
+
+TEST(AdmissionControlTest, TryAdmitRequest_OverInFlightLimit_Rejected)
+{
+    AdmissionControl admission{{0, 3, 0}, 1};
+    for (int i{0}; i < 3; ++i)
+    {
+        ASSERT_TRUE(admission.tryAdmitRequest());
+    }
+    EXPECT_FALSE(admission.tryAdmitRequest());
+    EXPECT_EQ(admission.inFlightRequests(), 3);
+    EXPECT_EQ(admission.queueDepth(), 2);
+
+    admission.releaseRequest();
+    EXPECT_TRUE(admission.tryAdmitRequest());
+}
+
+TEST(AdmissionControlTest, TryAdmitRequest_OverQueueDepth_Rejected)
+{
+    // 4 threads busy and 2 more waiting
+    AdmissionControl admission{{0, 100, 2}, 4};
+    for (int i{0}; i < 6; ++i)
+    {
+        ASSERT_TRUE(admission.tryAdmitRequest());
+    }
+    EXPECT_EQ(admission.queueDepth(), 2);
+    EXPECT_FALSE(admission.tryAdmitRequest());
+    EXPECT_EQ(admission.inFlightRequests(), 6);
+}
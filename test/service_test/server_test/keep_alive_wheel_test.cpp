@@ -0,0 +1,73 @@
+#include "service/http_server/keep_alive_wheel.h"
+
+#include <gtest/gtest.h>
+
+using namespace asio;
+using namespace ctask::service;
+using namespace std::chrono_literals;
+
+constexpr auto TICK{10ms};
+constexpr size_t SLOTS{8};
+
+TEST(KeepAliveWheelTest, CreateWheel_ZeroShards_ThrowsException)
+{
+    io_context ctx;
+    EXPECT_THROW(KeepAliveWheel(ctx, 0, TICK, SLOTS), std::invalid_argument);
+    EXPECT_THROW(KeepAliveWheel(ctx, 1, TICK, 0), std::invalid_argument);
+    EXPECT_THROW(KeepAliveWheel(ctx, 1, 0ms, SLOTS), std::invalid_argument);
+}
+
+TEST(KeepAliveWheelTest, Add_IdleConnection_ExpiredOnce)
+{
+    io_context ctx;
+    KeepAliveWheel wheel{ctx, 2, TICK, SLOTS};
+    wheel.start();
+
+    int expired{0};
+    const auto start{KeepAliveWheel::Clock::now()};
+    auto entry{wheel.add(50ms, [&expired]() { ++expired; })};
+
+    ctx.run_for(300ms);
+    EXPECT_EQ(expired, 1);
+    EXPECT_GE(KeepAliveWheel::Clock::now() - start, 50ms);
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(KeepAliveWheelTest, Refresh_BusyConnection_NotExpired)
+{
+    io_context ctx;
+    KeepAliveWheel wheel{ctx, 1, TICK, SLOTS};
+    wheel.start();
+
+    int expired{0};
+    auto entry{wheel.add(50ms, [&expired]() { ++expired; })};
+
+    // timeout is longer than the whole wheel round, the entry makes a few rounds meanwhile
+    steady_timer refresher{ctx};
+    std::function<void(const error_code&)> refresh = [&](const error_code&)
+    {
+        entry->refresh();
+        refresher.expires_after(20ms);
+        refresher.async_wait(refresh);
+    };
+    refresh({});
+
+    ctx.run_for(300ms);
+    EXPECT_EQ(expired, 0);
+    EXPECT_EQ(wheel.size(), 1);
+}
+
+TEST(KeepAliveWheelTest, Cancel_ClosedConnection_NeverExpiredAndDropped)
+{
+    io_context ctx;
+    KeepAliveWheel wheel{ctx, 1, TICK, SLOTS};
+    wheel.start();
+
+    int expired{0};
+    auto entry{wheel.add(30ms, [&expired]() { ++expired; })};
+    entry->cancel();
+
+    ctx.run_for(200ms);
+    EXPECT_EQ(expired, 0);
+    EXPECT_EQ(wheel.size(), 0);
+}
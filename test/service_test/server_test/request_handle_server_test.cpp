@@ -27,10 +27,11 @@ void clientRoutine(io_context& ctx,
         tcp::socket socket(ctx);
         auto endpoint = resolver.resolve(address, port);
 
+        // the server might not listen yet, so connection is refused for a while
         error_code ec;
-        for (int i{0}; i < 10; ++i)
+        for (int i{0}; i < 100; ++i)
         {
-            connect(socket, endpoint);
+            connect(socket, endpoint, ec);
             if (!ec)
             {
                 break;
@@ -192,4 +193,170 @@ TEST(HandlingRequestServerTest, HandleRequest_WithCloseConnectionHeader_ValidPay
     clientThread.join();
 }
 
+TEST(HandlingRequestServerTest, HandleRequest_WithBodyStream_SendsChunkedBody)
+{
+    io_service serverCtx;
+    const HttpServerArgs args{"127.0.0.1", 8080, 4, 1};
+
+    HttpResponse expectedResponse{HttpStatusCode::HTTP_STATUS_OK};
+    expectedResponse.bodyStream = [part = 0](std::string& chunk) mutable -> asio::awaitable<bool>
+    {
+        if (part == 3)
+        {
+            co_return false;
+        }
+        chunk.assign(std::format("{{\"part\":{}}}\n", part++));
+        co_return true;
+    };
+    auto router{std::make_unique<MockRouter>()};
+    EXPECT_CALL(*router, route(_)).WillOnce(Return(expectedResponse));
+
+    auto server = HttpServer::сreateService(serverCtx, args, std::move(router));
+    auto clientSession = [&](tcp::socket s)
+    {
+        auto request{
+            requestGenerator("GET", "/", args.address, std::to_string(args.port), "{}", {{"Connection", "close"}})
+        };
+
+        error_code ec;
+        write(s, buffer(request.data(), request.size()), ec);
+        if (ec)
+        {
+            FAIL() << ec.message();
+        }
+
+        // the client asked to close, so server closes connection right after the last chunk
+        std::string response;
+        std::array<char, 1024> container{};
+        for (;;)
+        {
+            auto size = s.read_some(buffer(container), ec);
+            response.append(container.data(), size);
+            if (ec)
+            {
+                break;
+            }
+        }
+
+        EXPECT_NE(response.find("Transfer-Encoding: chunked"), std::string::npos);
+        auto body{response.substr(response.find("\r\n\r\n") + 4)};
+        EXPECT_EQ(body, "b\r\n{\"part\":0}\n\r\nb\r\n{\"part\":1}\n\r\nb\r\n{\"part\":2}\n\r\n0\r\n\r\n");
+
+        s.close();
+        serverCtx.stop();
+    };
+
+    io_context clientCtx;
+    std::jthread clientThread(clientRoutine, std::ref(clientCtx), args.address, std::to_string(args.port),
+                              clientSession);
+    EXPECT_NO_THROW(server->start());
+    clientThread.join();
+}
+
+TEST(HandlingRequestServerTest, HandleRequest_OverConnectionLimit_ServiceUnavailable)
+{
+    io_service serverCtx;
+    HttpServerArgs args{"127.0.0.1", 8080, 4, 2};
+    args.admission.maxConnections = 1;
+    HttpResponse expectedResponse{HttpStatusCode::HTTP_STATUS_OK, "Hello from test server"};
+    auto router{std::make_unique<MockRouter>()};
+    EXPECT_CALL(*router, route(_)).WillOnce(Return(expectedResponse));
+
+    auto server = HttpServer::сreateService(serverCtx, args, std::move(router));
+    auto clientSession = [&](tcp::socket s)
+    {
+        // the first connection is served and holds the only slot
+        auto request{
+            requestGenerator("GET", "/", args.address, std::to_string(args.port), "{}", {{"Connection", "Keep-Alive"}})
+        };
+
+        error_code ec;
+        write(s, buffer(request.data(), request.size()), ec);
+        std::array<char, 1024> container{};
+        auto size = s.read_some(buffer(container), ec);
+        if (ec)
+        {
+            FAIL() << ec.message();
+        }
+        EXPECT_TRUE(std::string_view(container.data(), size).starts_with("HTTP/1.1 200"));
+
+        // the second one is answered right away and closed
+        tcp::socket rejected{s.get_executor()};
+        rejected.connect(s.remote_endpoint());
+        std::string response;
+        for (;;)
+        {
+            size = rejected.read_some(buffer(container), ec);
+            response.append(container.data(), size);
+            if (ec)
+            {
+                break;
+            }
+        }
+        EXPECT_TRUE(response.starts_with("HTTP/1.1 503"));
+        EXPECT_NE(response.find("Retry-After: 1"), std::string::npos);
+
+        s.close();
+        serverCtx.stop();
+    };
+
+    io_context clientCtx;
+    std::jthread clientThread(clientRoutine, std::ref(clientCtx), args.address, std::to_string(args.port),
+                              clientSession);
+    EXPECT_NO_THROW(server->start());
+    clientThread.join();
+}
+
+TEST(HandlingRequestServerTest, HandleRequest_Http_1_1_WithoutConnectionHeader_PersistentByDefault)
+{
+    io_service serverCtx;
+    const HttpServerArgs args{"127.0.0.1", 8080, 4, 2, 3};
+    HttpResponse expectedResponse{HttpStatusCode::HTTP_STATUS_OK, "Hello from test server"};
+    auto router{std::make_unique<MockRouter>()};
+    EXPECT_CALL(*router, route(_)).Times(3).WillRepeatedly(Return(expectedResponse));
+
+    auto server = HttpServer::сreateService(serverCtx, args, std::move(router));
+    auto clientSession = [&](tcp::socket s)
+    {
+        auto request{requestGenerator("GET", "/", args.address, std::to_string(args.port), "{}")};
+
+        // every request goes through the same connection, the last allowed one closes it
+        error_code ec;
+        std::array<char, 1024> container{};
+        for (size_t i{1}; i <= args.keepAliveMaxRequests; ++i)
+        {
+            write(s, buffer(request.data(), request.size()), ec);
+            auto size = s.read_some(buffer(container), ec);
+            if (ec)
+            {
+                FAIL() << ec.message();
+            }
+            std::string_view response{container.data(), size};
+            EXPECT_TRUE(response.starts_with("HTTP/1.1 200"));
+            if (i < args.keepAliveMaxRequests)
+            {
+                EXPECT_NE(response.find("Connection: Keep-Alive\r\n"), std::string_view::npos);
+                EXPECT_NE(response.find(std::format("Keep-Alive: timeout={}, max={}\r\n", args.keepAliveSec,
+                                                    args.keepAliveMaxRequests - i)), std::string_view::npos);
+            }
+            else
+            {
+                EXPECT_NE(response.find("Connection: close\r\n"), std::string_view::npos);
+            }
+        }
+
+        s.read_some(buffer(container), ec);
+        EXPECT_EQ(ec, error::eof);
+
+        s.close();
+        serverCtx.stop();
+    };
+
+    io_context clientCtx;
+    std::jthread clientThread(clientRoutine, std::ref(clientCtx), args.address, std::to_string(args.port),
+                              clientSession);
+    EXPECT_NO_THROW(server->start());
+    clientThread.join();
+}
+
 #endif
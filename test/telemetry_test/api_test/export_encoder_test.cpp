@@ -0,0 +1,82 @@
+#include "telemetry/api/export_encoder.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+using namespace ctask::telemetry::api;
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+const auto EXPORT_EVENT_MODELS{
+    std::vector<InteractionTimesEventModel>{
+        {10, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}},
+        {1711040000, {-1, 0, 2147483647, 0, 0, 0, 0, 0, 0, 1}},
+    }
+};
+
+TEST(ExportEncoderTest, Encode_Ndjson)
+{
+    std::string out{"prefix\n"};
+    ExportEncoder::encode(ExportFormat::Ndjson, EXPORT_EVENT_MODELS, out);
+    EXPECT_EQ(out,
+              "prefix\n"
+              R"({"date":10,"values":[1,2,3,4,5,6,7,8,9,10]})" "\n"
+              R"({"date":1711040000,"values":[-1,0,2147483647,0,0,0,0,0,0,1]})" "\n");
+}
+
+TEST(ExportEncoderTest, Encode_Empty_AppendsNothing)
+{
+    std::string out;
+    ExportEncoder::encode(ExportFormat::Ndjson, std::vector<InteractionTimesEventModel>{}, out);
+    ExportEncoder::encode(ExportFormat::Columnar, std::vector<InteractionTimesEventModel>{}, out);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(ExportEncoderTest, Encode_Columnar)
+{
+    std::string out;
+    ExportEncoder::encode(ExportFormat::Columnar, EXPORT_EVENT_MODELS, out);
+
+    const auto rows{EXPORT_EVENT_MODELS.size()};
+    ASSERT_EQ(out.size(), 8 + rows * 8 + rows * INTERACTION_TIMES_LEN * 4);
+
+    auto read = [&out]<typename T>(size_t offset, T)
+    {
+        T value{};
+        std::memcpy(&value, out.data() + offset, sizeof(T));
+        return value;
+    };
+
+    EXPECT_EQ(read(0, uint32_t{}), rows);
+    EXPECT_EQ(read(4, uint32_t{}), INTERACTION_TIMES_LEN);
+    EXPECT_EQ(read(8, uint64_t{}), 10);
+    EXPECT_EQ(read(16, uint64_t{}), 1711040000);
+
+    // columns go one after another, every column holds a single step of all rows
+    const size_t valuesOffset{24};
+    for (size_t column{0}; column < INTERACTION_TIMES_LEN; ++column)
+    {
+        for (size_t row{0}; row < rows; ++row)
+        {
+            EXPECT_EQ(read(valuesOffset + (column * rows + row) * 4, int32_t{}),
+                      EXPORT_EVENT_MODELS[row].values[column]);
+        }
+    }
+}
+
+TEST(ExportEncoderTest, Encode_OtherFamily_RowLengthFollowsFamily)
+{
+    const std::vector<BasicInteractionTimesEventModel<5>> events{{7, {1, 2, 3, 4, 5}}};
+
+    std::string ndjson;
+    ExportEncoder::encode(ExportFormat::Ndjson, events, ndjson);
+    EXPECT_EQ(ndjson, R"({"date":7,"values":[1,2,3,4,5]})" "\n");
+
+    std::string columnar;
+    ExportEncoder::encode(ExportFormat::Columnar, events, columnar);
+    ASSERT_EQ(columnar.size(), 8 + 8 + 5 * 4);
+
+    uint32_t valuesPerRow{};
+    std::memcpy(&valuesPerRow, columnar.data() + 4, sizeof(valuesPerRow));
+    EXPECT_EQ(valuesPerRow, 5);
+}
@@ -0,0 +1,194 @@
+#include "telemetry/core/event_lsm_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+namespace
+{
+    InteractionTimesEventModel makeEvent(EventDateType date)
+    {
+        InteractionTimesEventModel event{};
+        event.date = date;
+        event.values.fill(static_cast<InteractionTimeType>(date % 1000));
+        return event;
+    }
+
+    std::vector<EventDateType> orderedDates(const EventLsmTree& tree, uint64_t from, uint64_t to)
+    {
+        std::vector<EventDateType> dates{};
+        tree.forEachOrdered(from, to, [&dates](const InteractionTimesEventModel& event)
+        {
+            dates.push_back(event.date);
+            return true;
+        });
+        return dates;
+    }
+
+    void compactAll(EventLsmTree& tree)
+    {
+        while (auto compaction{tree.planCompaction()})
+        {
+            ASSERT_TRUE(tree.installCompaction(*compaction, EventLsmTree::merge(compaction->inputs)));
+        }
+    }
+}
+
+TEST(EventLsmTreeTest, Constructor_ZeroCapacity_Throws)
+{
+    EXPECT_THROW(EventLsmTree{0}, std::invalid_argument);
+}
+
+TEST(EventLsmTreeTest, Insert_SharedDate_AllKeptInArrivalOrder)
+{
+    EventLsmTree tree{4};
+    tree.insert(makeEvent(10));
+    tree.insert(makeEvent(5));
+
+    auto shared{makeEvent(10)};
+    shared.values.fill(7);
+    tree.insert(shared);
+
+    // one in a sealed run, one in the buffer, the older one still comes first
+    tree.sealBuffer();
+    shared.values.fill(8);
+    tree.insert(shared);
+    EXPECT_EQ(tree.size(), 4);
+    EXPECT_EQ(tree.runs(), 1);
+    EXPECT_EQ(tree.buffered(), 1);
+
+    std::vector<InteractionTimesEventModel> events{};
+    tree.forEachOrdered(0, 100, [&events](const InteractionTimesEventModel& event)
+    {
+        events.push_back(event);
+        return true;
+    });
+    ASSERT_EQ(events.size(), 4);
+    EXPECT_EQ(events[0].date, 5);
+    EXPECT_EQ(events[1].date, 10);
+    EXPECT_EQ(events[1].values, makeEvent(10).values);
+    EXPECT_EQ(events[2].values[0], 7);
+    EXPECT_EQ(events[3].values[0], 8);
+}
+
+TEST(EventLsmTreeTest, ForEachOrdered_OutOfOrderInsertsAndCompaction_MatchesMultimap)
+{
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<EventDateType> dates{1, 5'000};
+
+    // dates repeat, values tell events of a date apart
+    EventLsmTree tree{64};
+    std::multimap<EventDateType, InteractionTimeType> reference{};
+    for (int i{0}; i < 10'000; ++i)
+    {
+        auto event{makeEvent(dates(random))};
+        event.values[0] = static_cast<InteractionTimeType>(i);
+        tree.insert(event);
+        reference.emplace(event.date, event.values[0]);
+        if (i % 1'000 == 0)
+        {
+            compactAll(tree);
+        }
+    }
+    EXPECT_EQ(tree.size(), reference.size());
+    EXPECT_EQ(tree.minDate(), reference.begin()->first);
+    EXPECT_EQ(tree.maxDate(), reference.rbegin()->first);
+
+    auto check = [&tree, &reference](uint64_t from, uint64_t to)
+    {
+        std::vector<std::pair<EventDateType, InteractionTimeType>> expected{};
+        for (auto it{reference.lower_bound(from)}; it != reference.end() && it->first <= to; ++it)
+        {
+            expected.emplace_back(it->first, it->second);
+        }
+
+        std::vector<std::pair<EventDateType, InteractionTimeType>> ordered{};
+        tree.forEachOrdered(from, to, [&ordered](const InteractionTimesEventModel& event)
+        {
+            ordered.emplace_back(event.date, event.values[0]);
+            return true;
+        });
+        EXPECT_EQ(ordered, expected) << from << ".." << to;
+
+        std::vector<std::pair<EventDateType, InteractionTimeType>> unordered{};
+        tree.forEach(from, to, [&unordered](const InteractionTimesEventModel& event)
+        {
+            unordered.emplace_back(event.date, event.values[0]);
+        });
+        std::sort(expected.begin(), expected.end());
+        std::sort(unordered.begin(), unordered.end());
+        EXPECT_EQ(unordered, expected) << from << ".." << to;
+    };
+    check(0, 10'000);
+    check(1'234, 3'456);
+    check(4'999, 4'999);
+    check(6'000, 7'000);
+
+    // size tiers keep the amount of runs logarithmic
+    compactAll(tree);
+    EXPECT_LE(tree.runs(), 10);
+    check(0, 10'000);
+}
+
+TEST(EventLsmTreeTest, ForEachOrdered_FnReturnsFalse_Stops)
+{
+    EventLsmTree tree{8};
+    for (EventDateType date{100}; date > 0; --date)
+    {
+        tree.insert(makeEvent(date));
+    }
+
+    std::vector<EventDateType> dates{};
+    tree.forEachOrdered(10, 100, [&dates](const InteractionTimesEventModel& event)
+    {
+        dates.push_back(event.date);
+        return dates.size() < 3;
+    });
+    EXPECT_EQ(dates, (std::vector<EventDateType>{10, 11, 12}));
+}
+
+TEST(EventLsmTreeTest, InstallCompaction_RunsChangedSincePlan_Refused)
+{
+    EventLsmTree tree{2};
+    for (EventDateType date{1}; date <= 8; ++date)
+    {
+        tree.insert(makeEvent(date));
+    }
+    auto compaction{tree.planCompaction()};
+    ASSERT_TRUE(compaction.has_value());
+
+    auto merged{EventLsmTree::merge(compaction->inputs)};
+    compactAll(tree);
+    const auto runs{tree.runs()};
+
+    EXPECT_FALSE(tree.installCompaction(*compaction, std::move(merged)));
+    EXPECT_EQ(tree.runs(), runs);
+    EXPECT_EQ(orderedDates(tree, 0, 100), (std::vector<EventDateType>{1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST(EventLsmTreeTest, Count_RunsAndUnsortedBuffer_MatchesWalk)
+{
+    EventLsmTree tree{8};
+    std::mt19937 random{7};
+    for (int i{0}; i < 100; ++i)
+    {
+        tree.insert(makeEvent(random() % 50));
+    }
+    ASSERT_GT(tree.runs(), 0);
+    ASSERT_GT(tree.buffered(), 0);
+
+    for (uint64_t from{0}; from < 55; from += 5)
+    {
+        for (uint64_t to{from}; to < 60; to += 7)
+        {
+            EXPECT_EQ(tree.count(from, to), orderedDates(tree, from, to).size()) << from << " - " << to;
+        }
+    }
+    EXPECT_EQ(tree.count(0, 100), 100);
+    EXPECT_EQ(tree.count(60, 100), 0);
+}
@@ -0,0 +1,37 @@
+#include "telemetry/core/event_name_table.h"
+
+#include <gtest/gtest.h>
+
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+TEST(EventNameTableTest, Intern_HandsOutDenseIds)
+{
+    EventNameTable table{};
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_FALSE(table.find("signup").has_value());
+
+    EXPECT_EQ(table.intern("signup"), 0);
+    EXPECT_EQ(table.intern("login"), 1);
+    EXPECT_EQ(table.intern(std::string{"signup"}), 0);
+    EXPECT_EQ(table.size(), 2);
+
+    ASSERT_TRUE(table.find("login").has_value());
+    EXPECT_EQ(*table.find("login"), 1);
+    EXPECT_EQ(table.name(0), "signup");
+    EXPECT_EQ(table.name(1), "login");
+    EXPECT_THROW(table.name(2), std::out_of_range);
+}
+
+TEST(EventNameTableTest, Name_StaysValidWhileTableGrows)
+{
+    EventNameTable table{};
+    const auto first{table.name(table.intern("a rather long event name, longer than any small string buffer"))};
+    for (int i{0}; i < 10'000; ++i)
+    {
+        table.intern(std::to_string(i));
+    }
+
+    EXPECT_EQ(first, "a rather long event name, longer than any small string buffer");
+    EXPECT_EQ(table.name(10'000), "9999");
+}
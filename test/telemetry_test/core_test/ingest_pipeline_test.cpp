@@ -0,0 +1,155 @@
+#include "telemetry/core/ingest_pipeline.h"
+#include "telemetry/core/telemetry_storage.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+TEST(IngestPipelineTest, TryEnqueue_SeveralThreads_AllStoredAfterFlush)
+{
+    auto storage{std::make_shared<TelemetryStorage>()};
+    IngestPipeline pipeline{storage, IngestAck::ENQUEUED, 2, 64};
+
+    constexpr uint64_t EVENTS{5000};
+    {
+        std::vector<std::jthread> producers{};
+        for (uint64_t t{0}; t < 4; ++t)
+        {
+            producers.emplace_back([&pipeline, t]()
+            {
+                const auto eventName{t % 2 == 0 ? "even" : "odd"};
+                for (uint64_t i{0}; i < EVENTS; ++i)
+                {
+                    InteractionTimesEventModel event{t * EVENTS + i, {static_cast<InteractionTimeType>(t)}};
+                    while (!pipeline.tryEnqueue(eventName, event))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+    }
+    pipeline.flush();
+
+    EXPECT_EQ(storage->getEventInteractions("even", 0, 4 * EVENTS).size(), 2 * EVENTS);
+    EXPECT_EQ(storage->getEventInteractions("odd", 0, 4 * EVENTS).size(), 2 * EVENTS);
+    EXPECT_EQ(storage->getEventInteractions("even", EVENTS * 2, EVENTS * 3 - 1)[0][0], 2);
+}
+
+TEST(IngestPipelineTest, TryEnqueue_SameDateTwice_BothKeptInArrivalOrder)
+{
+    auto storage{std::make_shared<TelemetryStorage>()};
+    IngestPipeline pipeline{storage};
+
+    // the batch is sorted by date, events of a date stay in the order they came in
+    ASSERT_TRUE(pipeline.tryEnqueue("home", {20, {1}}));
+    ASSERT_TRUE(pipeline.tryEnqueue("home", {10, {2}}));
+    ASSERT_TRUE(pipeline.tryEnqueue("home", {20, {3}}));
+    pipeline.flush();
+
+    const auto interactions{storage->getEventInteractions("home", 0, 100)};
+    ASSERT_EQ(interactions.size(), 3);
+    EXPECT_EQ(interactions[0][0], 2);
+    EXPECT_EQ(interactions[1][0], 1);
+    EXPECT_EQ(interactions[2][0], 3);
+}
+
+TEST(IngestPipelineTest, AsyncIngest_AckApplied_ResumesOnceStored)
+{
+    auto storage{std::make_shared<TelemetryStorage>()};
+    IngestPipeline pipeline{storage, IngestAck::APPLIED, 1, 64, std::chrono::hours(1)};
+
+    asio::io_context ctx{};
+    size_t storedOnResume{0};
+    std::thread::id resumedThread{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        co_await pipeline.asyncIngest("home", {10, {1, 2, 3}});
+        storedOnResume = storage->getEventInteractions("home", 0, 100).size();
+        resumedThread = std::this_thread::get_id();
+    }, asio::detached);
+    ctx.run();
+
+    // the writer sleeps for an hour unless it's woken up by the waiting handler
+    EXPECT_EQ(storedOnResume, 1);
+    EXPECT_EQ(resumedThread, std::this_thread::get_id());
+}
+
+TEST(IngestPipelineTest, AsyncIngest_RingFull_AppliedInThreadOrder)
+{
+    auto storage{std::make_shared<TelemetryStorage>()};
+    IngestPipeline pipeline{storage, IngestAck::ENQUEUED, 1, 1, std::chrono::hours(1)};
+
+    // a single date, the storage keeps events of a date in the order they were applied
+    constexpr InteractionTimeType EVENTS{8};
+    asio::io_context ctx{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        for (InteractionTimeType value{1}; value <= EVENTS / 2; ++value)
+        {
+            co_await pipeline.asyncIngest("home", {10, {value}});
+        }
+    }, asio::detached);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        // queued behind the in-place stores of the first coroutine, on the same thread
+        for (InteractionTimeType value{EVENTS / 2 + 1}; value <= EVENTS; ++value)
+        {
+            co_await pipeline.asyncIngest("home", {10, {value}});
+        }
+    }, asio::detached);
+    ctx.run();
+    pipeline.flush();
+
+    const auto interactions{storage->getEventInteractions("home", 0, 100)};
+    std::vector<InteractionTimeType> applied{};
+    for (const auto& interaction : interactions)
+    {
+        applied.push_back(interaction[0]);
+    }
+
+    // both coroutines interleave, but every one's events keep their order and none is lost
+    ASSERT_EQ(applied.size(), EVENTS);
+    auto first{std::stable_partition(applied.begin(), applied.end(),
+                                     [](InteractionTimeType value) { return value <= EVENTS / 2; })};
+    EXPECT_TRUE(std::is_sorted(applied.begin(), first));
+    EXPECT_TRUE(std::is_sorted(first, applied.end()));
+}
+
+TEST(IngestPipelineTest, AsyncIngest_RingFull_StoredAfterQueuedOnes)
+{
+    auto storage{std::make_shared<TelemetryStorage>()};
+    IngestPipeline pipeline{storage, IngestAck::ENQUEUED, 1, 1, std::chrono::hours(1)};
+
+    asio::io_context ctx{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        for (InteractionTimeType value{1}; value <= 5; ++value)
+        {
+            co_await pipeline.asyncIngest("home", {10, {value}});
+        }
+    }, asio::detached);
+    ctx.run();
+    pipeline.flush();
+
+    // the first one waits in the ring, the rest don't fit and are stored in place after it
+    std::vector<InteractionTimeType> applied{};
+    for (const auto& interaction : storage->getEventInteractions("home", 0, 100))
+    {
+        applied.push_back(interaction[0]);
+    }
+    EXPECT_EQ(applied, (std::vector<InteractionTimeType>{1, 2, 3, 4, 5}));
+}
+
+TEST(IngestPipelineTest, IngestAckFromString_UnknownName_ThrowsException)
+{
+    EXPECT_EQ(ingestAckFromString("enqueued"), IngestAck::ENQUEUED);
+    EXPECT_EQ(ingestAckFromString("applied"), IngestAck::APPLIED);
+    EXPECT_THROW(ingestAckFromString("whenever"), std::invalid_argument);
+}
@@ -0,0 +1,80 @@
+#include "telemetry/core/mean_length_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+static MeanLengthCacheKey makeKey(uint64_t start)
+{
+    return {1, start, start + 100, TimeUnit::Seconds};
+}
+
+TEST(MeanLengthCacheTest, CreateCache_ZeroCapacityOrShards_ThrowsException)
+{
+    EXPECT_THROW(MeanLengthCache(0), std::invalid_argument);
+    EXPECT_THROW(MeanLengthCache(10, 0), std::invalid_argument);
+}
+
+TEST(MeanLengthCacheTest, Put_ThenGet_ReturnsValue)
+{
+    MeanLengthCache cache{10};
+    EXPECT_FALSE(cache.get(makeKey(1)).has_value());
+
+    cache.put(makeKey(1), {1.5, 3});
+    auto cached{cache.get(makeKey(1))};
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->mean, 1.5);
+    EXPECT_EQ(cached->version, 3);
+
+    // every part of the key matters
+    EXPECT_FALSE(cache.get({1, 1, 101, TimeUnit::Milliseconds}).has_value());
+    EXPECT_FALSE(cache.get({2, 1, 101, TimeUnit::Seconds}).has_value());
+    EXPECT_FALSE(cache.get({1, 1, 102, TimeUnit::Seconds}).has_value());
+
+    cache.put(makeKey(1), {2.5, 4});
+    EXPECT_EQ(cache.get(makeKey(1))->mean, 2.5);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(MeanLengthCacheTest, Put_OverCapacity_EvictsLeastRecentlyUsed)
+{
+    // single shard to make eviction order predictable
+    MeanLengthCache cache{3, 1};
+    cache.put(makeKey(1), {1, 0});
+    cache.put(makeKey(2), {2, 0});
+    cache.put(makeKey(3), {3, 0});
+
+    // touch the oldest one, so the second becomes the least recently used
+    EXPECT_TRUE(cache.get(makeKey(1)).has_value());
+    cache.put(makeKey(4), {4, 0});
+
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_TRUE(cache.get(makeKey(1)).has_value());
+    EXPECT_FALSE(cache.get(makeKey(2)).has_value());
+    EXPECT_TRUE(cache.get(makeKey(3)).has_value());
+    EXPECT_TRUE(cache.get(makeKey(4)).has_value());
+}
+
+TEST(MeanLengthCacheTest, ConcurrentAccess_StaysBounded)
+{
+    MeanLengthCache cache{64};
+    std::vector<std::jthread> threads;
+    for (uint64_t t{0}; t < 4; ++t)
+    {
+        threads.emplace_back([&cache, t]
+        {
+            for (uint64_t i{0}; i < 10'000; ++i)
+            {
+                cache.put(makeKey(t * 10'000 + i), {static_cast<double>(i), i});
+                cache.get(makeKey(t * 10'000 + i / 2));
+            }
+        });
+    }
+    threads.clear();
+
+    EXPECT_LE(cache.size(), 64);
+    EXPECT_GT(cache.size(), 0);
+}
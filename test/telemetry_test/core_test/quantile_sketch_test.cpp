@@ -0,0 +1,90 @@
+#include "telemetry/core/quantile_sketch.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace ctask::telemetry::core;
+using namespace testing;
+
+static double exactQuantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(q * static_cast<double>(values.size() - 1))];
+}
+
+TEST(QuantileSketchTest, CreateSketch_InvalidAccuracy_ThrowsException)
+{
+    EXPECT_THROW(QuantileSketch{0.0}, std::invalid_argument);
+    EXPECT_THROW(QuantileSketch{1.0}, std::invalid_argument);
+    EXPECT_NO_THROW(QuantileSketch{0.05});
+}
+
+TEST(QuantileSketchTest, EmptySketch_ReturnsZero)
+{
+    QuantileSketch sketch;
+    EXPECT_EQ(sketch.count(), 0);
+    EXPECT_EQ(sketch.quantile(0.5), 0.0);
+    EXPECT_THROW(sketch.quantile(1.5), std::invalid_argument);
+}
+
+TEST(QuantileSketchTest, Quantiles_WithinRelativeAccuracy)
+{
+    std::mt19937 gen{42};
+    std::lognormal_distribution<double> distribution{4.0, 1.0};
+
+    QuantileSketch sketch;
+    std::vector<double> values;
+    for (int i{0}; i < 100'000; ++i)
+    {
+        values.emplace_back(distribution(gen));
+        sketch.add(values.back());
+    }
+
+    EXPECT_EQ(sketch.count(), values.size());
+    for (double q : {0.0, 0.25, 0.5, 0.9, 0.95, 0.99, 1.0})
+    {
+        const auto expected{exactQuantile(values, q)};
+        EXPECT_NEAR(sketch.quantile(q), expected, expected * QuantileSketch::DEFAULT_RELATIVE_ACCURACY) << q;
+    }
+}
+
+TEST(QuantileSketchTest, NegativeAndZeroValues)
+{
+    QuantileSketch sketch;
+    std::vector<double> values{-100, -10, -1, 0, 0, 1, 10, 100, 1000};
+    for (auto value : values)
+    {
+        sketch.add(value);
+    }
+
+    EXPECT_NEAR(sketch.quantile(0.0), -100, 1);
+    EXPECT_EQ(sketch.quantile(0.375), 0.0);
+    EXPECT_NEAR(sketch.quantile(1.0), 1000, 10);
+}
+
+TEST(QuantileSketchTest, Merge_SameAsSingleSketch)
+{
+    QuantileSketch whole;
+    QuantileSketch left;
+    QuantileSketch right;
+    for (int i{1}; i <= 1000; ++i)
+    {
+        whole.add(i);
+        (i % 2 == 0 ? left : right).add(i);
+    }
+
+    // right has values far away from left to force bins growth on merge
+    right.add(1'000'000);
+    whole.add(1'000'000);
+
+    left.merge(right);
+    EXPECT_EQ(left.count(), whole.count());
+    for (double q : {0.0, 0.1, 0.5, 0.99, 1.0})
+    {
+        EXPECT_EQ(left.quantile(q), whole.quantile(q));
+    }
+
+    EXPECT_THROW(left.merge(QuantileSketch{0.1}), std::invalid_argument);
+}
@@ -1,6 +1,10 @@
 #include "telemetry/core/telemetry_storage.h"
+#include "utils/concurrency/compute_pool.h"
 
 #include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <random>
 #include <thread>
 
 using namespace ctask::telemetry::core;
@@ -168,3 +172,406 @@ TEST(TelemetryStorageTest, Store_SeveralEvents_WithDifferentNames_InSeparateThre
     EXPECT_EQ(storage.getEventInteractions("first", 0, 1000).size(), 6);
     EXPECT_EQ(storage.getEventInteractions("second", 0, 1000).size(), 6);
 }
+
+TEST(TelemetryStorageTest, AsyncStoreEvent_FromCoroutines_SameAsSyncApi)
+{
+    TelemetryStorage storage;
+    asio::thread_pool pool{2};
+
+    for (const auto& model : GLOABL_EVENT_MODELS)
+    {
+        asio::co_spawn(pool, [&storage, model]() -> asio::awaitable<void>
+        {
+            co_await storage.asyncStoreEvent("async", model);
+        }, asio::detached);
+    }
+    pool.join();
+
+    asio::io_context ctx{};
+    std::vector<InteractionTimesEventModel> entries{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        co_await storage.asyncGetEventEntries("async", 0, 100, 2, entries);
+    }, asio::detached);
+    ctx.run();
+
+    EXPECT_EQ(storage.getEventInteractions("async", 15, 30).size(), 2);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries.front().date, 10);
+    EXPECT_EQ(storage.getEventSketch("async", 0, 100).count(), 3);
+}
+
+TEST(TelemetryStorageTest, GetEventEntries_WalkRangeByChunks)
+{
+    TelemetryStorage storage;
+    for (uint64_t date{1}; date <= 10; ++date)
+    {
+        storage.storeEvent("first", {date * 10, {static_cast<InteractionTimeType>(date)}});
+    }
+
+    std::vector<InteractionTimesEventModel> chunk;
+    std::vector<EventDateType> actualDates;
+    uint64_t from{20};
+    while (storage.getEventEntries("first", from, 85, 3, chunk) != 0)
+    {
+        EXPECT_LE(chunk.size(), 3);
+        for (const auto& event : chunk)
+        {
+            EXPECT_EQ(event.values[0], event.date / 10);
+            actualDates.emplace_back(event.date);
+        }
+        from = chunk.back().date + 1;
+    }
+
+    std::vector<EventDateType> expectedDates{20, 30, 40, 50, 60, 70, 80};
+    EXPECT_EQ(actualDates, expectedDates);
+    EXPECT_EQ(storage.getEventEntries("Nope, NotToday", 0, 100, 3, chunk), 0);
+    EXPECT_TRUE(chunk.empty());
+}
+
+TEST(TelemetryStorageTest, GetEventPathLengthTotal_ParallelWalk_MatchesRawEvents)
+{
+    TelemetryStorage storage;
+
+    // dense cluster at the start and sparse tail, sub-ranges of equal length get very different loads
+    const auto events{TelemetryStorage::PARALLEL_SCAN_MIN_EVENTS + 1000};
+    for (uint64_t i{0}; i < events; ++i)
+    {
+        const auto date{i < events / 2 ? i : events / 2 + (i - events / 2) * 1000};
+        storage.storeEvent("huge", {date, {static_cast<InteractionTimeType>(i % 7), 1, 2}});
+    }
+    storage.storeEvent("small", {1, {1, 2, 3}});
+
+    ctask::utils::concurrency::ComputePool pool{4};
+    const std::vector<std::pair<uint64_t, uint64_t>> ranges{
+        {0, std::numeric_limits<uint64_t>::max()}, {0, 0}, {100, events / 2 + 5000}, {events, events * 10},
+        {events * 2000, events * 3000},
+    };
+    for (const auto& [from, to] : ranges)
+    {
+        const auto raw{storage.getEventInteractions("huge", from, to)};
+        int64_t expectedTotal{0};
+        for (const auto& interaction : raw)
+        {
+            expectedTotal += calculatePathLength(interaction);
+        }
+
+        const auto serial{storage.getEventPathLengthTotal("huge", from, to)};
+        const auto parallel{storage.getEventPathLengthTotal("huge", from, to, &pool)};
+        EXPECT_EQ(serial.count, raw.size());
+        EXPECT_EQ(serial.totalPathLength, expectedTotal);
+        EXPECT_EQ(parallel.count, serial.count);
+        EXPECT_EQ(parallel.totalPathLength, serial.totalPathLength);
+        EXPECT_DOUBLE_EQ(parallel.mean(TimeUnit::Milliseconds), calculateMeanPathLength(raw, TimeUnit::Milliseconds));
+    }
+
+    EXPECT_EQ(storage.getEventPathLengthTotal("huge", 20, 10, &pool).count, 0);
+    EXPECT_EQ(storage.getEventPathLengthTotal("small", 0, 10, &pool).totalPathLength, 6);
+    EXPECT_EQ(storage.getEventPathLengthTotal("Nope, NotToday", 0, 10, &pool).count, 0);
+}
+
+TEST(TelemetryStorageTest, GetEventSketch_MatchesRawEventsForAnyRange)
+{
+    TelemetryStorage storage;
+    EXPECT_EQ(storage.getEventSketch("Nope, NotToday", 0, 1000).count(), 0);
+
+    // three days of events, every 7 minutes, path length grows with time
+    constexpr EventDateType day{24 * 3600};
+    std::vector<InteractionTimesEventModel> events;
+    for (EventDateType date{day}; date < 4 * day; date += 7 * 60)
+    {
+        InteractionTimesEventModel model{date};
+        model.values.fill(static_cast<InteractionTimeType>(date / 60));
+        events.emplace_back(model);
+        storage.storeEvent("first", model);
+    }
+
+    struct Range
+    {
+        uint64_t from;
+        uint64_t to;
+    };
+
+    std::vector<Range> ranges{
+        {0, std::numeric_limits<uint64_t>::max()}, // whole storage
+        {day, 2 * day - 1}, // exactly a single day
+        {day + 3600, day + 2 * 3600 - 1}, // exactly a single hour
+        {day + 100, day + 200}, // less than an hour
+        {day + 1234, 3 * day + 4321}, // unaligned edges, hours and days in the middle
+        {day + 1234, day + 5 * 3600 + 1}, // unaligned edges, only hours in the middle
+    };
+
+    for (const auto& [from, to] : ranges)
+    {
+        QuantileSketch expected;
+        for (const auto& event : events)
+        {
+            if (event.date >= from && event.date <= to)
+            {
+                expected.add(static_cast<double>(calculatePathLength(event.values)));
+            }
+        }
+
+        auto actual{storage.getEventSketch("first", from, to)};
+        ASSERT_EQ(actual.count(), expected.count()) << from << " - " << to;
+        for (double q : {0.0, 0.5, 0.95, 0.99, 1.0})
+        {
+            EXPECT_EQ(actual.quantile(q), expected.quantile(q)) << from << " - " << to << " : " << q;
+        }
+    }
+}
+
+TEST(TelemetryStorageTest, GetEventSeries_MatchesRawEventsForAnyRangeAndInterval)
+{
+    TelemetryStorage storage;
+    EXPECT_TRUE(storage.getEventSeries("Nope, NotToday", 0, 1000, 60).empty());
+    EXPECT_THROW(storage.getEventSeries("Nope, NotToday", 0, 1000, 0), std::invalid_argument);
+
+    // three days of events, every 7 minutes, path length grows with time
+    constexpr EventDateType day{24 * 3600};
+    std::vector<InteractionTimesEventModel> events;
+    for (EventDateType date{day}; date < 4 * day; date += 7 * 60)
+    {
+        InteractionTimesEventModel model{date};
+        model.values.fill(static_cast<InteractionTimeType>(date / 60));
+        events.emplace_back(model);
+        storage.storeEvent("first", model);
+    }
+
+    struct Range
+    {
+        uint64_t from;
+        uint64_t to;
+    };
+
+    std::vector<Range> ranges{
+        {0, std::numeric_limits<uint64_t>::max()}, // whole storage
+        {day, 2 * day - 1}, // exactly a single day
+        {day + 100, day + 200}, // less than an hour
+        {day + 1234, 3 * day + 4321}, // unaligned edges, hours and days in the middle
+        {day + 1234, day + 5 * 3600 + 1}, // unaligned edges, only hours in the middle
+    };
+
+    // raw scan, hour rollups, day rollups and mixed intervals
+    std::vector<uint64_t> intervals{1, 600, 3600, 3 * 3600, day, 2 * day};
+
+    for (const auto& [from, to] : ranges)
+    {
+        for (auto interval : intervals)
+        {
+            std::vector<PathLengthSeriesBucket> expected;
+            for (const auto& event : events)
+            {
+                if (event.date < from || event.date > to)
+                {
+                    continue;
+                }
+
+                const auto bucketStart{event.date - event.date % interval};
+                if (expected.empty() || expected.back().bucketStart != bucketStart)
+                {
+                    expected.push_back({bucketStart, 0, 0});
+                }
+                expected.back().totalPathLength += calculatePathLength(event.values);
+                ++expected.back().count;
+            }
+
+            auto actual{storage.getEventSeries("first", from, to, interval)};
+            ASSERT_EQ(actual.size(), expected.size()) << from << " - " << to << " : " << interval;
+            for (size_t i{0}; i < expected.size(); ++i)
+            {
+                EXPECT_EQ(actual[i].bucketStart, expected[i].bucketStart) << from << " - " << to << " : " << interval;
+                EXPECT_EQ(actual[i].totalPathLength, expected[i].totalPathLength) << from << " - " << to << " : " << interval;
+                EXPECT_EQ(actual[i].count, expected[i].count) << from << " - " << to << " : " << interval;
+            }
+        }
+    }
+}
+
+TEST(TelemetryStorageTest, IsRangeModifiedSince_OnlyWritesWithinRangeCount)
+{
+    TelemetryStorage storage;
+    EXPECT_EQ(storage.getEventVersion("first"), 0);
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", 0, 0, 1000));
+
+    storage.storeEvent("first", {100, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+    EXPECT_EQ(storage.getEventVersion("first"), 1);
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", 0, 0, 1000));
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", 0, 101, 1000));
+
+    // an event sharing the timestamp is stored as well
+    storage.storeEvent("first", {100, {2, 2, 2, 2, 2, 2, 2, 2, 2, 2}});
+    EXPECT_EQ(storage.getEventVersion("first"), 2);
+
+    // fresh events don't touch historical range
+    const auto version{storage.getEventVersion("first")};
+    for (EventDateType date{1000}; date < 1100; ++date)
+    {
+        storage.storeEvent("first", {date, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+    }
+    EXPECT_EQ(storage.getEventVersion("first"), version + 100);
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", version, 0, 999));
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, 0, 1000));
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, 1050, 1050));
+
+    // too many writes to remember, answer is conservative
+    for (EventDateType date{2000}; date < 3000; ++date)
+    {
+        storage.storeEvent("first", {date, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+    }
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, 0, 999));
+
+    // unknown future version
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", storage.getEventVersion("first") + 1, 0, 999));
+}
+
+TEST(TelemetryStorageTest, IsRangeModifiedSince_ManyRecentWrites_HistoricalRangeStaysFresh)
+{
+    constexpr EventDateType HOUR{3600};
+    constexpr EventDateType DAY{24 * HOUR};
+    constexpr EventDateType TODAY{10 * DAY};
+
+    TelemetryStorage storage;
+    storage.storeEvent("first", {100, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+    storage.storeEvent("first", {DAY + 100, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+
+    // far more writes than the recent writes ring remembers, all of them into the first hour of today
+    const auto version{storage.getEventVersion("first")};
+    for (EventDateType date{TODAY}; date < TODAY + 1000; ++date)
+    {
+        storage.storeEvent("first", {date, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}});
+    }
+
+    // cached results of historical ranges are still valid
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", version, 0, 2 * DAY));
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", version, 0, TODAY - 1));
+    EXPECT_FALSE(storage.isRangeModifiedSince("first", version, TODAY + HOUR, TODAY + 2 * HOUR));
+
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, 0, std::numeric_limits<uint64_t>::max()));
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, TODAY + 500, TODAY + 500));
+
+    // a written hour is modified as a whole
+    EXPECT_TRUE(storage.isRangeModifiedSince("first", version, TODAY + 2000, TODAY + 3000));
+}
+
+TEST(TelemetryStorageTest, FindEventId_DenseIdsInOrderOfAppearance)
+{
+    TelemetryStorage storage;
+    EXPECT_FALSE(storage.findEventId("first").has_value());
+
+    storage.storeEvent("first", GLOABL_EVENT_MODELS[0]);
+    storage.storeEvent(std::string_view{"second, but with a name too long for the small string buffer"},
+                       GLOABL_EVENT_MODELS[0]);
+    storage.storeEvent("first", GLOABL_EVENT_MODELS[1]);
+
+    EXPECT_EQ(storage.findEventId("first"), 0);
+    EXPECT_EQ(storage.findEventId("second, but with a name too long for the small string buffer"), 1);
+    EXPECT_FALSE(storage.findEventId("third").has_value());
+    EXPECT_EQ(storage.getEventInteractions("first", 0, 100).size(), 2);
+}
+
+TEST(TelemetryStorageTest, Store_OutOfOrderSharedTimestamps_ReadsAllInOrderBeforeAndAfterMerge)
+{
+    TelemetryStorage storage;
+    std::mt19937_64 random{7};
+    std::uniform_int_distribution<EventDateType> dates{0, 2'000};
+
+    // several write buffers get sealed, events of a timestamp land in the buffer and in sealed runs
+    std::multimap<EventDateType, InteractionTimesCollection> reference{};
+    for (int i{0}; i < 3 * static_cast<int>(EventLsmTree::DEFAULT_BUFFER_CAPACITY); ++i)
+    {
+        const InteractionTimesEventModel event{dates(random), {static_cast<InteractionTimeType>(i % 100), 1}};
+        reference.emplace(event.date, event.values);
+        storage.storeEvent("shuffled", event);
+    }
+
+    auto check = [&storage, &reference]()
+    {
+        std::vector<InteractionTimesCollection> expected{};
+        for (auto it{reference.lower_bound(500)}; it != reference.end() && it->first <= 1'500; ++it)
+        {
+            expected.push_back(it->second);
+        }
+        EXPECT_EQ(storage.getEventInteractions("shuffled", 500, 1'500), expected);
+
+        std::vector<InteractionTimesEventModel> entries{};
+        ASSERT_GE(storage.getEventEntries("shuffled", 0, 2'000, 10, entries), 10);
+        auto it{reference.begin()};
+        for (const auto& entry : entries)
+        {
+            EXPECT_EQ(entry.date, it->first);
+            EXPECT_EQ(entry.values, it->second);
+            ++it;
+        }
+        EXPECT_EQ(storage.getEventPathLengthTotal("shuffled", 0, 2'000).count, reference.size());
+    };
+    check();
+    storage.mergeRuns();
+    check();
+}
+
+TEST(TelemetryStorageTest, GetEventEntries_SharedTimestamp_NotSplitBetweenChunks)
+{
+    TelemetryStorage storage;
+    storage.storeEvent("first", {10, {1}});
+    for (InteractionTimeType i{0}; i < 4; ++i)
+    {
+        storage.storeEvent("first", {20, {i}});
+    }
+    storage.storeEvent("first", {30, {1}});
+
+    std::vector<InteractionTimesEventModel> chunk{};
+    ASSERT_EQ(storage.getEventEntries("first", 0, 100, 2, chunk), 5);
+    EXPECT_EQ(chunk.back().date, 20);
+    for (InteractionTimeType i{0}; i < 4; ++i)
+    {
+        EXPECT_EQ(chunk[i + 1].values[0], i);
+    }
+
+    ASSERT_EQ(storage.getEventEntries("first", 21, 100, 2, chunk), 1);
+    EXPECT_EQ(chunk[0].date, 30);
+    EXPECT_EQ(storage.getEventPathLengthTotal("first", 20, 20).count, 4);
+}
+
+TEST(TelemetryStorageTest, EveryFamily_StoreAndQuery_MatchesRawEvents)
+{
+    for (const auto len : INTERACTION_TIMES_FAMILIES)
+    {
+        withInteractionTimesFamily(len, [](auto family)
+        {
+            constexpr auto N{decltype(family)::value};
+            BasicTelemetryStorage<N> storage;
+
+            std::mt19937 gen(static_cast<uint32_t>(N));
+            std::uniform_int_distribution<InteractionTimeType> dist(-1000, 1000);
+            std::vector<InteractionTimes<N>> raw{};
+            for (uint64_t date{1}; date <= 5000; ++date)
+            {
+                BasicInteractionTimesEventModel<N> event{date, {}};
+                for (auto& value : event.values)
+                {
+                    value = dist(gen);
+                }
+                storage.storeEvent("family", event);
+                raw.push_back(event.values);
+
+                // the unrolled kernel and the one of any length agree
+                ASSERT_EQ(calculatePathLength(event.values),
+                          calculatePathLength(std::span<const InteractionTimeType>{event.values}));
+            }
+            storage.mergeRuns();
+
+            EXPECT_EQ(storage.getEventInteractions("family", 0, 5000), raw);
+            const auto total{storage.getEventPathLengthTotal("family", 0, 5000)};
+            EXPECT_EQ(total.count, raw.size());
+            EXPECT_DOUBLE_EQ(total.mean(TimeUnit::Milliseconds), calculateMeanPathLength(raw, TimeUnit::Milliseconds));
+        });
+    }
+}
+
+TEST(TelemetryStorageTest, WithInteractionTimesFamily_UnknownLength_ThrowsException)
+{
+    EXPECT_EQ(withInteractionTimesFamily(INTERACTION_TIMES_LEN, [](auto family) { return decltype(family)::value; }),
+              INTERACTION_TIMES_LEN);
+    EXPECT_THROW(withInteractionTimesFamily(7, [](auto) {}), std::invalid_argument);
+}
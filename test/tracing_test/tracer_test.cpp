@@ -0,0 +1,101 @@
+#include "tracing/tracer.h"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+
+using namespace ctask::tracing;
+using namespace testing;
+
+TEST(TracerTest, Configure_ZeroCapacity_ThrowsException)
+{
+    EXPECT_THROW(Tracer::instance().configure(1, 0), std::invalid_argument);
+}
+
+TEST(TracerTest, Sample_EveryNthRequestGetsId)
+{
+    auto& tracer{Tracer::instance()};
+    tracer.configure(3, 16);
+
+    // counter is per thread and may be in the middle of a period, sync it first
+    while (tracer.sample() == 0)
+    {
+    }
+
+    std::vector<uint64_t> ids;
+    for (int i{0}; i < 9; ++i)
+    {
+        ids.push_back(tracer.sample());
+    }
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), 0), 6);
+    EXPECT_NE(ids[2], 0);
+    EXPECT_NE(ids[5], 0);
+    EXPECT_NE(ids[8], 0);
+
+    tracer.configure(0, 16);
+    for (int i{0}; i < 10; ++i)
+    {
+        EXPECT_EQ(tracer.sample(), 0);
+    }
+}
+
+TEST(TracerTest, RequestTrace_RecordsStagesAndNestedSpans)
+{
+    auto& tracer{Tracer::instance()};
+    tracer.configure(1, 16);
+    {
+        RequestTrace trace{};
+        ASSERT_NE(trace.requestId(), 0);
+        {
+            ActiveRequestScope activeRequest{trace.requestId()};
+            ScopedSpan span{"nested"};
+        }
+        trace.mark("first");
+        trace.mark("second");
+        trace.finish();
+
+        // nobody is active anymore, nothing is recorded
+        ScopedSpan span{"orphan"};
+    }
+
+    auto spans{tracer.spans()};
+    ASSERT_EQ(spans.size(), 4);
+    EXPECT_STREQ(spans[0].name, "nested");
+    EXPECT_STREQ(spans[1].name, "first");
+    EXPECT_STREQ(spans[2].name, "second");
+    EXPECT_STREQ(spans[3].name, "request");
+    EXPECT_EQ(spans[1].start + spans[1].duration, spans[2].start);
+    EXPECT_LE(spans[1].start, spans[0].start);
+    for (const auto& span : spans)
+    {
+        EXPECT_EQ(span.requestId, spans[0].requestId);
+    }
+}
+
+TEST(TracerTest, RingBuffer_KeepsLatestSpans_DumpsChromeTrace)
+{
+    auto& tracer{Tracer::instance()};
+    tracer.configure(1, 4);
+    for (uint64_t id{1}; id <= 6; ++id)
+    {
+        tracer.record({
+            "stage", id, TraceClock::time_point{std::chrono::microseconds(id)}, std::chrono::nanoseconds(1500)
+        });
+    }
+
+    auto spans{tracer.spans()};
+    ASSERT_EQ(spans.size(), 4);
+    EXPECT_EQ(spans.front().requestId, 3);
+    EXPECT_EQ(spans.back().requestId, 6);
+
+    // no braces here, nlohmann would wrap the parsed value into an array
+    const auto trace = nlohmann::json::parse(tracer.dumpChromeTrace());
+    ASSERT_EQ(trace["traceEvents"].size(), 4);
+    const auto& event{trace["traceEvents"][0]};
+    EXPECT_EQ(event["name"], "stage");
+    EXPECT_EQ(event["ph"], "X");
+    EXPECT_EQ(event["tid"], 3);
+    EXPECT_DOUBLE_EQ(event["ts"].get<double>(), 3.0);
+    EXPECT_DOUBLE_EQ(event["dur"].get<double>(), 1.5);
+}
@@ -0,0 +1,146 @@
+#include "utils/concurrency/async_shared_mutex.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ctask::utils::concurrency;
+using namespace testing;
+
+TEST(AsyncSharedMutexTest, AsyncLockShared_SeveralReaders_AllAdmitted)
+{
+    asio::io_context ctx{};
+    AsyncSharedMutex mutex{};
+    std::vector<std::shared_lock<AsyncSharedMutex>> locks{};
+
+    for (int i{0}; i < 3; ++i)
+    {
+        asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+        {
+            locks.push_back(co_await mutex.asyncLockShared());
+        }, asio::detached);
+    }
+    ctx.run();
+
+    EXPECT_EQ(locks.size(), 3);
+    EXPECT_FALSE(mutex.try_lock());
+}
+
+TEST(AsyncSharedMutexTest, AsyncLock_HeldByReader_SuspendedWithoutBlockingThread)
+{
+    asio::io_context ctx{};
+    AsyncSharedMutex mutex{};
+    std::shared_lock readLock{mutex};
+
+    bool written{false};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        auto lock{co_await mutex.asyncLock()};
+        written = true;
+    }, asio::detached);
+
+    // the writer is parked, the only thread still serves other work
+    bool otherWorkDone{false};
+    asio::post(ctx, [&]() { otherWorkDone = true; });
+    ctx.poll();
+    EXPECT_TRUE(otherWorkDone);
+    EXPECT_FALSE(written);
+
+    readLock.unlock();
+    ctx.restart();
+    ctx.poll();
+    EXPECT_TRUE(written);
+    EXPECT_TRUE(mutex.try_lock_shared());
+    mutex.unlock_shared();
+}
+
+TEST(AsyncSharedMutexTest, AsyncLockShared_WriterQueued_ReaderWaitsForWriter)
+{
+    asio::io_context ctx{};
+    AsyncSharedMutex mutex{};
+    std::shared_lock firstReader{mutex};
+    std::vector<std::string> order{};
+
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        auto lock{co_await mutex.asyncLock()};
+        order.emplace_back("writer");
+    }, asio::detached);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        auto lock{co_await mutex.asyncLockShared()};
+        order.emplace_back("reader");
+    }, asio::detached);
+
+    // the lock is shared, still the late reader queues up behind the writer
+    ctx.poll();
+    EXPECT_TRUE(order.empty());
+    EXPECT_FALSE(mutex.try_lock_shared());
+
+    firstReader.unlock();
+    ctx.restart();
+    ctx.run();
+    EXPECT_EQ(order, (std::vector<std::string>{"writer", "reader"}));
+}
+
+TEST(AsyncSharedMutexTest, Lock_CoroutinesAndThreadsMixed_ExclusiveAccess)
+{
+    asio::thread_pool pool{4};
+    AsyncSharedMutex mutex{};
+    int counter{0};
+
+    constexpr int ITERATIONS{2000};
+    for (int c{0}; c < 4; ++c)
+    {
+        asio::co_spawn(pool, [&]() -> asio::awaitable<void>
+        {
+            for (int i{0}; i < ITERATIONS; ++i)
+            {
+                auto lock{co_await mutex.asyncLock()};
+                ++counter;
+            }
+        }, asio::detached);
+    }
+
+    {
+        std::vector<std::jthread> threads{};
+        for (int t{0}; t < 2; ++t)
+        {
+            threads.emplace_back([&]()
+            {
+                for (int i{0}; i < ITERATIONS; ++i)
+                {
+                    std::unique_lock lock{mutex};
+                    ++counter;
+                }
+            });
+        }
+    }
+    pool.join();
+
+    std::shared_lock lock{mutex};
+    EXPECT_EQ(counter, 6 * ITERATIONS);
+}
+
+TEST(AsyncSharedMutexTest, Lock_ContendedWithinNonBlockingThreadScope_Throws)
+{
+    AsyncSharedMutex mutex{};
+    AsyncSharedMutex::NonBlockingThreadScope nonBlocking{};
+
+    // nothing to wait for, fine on any thread
+    {
+        std::unique_lock lock{mutex};
+    }
+
+    std::shared_lock readLock{mutex};
+    EXPECT_THROW(mutex.lock(), std::logic_error);
+
+    // the failed attempt left nothing queued, readers are still admitted right away
+    EXPECT_TRUE(mutex.try_lock_shared());
+    mutex.unlock_shared();
+    readLock.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
@@ -0,0 +1,98 @@
+#include "utils/concurrency/compute_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <latch>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ctask::utils::concurrency;
+using namespace testing;
+
+TEST(ComputePoolTest, Run_ReturnsResult_ResumesOnCallerThread)
+{
+    ComputePool pool{2};
+    asio::io_context ctx{};
+
+    int result{0};
+    std::thread::id workerThread{};
+    std::thread::id resumedThread{};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        result = co_await pool.run([&]()
+        {
+            workerThread = std::this_thread::get_id();
+            return 42;
+        });
+        resumedThread = std::this_thread::get_id();
+    }, asio::detached);
+    ctx.run();
+
+    EXPECT_EQ(result, 42);
+    EXPECT_NE(workerThread, std::this_thread::get_id());
+    EXPECT_EQ(resumedThread, std::this_thread::get_id());
+}
+
+TEST(ComputePoolTest, Run_FnThrows_ExceptionRethrownInCoroutine)
+{
+    ComputePool pool{1};
+    asio::io_context ctx{};
+
+    bool caught{false};
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void>
+    {
+        try
+        {
+            co_await pool.run([]() { throw std::runtime_error("Exploded"); });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+    }, asio::detached);
+    ctx.run();
+
+    EXPECT_TRUE(caught);
+}
+
+TEST(ComputePoolTest, ParallelFor_InsideTask_EveryIndexVisitedOnce)
+{
+    ComputePool pool{4};
+    constexpr size_t COUNT{10'000};
+    std::vector<int> visits(COUNT, 0);
+
+    std::latch done{1};
+    pool.submit([&]()
+    {
+        pool.parallelFor(COUNT, [&](size_t i) { ++visits[i]; });
+        done.count_down();
+    });
+    done.wait();
+
+    EXPECT_EQ(std::accumulate(visits.begin(), visits.end(), 0), COUNT);
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+}
+
+TEST(ComputePoolTest, Submit_NestedTasksOnBusyWorker_StolenByIdleWorkers)
+{
+    ComputePool pool{2};
+    std::latch release{1};
+    std::latch done{4};
+
+    // the nested tasks land on the submitting worker's deque, which is busy until released
+    pool.submit([&]()
+    {
+        for (int i{0}; i < 4; ++i)
+        {
+            pool.submit([&]() { done.count_down(); });
+        }
+        done.wait();
+        release.count_down();
+    });
+    release.wait();
+
+    EXPECT_GE(pool.steals(), 1);
+}
@@ -0,0 +1,70 @@
+#include "utils/concurrency/parallel_for.h"
+
+#include <gtest/gtest.h>
+
+#include <latch>
+#include <thread>
+
+using namespace ctask::utils::concurrency;
+using namespace testing;
+
+TEST(ParallelForTest, EveryItemProcessedOnce)
+{
+    asio::thread_pool pool{4};
+    std::vector<std::atomic<int>> calls(1000);
+
+    parallelFor(pool.get_executor(), calls.size(), 4, [&](size_t i) { ++calls[i]; });
+
+    for (const auto& call : calls)
+    {
+        EXPECT_EQ(call.load(), 1);
+    }
+    pool.join();
+}
+
+TEST(ParallelForTest, ZeroItems_NothingCalled)
+{
+    asio::thread_pool pool{1};
+    bool called{false};
+    parallelFor(pool.get_executor(), 0, 4, [&](size_t) { called = true; });
+    EXPECT_FALSE(called);
+    pool.join();
+}
+
+TEST(ParallelForTest, AllExecutorThreadsBusy_CallerDoesTheWork)
+{
+    asio::thread_pool pool{1};
+    std::latch release{1};
+
+    // occupy the only pool thread until the parallel loop is done
+    asio::post(pool, [&]() { release.wait(); });
+
+    std::vector<std::thread::id> workers(100);
+    parallelFor(pool.get_executor(), workers.size(), 4, [&](size_t i) { workers[i] = std::this_thread::get_id(); });
+
+    for (const auto& worker : workers)
+    {
+        EXPECT_EQ(worker, std::this_thread::get_id());
+    }
+
+    release.count_down();
+    pool.join();
+}
+
+TEST(ParallelForTest, ItemThrows_ExceptionRethrown_OtherItemsProcessed)
+{
+    asio::thread_pool pool{2};
+    std::atomic<int> processed{0};
+
+    EXPECT_THROW(parallelFor(pool.get_executor(), 100, 2, [&](size_t i)
+                 {
+                     if (i == 42)
+                     {
+                         throw std::runtime_error("Oops");
+                     }
+                     ++processed;
+                 }),
+                 std::runtime_error);
+    EXPECT_EQ(processed.load(), 99);
+    pool.join();
+}
@@ -0,0 +1,69 @@
+#include "utils/concurrency/spsc_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace ctask::utils::concurrency;
+using namespace testing;
+
+TEST(SpscRingTest, TryPush_FullRing_ItemLeftUntouched)
+{
+    SpscRing<std::string> ring{3};
+    EXPECT_EQ(ring.capacity(), 4);
+
+    for (int i{0}; i < 4; ++i)
+    {
+        std::string item{std::to_string(i)};
+        EXPECT_TRUE(ring.tryPush(item));
+    }
+
+    std::string rejected{"rejected"};
+    EXPECT_FALSE(ring.tryPush(rejected));
+    EXPECT_EQ(rejected, "rejected");
+
+    std::string popped{};
+    ASSERT_TRUE(ring.tryPop(popped));
+    EXPECT_EQ(popped, "0");
+    EXPECT_TRUE(ring.tryPush(rejected));
+}
+
+TEST(SpscRingTest, PushPop_ConcurrentProducerAndConsumer_OrderKept)
+{
+    SpscRing<uint64_t> ring{64};
+    constexpr uint64_t ITEMS{200'000};
+
+    std::jthread producer{[&ring]()
+    {
+        for (uint64_t i{0}; i < ITEMS; ++i)
+        {
+            auto item{i};
+            while (!ring.tryPush(item))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    uint64_t expected{0};
+    uint64_t item{0};
+    while (expected < ITEMS)
+    {
+        if (ring.tryPop(item))
+        {
+            ASSERT_EQ(item, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_FALSE(ring.tryPop(item));
+}
+
+TEST(SpscRingTest, CreateRing_ZeroCapacity_ThrowsException)
+{
+    EXPECT_THROW(SpscRing<int>{0}, std::invalid_argument);
+}
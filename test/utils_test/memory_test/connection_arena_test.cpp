@@ -0,0 +1,65 @@
+#include "utils/memory/connection_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace ctask::utils::memory;
+using namespace testing;
+
+/**
+ * @class CountingResource
+ * @brief Upstream which counts allocations passed to it.
+ */
+class CountingResource final : public std::pmr::memory_resource
+{
+public:
+    size_t allocations{0};
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(ConnectionArenaTest, Reset_NextAllocationReusesBuffer)
+{
+    CountingResource upstream{};
+    ConnectionArena<1024> arena{&upstream};
+
+    const auto* first{arena.resource()->allocate(100)};
+    arena.reset();
+    const auto* second{arena.resource()->allocate(100)};
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(upstream.allocations, 0);
+}
+
+TEST(ConnectionArenaTest, BufferExhausted_FallsBackToUpstream)
+{
+    CountingResource upstream{};
+    ConnectionArena<256> arena{&upstream};
+
+    {
+        std::pmr::string big(1024, 'x', arena.resource());
+        EXPECT_EQ(big.size(), 1024);
+    }
+    EXPECT_GT(upstream.allocations, 0);
+
+    arena.reset();
+    upstream.allocations = 0;
+    std::pmr::string small(100, 'x', arena.resource());
+    EXPECT_EQ(upstream.allocations, 0);
+}